@@ -0,0 +1,274 @@
+/*
+** File Name: aligned_allocator.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** An allocator that aligns each allocation to `Align` bytes (a cache line by
+** default), so that the first packet of an array can be loaded using an
+** aligned load. This is the default allocator used by `make_darray`.
+**
+** The remaining parameters are options that are read by `dense_storage`:
+** - `PadRows`: the length of the innermost dimension in memory (the leading
+**   dimension) is rounded up to a multiple of `Align` bytes, so that each row
+**   starts on an aligned boundary. Only applies to arrays whose element size
+**   divides `Align`.
+** - `HugePages`: allocations of at least 2 MiB are rounded up to a multiple of
+**   the huge page size, and the kernel is advised to back them using
+**   transparent huge pages. This is only a hint, and is ignored on platforms
+**   other than Linux.
+**
+** 	using alloc = nd::aligned_allocator<float, 64, true>;
+** 	auto arr = nd::make_darray<float>(nd::extents(n, n), alloc{});
+*/
+
+#ifndef Z00DF1617_1DC7_4AAC_82B1_65C42DF17F1D
+#define Z00DF1617_1DC7_4AAC_82B1_65C42DF17F1D
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ndmath/common.hpp>
+
+#if defined(__linux__)
+	#include <sys/mman.h>
+#endif
+
+namespace nd {
+
+static constexpr auto cache_line_size = size_t{64};
+static constexpr auto huge_page_size  = size_t{1} << 21;
+
+template <
+	class T,
+	size_t Align   = cache_line_size,
+	bool PadRows   = false,
+	bool HugePages = false
+>
+class aligned_allocator
+{
+	static_assert(
+		Align != 0 && (Align & (Align - 1)) == 0,
+		"Alignment must be a power of two."
+	);
+	static_assert(
+		Align >= alignof(void*),
+		"Alignment must be at least that of a pointer."
+	);
+public:
+	using value_type      = T;
+	using pointer         = T*;
+	using const_pointer   = const T*;
+	using size_type       = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using is_always_equal = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+
+	static constexpr auto alignment       = Align;
+	static constexpr auto pads_rows       = PadRows;
+	static constexpr auto uses_huge_pages = HugePages;
+
+	template <class U>
+	struct rebind
+	{ using other = aligned_allocator<U, Align, PadRows, HugePages>; };
+
+	CC_ALWAYS_INLINE constexpr
+	aligned_allocator() noexcept {}
+
+	template <class U>
+	CC_ALWAYS_INLINE constexpr
+	aligned_allocator(const aligned_allocator<U, Align, PadRows, HugePages>&)
+	noexcept {}
+
+	auto allocate(const size_type n, const void* = nullptr)
+	{
+		if (n > max_size()) {
+			throw std::bad_alloc{};
+		}
+
+		auto bytes = n * sizeof(T);
+		auto align = Align;
+		const auto huge = HugePages && bytes >= huge_page_size;
+
+		if (huge) {
+			align = std::max(Align, huge_page_size);
+			bytes = (bytes + huge_page_size - 1) / huge_page_size *
+				huge_page_size;
+		}
+
+		auto p = static_cast<void*>(nullptr);
+		if (::posix_memalign(&p, align, bytes) != 0) {
+			throw std::bad_alloc{};
+		}
+
+		#if defined(__linux__) && defined(MADV_HUGEPAGE)
+			if (huge) {
+				::madvise(p, bytes, MADV_HUGEPAGE);
+			}
+		#endif
+		return static_cast<T*>(p);
+	}
+
+	CC_ALWAYS_INLINE
+	void deallocate(T* p, size_type) noexcept
+	{ std::free(p); }
+
+	/*
+	** Used by `dense_storage` to grow arrays of trivially copyable
+	** elements. `realloc` may extend the block in place, or remap the pages
+	** of a large block instead of copying them. Its result is only kept if
+	** it is still aligned; otherwise, the elements are copied to a new
+	** block. Blocks backed by huge pages are always copied, so that the new
+	** block is also rounded up and advised.
+	**
+	** Once `realloc` succeeds, the original block no longer exists, so it
+	** cannot be handed back if the aligned copy fails. To keep a single
+	** contract for every failure, the block is always released before an
+	** exception is thrown, and the caller must give up its pointer first.
+	*/
+	auto reallocate(T* p, const size_type n, const size_type new_n)
+	{
+		if (new_n > max_size()) {
+			deallocate(p, n);
+			throw std::bad_alloc{};
+		}
+
+		if (!HugePages) {
+			const auto q = std::realloc(p, new_n * sizeof(T));
+			if (q == nullptr) {
+				deallocate(p, n);
+				throw std::bad_alloc{};
+			}
+			if (reinterpret_cast<std::uintptr_t>(q) % Align == 0) {
+				return static_cast<T*>(q);
+			}
+			p = static_cast<T*>(q);
+		}
+
+		auto r = static_cast<T*>(nullptr);
+		try {
+			r = allocate(new_n);
+		}
+		catch (...) {
+			deallocate(p, n);
+			throw;
+		}
+
+		std::memcpy(r, p, std::min(n, new_n) * sizeof(T));
+		deallocate(p, n);
+		return r;
+	}
+
+	template <class U, class... Args>
+	CC_ALWAYS_INLINE
+	void construct(U* p, Args&&... args)
+	noexcept(std::is_nothrow_constructible<U, Args&&...>::value)
+	{ ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+	template <class U>
+	CC_ALWAYS_INLINE
+	void destroy(U* p) noexcept
+	{ p->~U(); }
+
+	CC_ALWAYS_INLINE constexpr
+	auto max_size() const noexcept
+	{ return std::numeric_limits<size_type>::max() / sizeof(T); }
+};
+
+template <
+	class T, class U,
+	size_t Align, bool PadRows, bool HugePages
+>
+CC_ALWAYS_INLINE constexpr
+bool operator==(
+	const aligned_allocator<T, Align, PadRows, HugePages>&,
+	const aligned_allocator<U, Align, PadRows, HugePages>&
+) noexcept { return true; }
+
+template <
+	class T, class U,
+	size_t Align, bool PadRows, bool HugePages
+>
+CC_ALWAYS_INLINE constexpr
+bool operator!=(
+	const aligned_allocator<T, Align, PadRows, HugePages>&,
+	const aligned_allocator<U, Align, PadRows, HugePages>&
+) noexcept { return false; }
+
+namespace detail {
+
+CC_ALWAYS_INLINE constexpr
+auto next_power_of_two(const size_t n) noexcept
+{
+	auto r = size_t{1};
+	while (r < n) { r *= 2; }
+	return r;
+}
+
+/*
+** The alignment guaranteed by an allocator. Allocators that do not advertise
+** their alignment are only assumed to satisfy the alignment of the element
+** type.
+*/
+template <class Alloc>
+struct allocator_layout_traits
+{
+	using value_type = typename std::allocator_traits<Alloc>::value_type;
+
+	template <class U>
+	static constexpr auto check_alignment(U*) ->
+	decltype(U::alignment, size_t{})
+	{ return U::alignment; }
+
+	template <class U>
+	static constexpr auto check_alignment(...)
+	{ return alignof(value_type); }
+
+	template <class U>
+	static constexpr auto check_pads_rows(U*) ->
+	decltype(U::pads_rows, bool{})
+	{ return U::pads_rows; }
+
+	template <class U>
+	static constexpr auto check_pads_rows(...)
+	{ return false; }
+
+	static constexpr auto alignment = check_alignment<Alloc>(0);
+	static constexpr auto pads_rows = check_pads_rows<Alloc>(0);
+};
+
+template <class Alloc>
+struct can_reallocate
+{
+	using pointer   = typename std::allocator_traits<Alloc>::pointer;
+	using size_type = typename std::allocator_traits<Alloc>::size_type;
+
+	template <class U>
+	static constexpr auto check(U*) ->
+	decltype(std::declval<U&>().reallocate(
+		std::declval<pointer>(), size_type{}, size_type{}), bool{})
+	{ return true; }
+
+	template <class U>
+	static constexpr auto check(...)
+	{ return false; }
+
+	static constexpr auto value = check<Alloc>(0);
+};
+
+/*
+** Alignment of the data of a static array with `N` elements of type `T`. We
+** avoid aligning small arrays to an entire cache line, since this would inflate
+** their size.
+*/
+template <class T, size_t N>
+static constexpr auto static_alignment =
+std::max(alignof(T), std::min(cache_line_size, next_power_of_two(sizeof(T) * N)));
+
+}}
+
+#endif
@@ -0,0 +1,424 @@
+/*
+** File Name: arena_allocator.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** An allocator for short-lived temporaries, which obtains its memory from an
+** `arena` rather than calling `malloc` and `free` for each array. The arena
+** reserves memory from the system in large chunks, and allocates from them by
+** advancing a cursor. Deallocating the most recent allocation moves the cursor
+** back, so a temporary that is destroyed before the next one is created reuses
+** the same memory. Likewise, `destructive_resize` and `conservative_resize`
+** grow an array in place when it was the last allocation. Memory freed in any
+** other order is only reclaimed when the arena is rewound.
+**
+** Each thread has its own arena, which is used by default-constructed
+** allocators. An `arena_scope` records the position of the cursor when it is
+** created, and rewinds the arena to it when it is destroyed, so that all of the
+** temporaries allocated during its lifetime are freed at once:
+**
+** 	{
+** 		nd::arena_scope s;
+** 		using alloc = nd::arena_allocator<float>;
+** 		auto t = nd::make_darray<float>(nd::extents(n, n), alloc{});
+** 		...
+** 	}
+**
+** Arrays allocated within a scope must be destroyed before the scope ends.
+** The chunks are kept when the arena is rewound, so later scopes do not need to
+** reserve them again; they are returned to the system by `release` or when the
+** arena is destroyed. The size of each chunk is at least `nd_arena_chunk_size`
+** bytes.
+*/
+
+#ifndef Z47CD74E2_875F_499C_8F6E_FE503888B0E0
+#define Z47CD74E2_875F_499C_8F6E_FE503888B0E0
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ndmath/common.hpp>
+#include <ndmath/array/aligned_allocator.hpp>
+
+#ifndef nd_arena_chunk_size
+	#define nd_arena_chunk_size (size_t{1} << 20)
+#endif
+
+namespace nd {
+
+struct arena_stats
+{
+	// Bytes obtained from the system, including the chunk headers.
+	size_t reserved;
+	// Bytes between the start of the arena and its cursor.
+	size_t in_use;
+	// Largest value of `in_use` since the arena was created.
+	size_t high_water_mark;
+	size_t chunks;
+};
+
+class arena final
+{
+	/*
+	** The chunks form a list in the order in which they are used. When the
+	** arena is rewound, the chunks after the current one are kept, so that
+	** they can be used again.
+	*/
+	struct chunk
+	{
+		chunk* next;
+		char* end;
+	};
+
+	static constexpr auto header_size = cache_line_size;
+	static_assert(
+		sizeof(chunk) <= header_size,
+		"Chunk header must fit in a cache line."
+	);
+
+	chunk* m_first{nullptr};
+	chunk* m_cur_chunk{nullptr};
+	char* m_cur{nullptr};
+	char* m_end{nullptr};
+	size_t m_chunk_size;
+	size_t m_in_use{0};
+	size_t m_high_water{0};
+	size_t m_reserved{0};
+	size_t m_chunks{0};
+public:
+	struct marker
+	{
+		chunk* cur_chunk;
+		char* cur;
+		size_t in_use;
+	};
+
+	explicit arena(const size_t chunk_size = nd_arena_chunk_size)
+	noexcept : m_chunk_size{std::max(chunk_size, 2 * header_size)} {}
+
+	arena(const arena&) = delete;
+	arena& operator=(const arena&) = delete;
+
+	~arena() { release(); }
+
+	/*
+	** The arena of the calling thread.
+	*/
+	static arena& local()
+	{
+		static thread_local arena a;
+		return a;
+	}
+
+	void* allocate(const size_t bytes, const size_t align)
+	{
+		nd_assert(align != 0 && (align & (align - 1)) == 0,
+			"alignment must be a power of two");
+
+		auto p = align_up(m_cur, align);
+		if (m_cur == nullptr || !fits(p, m_end, bytes)) {
+			p = next_chunk(bytes, align);
+		}
+
+		m_in_use += size_t(p + bytes - m_cur);
+		m_high_water = std::max(m_high_water, m_in_use);
+		m_cur = p + bytes;
+		return p;
+	}
+
+	/*
+	** Only the most recent allocation is reclaimed; the memory of the
+	** others is reclaimed when the arena is rewound.
+	*/
+	void deallocate(void* p, const size_t bytes) noexcept
+	{
+		const auto q = static_cast<char*>(p);
+		if (q + bytes != m_cur) return;
+
+		m_in_use -= bytes;
+		m_cur = q;
+	}
+
+	/*
+	** Grows the most recent allocation in place if there is room in the
+	** current chunk; otherwise, the contents are copied to a new
+	** allocation.
+	*/
+	void* reallocate(
+		void* p,
+		const size_t bytes,
+		const size_t new_bytes,
+		const size_t align
+	)
+	{
+		const auto q = static_cast<char*>(p);
+		if (q + bytes == m_cur && new_bytes <= size_t(m_end - q)) {
+			m_in_use = m_in_use - bytes + new_bytes;
+			m_high_water = std::max(m_high_water, m_in_use);
+			m_cur = q + new_bytes;
+			return p;
+		}
+
+		const auto r = allocate(new_bytes, align);
+		std::memcpy(r, p, std::min(bytes, new_bytes));
+		return r;
+	}
+
+	CC_ALWAYS_INLINE
+	auto mark() const noexcept
+	{ return marker{m_cur_chunk, m_cur, m_in_use}; }
+
+	void rewind(const marker& m) noexcept
+	{
+		if (m.cur_chunk == nullptr) {
+			reset();
+			return;
+		}
+
+		m_cur_chunk = m.cur_chunk;
+		m_cur       = m.cur;
+		m_end       = m.cur_chunk->end;
+		m_in_use    = m.in_use;
+	}
+
+	/*
+	** Frees all allocations, but keeps the chunks.
+	*/
+	void reset() noexcept
+	{
+		m_cur_chunk = m_first;
+		m_cur       = m_first == nullptr ? nullptr : data(m_first);
+		m_end       = m_first == nullptr ? nullptr : m_first->end;
+		m_in_use    = 0;
+	}
+
+	/*
+	** Frees all allocations and returns the chunks to the system.
+	*/
+	void release() noexcept
+	{
+		while (m_first != nullptr) {
+			const auto next = m_first->next;
+			std::free(m_first);
+			m_first = next;
+		}
+
+		m_cur_chunk = nullptr;
+		m_cur       = nullptr;
+		m_end       = nullptr;
+		m_in_use    = 0;
+		m_reserved  = 0;
+		m_chunks    = 0;
+	}
+
+	CC_ALWAYS_INLINE
+	auto stats() const noexcept
+	{ return arena_stats{m_reserved, m_in_use, m_high_water, m_chunks}; }
+private:
+	CC_ALWAYS_INLINE
+	static char* align_up(char* p, const size_t align) noexcept
+	{
+		const auto n = reinterpret_cast<std::uintptr_t>(p);
+		return p + ((align - n % align) % align);
+	}
+
+	/*
+	** Aligning the cursor can move it past the end of the chunk, in which
+	** case `end - p` must not be computed as an unsigned value.
+	*/
+	CC_ALWAYS_INLINE
+	static bool fits(const char* p, const char* end, const size_t bytes)
+	noexcept
+	{ return p <= end && bytes <= size_t(end - p); }
+
+	CC_ALWAYS_INLINE
+	static char* data(chunk* c) noexcept
+	{ return reinterpret_cast<char*>(c) + header_size; }
+
+	/*
+	** Moves the cursor to the start of the next chunk that can hold the
+	** allocation, reserving a new chunk if the next one is too small. The
+	** unused space at the end of the current chunk counts as in use until
+	** the arena is rewound.
+	*/
+	char* next_chunk(const size_t bytes, const size_t align)
+	{
+		const auto next = m_cur_chunk == nullptr ? m_first :
+			m_cur_chunk->next;
+		auto c = next;
+
+		if (c == nullptr || !fits(align_up(data(c), align), c->end, bytes)) {
+			c = reserve(bytes, align);
+			c->next = next;
+
+			if (m_cur_chunk == nullptr) {
+				m_first = c;
+			}
+			else {
+				m_cur_chunk->next = c;
+			}
+		}
+
+		if (m_cur != nullptr) {
+			m_in_use += size_t(m_end - m_cur);
+		}
+
+		m_cur_chunk = c;
+		m_cur       = data(c);
+		m_end       = c->end;
+		return align_up(m_cur, align);
+	}
+
+	chunk* reserve(const size_t bytes, const size_t align)
+	{
+		const auto pad = std::max(align, size_t{header_size});
+		if (bytes > std::numeric_limits<size_t>::max() - 2 * pad) {
+			throw std::bad_alloc{};
+		}
+
+		const auto size = std::max(m_chunk_size, header_size + pad + bytes);
+		auto p = static_cast<void*>(nullptr);
+		if (::posix_memalign(&p, pad, size) != 0) {
+			throw std::bad_alloc{};
+		}
+
+		const auto c = static_cast<chunk*>(p);
+		c->end = static_cast<char*>(p) + size;
+		m_reserved += size;
+		++m_chunks;
+		return c;
+	}
+};
+
+/*
+** Rewinds the arena to its state at the time of construction.
+*/
+class arena_scope final
+{
+	arena& m_arena;
+	arena::marker m_marker;
+public:
+	explicit arena_scope(arena& a = arena::local()) noexcept :
+	m_arena{a}, m_marker{a.mark()} {}
+
+	arena_scope(const arena_scope&) = delete;
+	arena_scope& operator=(const arena_scope&) = delete;
+
+	~arena_scope()
+	{ m_arena.rewind(m_marker); }
+};
+
+template <class T, size_t Align = cache_line_size>
+class arena_allocator
+{
+	static_assert(
+		Align != 0 && (Align & (Align - 1)) == 0,
+		"Alignment must be a power of two."
+	);
+
+	template <class U, size_t Align_>
+	friend class arena_allocator;
+
+	arena* m_arena;
+public:
+	using value_type      = T;
+	using pointer         = T*;
+	using const_pointer   = const T*;
+	using size_type       = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using is_always_equal = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+
+	static constexpr auto alignment = std::max(Align, alignof(T));
+
+	template <class U>
+	struct rebind
+	{ using other = arena_allocator<U, Align>; };
+
+	/*
+	** Uses the arena of the calling thread.
+	*/
+	CC_ALWAYS_INLINE
+	arena_allocator() : m_arena{&arena::local()} {}
+
+	CC_ALWAYS_INLINE
+	explicit arena_allocator(arena& a) noexcept : m_arena{&a} {}
+
+	template <class U>
+	CC_ALWAYS_INLINE
+	arena_allocator(const arena_allocator<U, Align>& rhs) noexcept :
+	m_arena{rhs.m_arena} {}
+
+	CC_ALWAYS_INLINE
+	auto allocate(const size_type n, const void* = nullptr)
+	{
+		if (n > max_size()) {
+			throw std::bad_alloc{};
+		}
+		return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignment));
+	}
+
+	CC_ALWAYS_INLINE
+	void deallocate(T* p, const size_type n) noexcept
+	{ m_arena->deallocate(p, n * sizeof(T)); }
+
+	CC_ALWAYS_INLINE
+	auto reallocate(T* p, const size_type n, const size_type new_n)
+	{
+		if (new_n > max_size()) {
+			deallocate(p, n);
+			throw std::bad_alloc{};
+		}
+
+		try {
+			return static_cast<T*>(m_arena->reallocate(p,
+				n * sizeof(T), new_n * sizeof(T), alignment));
+		}
+		catch (...) {
+			deallocate(p, n);
+			throw;
+		}
+	}
+
+	template <class U, class... Args>
+	CC_ALWAYS_INLINE
+	void construct(U* p, Args&&... args)
+	noexcept(std::is_nothrow_constructible<U, Args&&...>::value)
+	{ ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+	template <class U>
+	CC_ALWAYS_INLINE
+	void destroy(U* p) noexcept
+	{ p->~U(); }
+
+	CC_ALWAYS_INLINE constexpr
+	auto max_size() const noexcept
+	{ return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+	CC_ALWAYS_INLINE
+	auto& source() const noexcept
+	{ return *m_arena; }
+};
+
+template <class T, class U, size_t Align>
+CC_ALWAYS_INLINE
+bool operator==(
+	const arena_allocator<T, Align>& lhs,
+	const arena_allocator<U, Align>& rhs
+) noexcept { return &lhs.source() == &rhs.source(); }
+
+template <class T, class U, size_t Align>
+CC_ALWAYS_INLINE
+bool operator!=(
+	const arena_allocator<T, Align>& lhs,
+	const arena_allocator<U, Align>& rhs
+) noexcept { return !(lhs == rhs); }
+
+}
+
+#endif
@@ -12,10 +12,21 @@
 #define Z9A5D0442_8832_4E17_ADF8_1BA2DC724D52
 
 #include <ndmath/array/array_memory_traits.hpp>
+#include <ndmath/array/boolean_storage.hpp>
+#include <ndmath/array/fused_view.hpp>
+#include <ndmath/array/permuted_copy.hpp>
+#include <ndmath/simd/packet_view.hpp>
 
 namespace nd {
+
+template <class T, class Extents, class StorageOrder, class Alloc>
+class dense_storage;
+
 namespace detail {
 
+template <class T>
+struct dense_storage_access;
+
 template <bool IsResizable>
 struct resize_helper;
 
@@ -50,8 +61,179 @@ struct resize_helper<false>
 	}
 };
 
+/*
+** Clears the bits of the last word past the end of an array of packed booleans
+** after its underlying view has been assigned. The source may be a lazy
+** expression such as `fast_not` that sets these bits.
+*/
+template <bool UsesPackedBooleans>
+struct canonicalize_helper
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(array_wrapper<T>&) noexcept {}
+};
+
+template <>
+struct canonicalize_helper<true>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(array_wrapper<T>& dst) noexcept
+	{
+		using word_type = typename
+			array_wrapper<T>::underlying_type::storage_type;
+
+		auto v = dst.underlying_view();
+		auto last = v.end();
+		(*--last).value() &= tail_mask<word_type>(size_t(dst.size()));
+	}
+};
+
+template <class T>
+CC_ALWAYS_INLINE
+void canonicalize(array_wrapper<T>& dst) noexcept
+{
+	using helper = canonicalize_helper<is_boolean_storage<
+		typename array_wrapper<T>::underlying_type>::value>;
+	helper::apply(dst);
+}
+
+/*
+** Dense arrays with the same storage order are traversed using
+** `for_each_offset`, so that the offsets of the elements are stepped rather than
+** computed from their coordinates. Such arrays only reach the loop when they
+** have no view in common, e.g. because one of them pads its rows or packs its
+** booleans into words.
+*/
+template <class Dst, class Src>
+struct offset_walk_traits
+{ static constexpr auto is_feasible = false; };
+
+template <
+	class T1, class Extents1, class StorageOrder1, class Alloc1,
+	class T2, class Extents2, class StorageOrder2, class Alloc2
+>
+struct offset_walk_traits<
+	dense_storage<T1, Extents1, StorageOrder1, Alloc1>,
+	dense_storage<T2, Extents2, StorageOrder2, Alloc2>
+>
+{
+	using dst_access = dense_storage_access<T1>;
+	using src_access = dense_storage_access<T2>;
+
+	static constexpr auto is_feasible = StorageOrder1{} == StorageOrder2{};
+};
+
+/*
+** Used when src and dst have no view in common. If both arrays store their
+** elements contiguously, then their storage orders differ, and the elements are
+** copied using a blocked transpose. Otherwise, they are copied one index at a
+** time.
+*/
+template <bool PermutedCopyFeasible>
+struct loop_assign_helper
+{
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	copy(array_wrapper<T>& dst, const array_wrapper<U>& src)
+	{
+		using traits = offset_walk_traits<T, U>;
+		copy(dst, src, std::integral_constant<bool, traits::is_feasible>{});
+	}
+
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	move(array_wrapper<T>& dst, array_wrapper<U>&& src)
+	{
+		using traits = offset_walk_traits<T, U>;
+		move(dst, std::move(src),
+			std::integral_constant<bool, traits::is_feasible>{});
+	}
+private:
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	copy(array_wrapper<T>& dst, const array_wrapper<U>& src, std::true_type)
+	{
+		using traits = offset_walk_traits<T, U>;
+		using dst_access = typename traits::dst_access;
+		using src_access = typename traits::src_access;
+
+		auto& d = dst.wrapped();
+		auto& s = src.wrapped();
+		for_each_offset(d, s, [&] (const auto&, const auto i, const auto j)
+			CC_ALWAYS_INLINE {
+				dst_access::at(i, d) = src_access::at(j, s);
+			});
+	}
+
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	copy(array_wrapper<T>& dst, const array_wrapper<U>& src, std::false_type)
+	{
+		nd::for_each(src.extents(),
+			[&] (const auto& i) CC_ALWAYS_INLINE {
+				dst(i) = src(i);
+			});
+	}
+
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	move(array_wrapper<T>& dst, array_wrapper<U>&& src, std::true_type)
+	{
+		using traits = offset_walk_traits<T, U>;
+		using dst_access = typename traits::dst_access;
+		using src_access = typename traits::src_access;
+
+		auto& d = dst.wrapped();
+		auto& s = src.wrapped();
+		for_each_offset(d, s, [&] (const auto&, const auto i, const auto j)
+			CC_ALWAYS_INLINE {
+				dst_access::at(i, d) = std::move(src_access::at(j, s));
+			});
+	}
+
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	move(array_wrapper<T>& dst, array_wrapper<U>&& src, std::false_type)
+	{
+		nd::for_each(src.extents(),
+			[&] (const auto& i) CC_ALWAYS_INLINE {
+				dst(i) = std::move(src(i));
+			});
+	}
+};
+
+/*
+** The elements are trivially copyable, so moving them is the same as copying
+** them.
+*/
+template <>
+struct loop_assign_helper<true>
+{
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	copy(array_wrapper<T>& dst, const array_wrapper<U>& src)
+	{ permuted_copy(dst, src); }
+
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	move(array_wrapper<T>& dst, array_wrapper<U>&& src)
+	{ permuted_copy(dst, src); }
+};
+
 template <
 	bool DirectAssignmentFeasible, 
+	bool PacketViewFeasible,
+	bool FusedViewFeasible,
 	bool UnderlyingViewFeasible,
 	bool FlatViewFeasible
 >
@@ -59,13 +241,23 @@ struct copy_assign_helper;
 
 template <
 	bool DirectAssignmentFeasible, 
+	bool PacketViewFeasible,
+	bool FusedViewFeasible,
 	bool UnderlyingViewFeasible,
 	bool FlatViewFeasible
 >
 struct move_assign_helper;
 
-template <bool UnderlyingViewFeasible, bool FlatViewFeasible>
-struct copy_assign_helper<true, UnderlyingViewFeasible, FlatViewFeasible>
+template <
+	bool PacketViewFeasible,
+	bool FusedViewFeasible,
+	bool UnderlyingViewFeasible,
+	bool FlatViewFeasible
+>
+struct copy_assign_helper<
+	true, PacketViewFeasible, FusedViewFeasible,
+	UnderlyingViewFeasible, FlatViewFeasible
+>
 {
 	template <class T, class U>
 	CC_ALWAYS_INLINE
@@ -74,8 +266,57 @@ struct copy_assign_helper<true, UnderlyingViewFeasible, FlatViewFeasible>
 	{ dst.wrapped() = src.wrapped(); }
 };
 
+/*
+** Used when the source is a lazy expression whose arguments all provide packet
+** views. Each iteration evaluates the expression for an entire packet.
+*/
+template <
+	bool FusedViewFeasible,
+	bool UnderlyingViewFeasible,
+	bool FlatViewFeasible
+>
+struct copy_assign_helper<
+	false, true, FusedViewFeasible,
+	UnderlyingViewFeasible, FlatViewFeasible
+>
+{
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	apply(array_wrapper<T>& dst, const array_wrapper<U>& src)
+	{
+		using dst_type = array_wrapper<T>;
+		using helper = resize_helper<dst_type::is_destructively_resizable>;
+
+		helper::apply(dst, src);
+		packet_copy(dst.packet_view(), src.packet_view());
+	}
+};
+
+/*
+** Used when the source is a lazy expression whose leaves all provide fused
+** views, but whose functions cannot be applied to packets.
+*/
+template <bool UnderlyingViewFeasible, bool FlatViewFeasible>
+struct copy_assign_helper<
+	false, false, true, UnderlyingViewFeasible, FlatViewFeasible
+>
+{
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	apply(array_wrapper<T>& dst, const array_wrapper<U>& src)
+	{
+		using dst_type = array_wrapper<T>;
+		using helper = resize_helper<dst_type::is_destructively_resizable>;
+
+		helper::apply(dst, src);
+		fused_copy(dst.fused_view(), src.fused_view());
+	}
+};
+
 template <bool FlatViewFeasible>
-struct copy_assign_helper<false, true, FlatViewFeasible>
+struct copy_assign_helper<false, false, false, true, FlatViewFeasible>
 {
 	template <class T, class U>
 	CC_ALWAYS_INLINE
@@ -91,11 +332,12 @@ struct copy_assign_helper<false, true, FlatViewFeasible>
 			src.underlying_view().end(),
 			dst.underlying_view().begin()
 		);
+		canonicalize(dst);
 	}
 };
 
 template <>
-struct copy_assign_helper<false, false, true>
+struct copy_assign_helper<false, false, false, false, true>
 {
 	template <class T, class U>
 	CC_ALWAYS_INLINE
@@ -115,7 +357,7 @@ struct copy_assign_helper<false, false, true>
 };
 
 template <>
-struct copy_assign_helper<false, false, false>
+struct copy_assign_helper<false, false, false, false, false>
 {
 	template <class T, class U>
 	CC_ALWAYS_INLINE
@@ -125,16 +367,25 @@ struct copy_assign_helper<false, false, false>
 		using src_type = array_wrapper<T>;
 		using helper = resize_helper<src_type::is_destructively_resizable>;
 
+		using traits = copy_assignment_traits<
+			array_wrapper<U>, array_wrapper<T>>;
+		using loop = loop_assign_helper<traits::can_use_permuted_copy>;
+
 		helper::apply(dst, src);
-		nd::for_each(src.extents(),
-			[&] (const auto& i) CC_ALWAYS_INLINE {
-				dst(i) = src(i);
-			});
+		loop::copy(dst, src);
 	}
 };
 
-template <bool UnderlyingViewFeasible, bool FlatViewFeasible>
-struct move_assign_helper<true, UnderlyingViewFeasible, FlatViewFeasible>
+template <
+	bool PacketViewFeasible,
+	bool FusedViewFeasible,
+	bool UnderlyingViewFeasible,
+	bool FlatViewFeasible
+>
+struct move_assign_helper<
+	true, PacketViewFeasible, FusedViewFeasible,
+	UnderlyingViewFeasible, FlatViewFeasible
+>
 {
 	template <class T, class U>
 	CC_ALWAYS_INLINE
@@ -143,8 +394,57 @@ struct move_assign_helper<true, UnderlyingViewFeasible, FlatViewFeasible>
 	{ dst.wrapped() = std::move(src.wrapped()); }
 };
 
+/*
+** Packet views are only provided for arithmetic types, so moving the elements
+** is the same as copying them.
+*/
+template <
+	bool FusedViewFeasible,
+	bool UnderlyingViewFeasible,
+	bool FlatViewFeasible
+>
+struct move_assign_helper<
+	false, true, FusedViewFeasible,
+	UnderlyingViewFeasible, FlatViewFeasible
+>
+{
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	apply(array_wrapper<T>& dst, array_wrapper<U>&& src)
+	{
+		using dst_type = array_wrapper<T>;
+		using helper = resize_helper<dst_type::is_destructively_resizable>;
+
+		helper::apply(dst, src);
+		packet_copy(dst.packet_view(), src.packet_view());
+	}
+};
+
+/*
+** The fused view of a lazy expression produces temporaries, so moving the
+** elements is the same as copying them.
+*/
+template <bool UnderlyingViewFeasible, bool FlatViewFeasible>
+struct move_assign_helper<
+	false, false, true, UnderlyingViewFeasible, FlatViewFeasible
+>
+{
+	template <class T, class U>
+	CC_ALWAYS_INLINE
+	static void
+	apply(array_wrapper<T>& dst, array_wrapper<U>&& src)
+	{
+		using dst_type = array_wrapper<T>;
+		using helper = resize_helper<dst_type::is_destructively_resizable>;
+
+		helper::apply(dst, src);
+		fused_copy(dst.fused_view(), src.fused_view());
+	}
+};
+
 template <bool FlatViewFeasible>
-struct move_assign_helper<false, true, FlatViewFeasible>
+struct move_assign_helper<false, false, false, true, FlatViewFeasible>
 {
 	template <class T, class U>
 	CC_ALWAYS_INLINE
@@ -160,11 +460,12 @@ struct move_assign_helper<false, true, FlatViewFeasible>
 			src.underlying_view().end(),
 			dst.underlying_view().begin()
 		);
+		canonicalize(dst);
 	}
 };
 
 template <>
-struct move_assign_helper<false, false, true>
+struct move_assign_helper<false, false, false, false, true>
 {
 	template <class T, class U>
 	CC_ALWAYS_INLINE
@@ -184,7 +485,7 @@ struct move_assign_helper<false, false, true>
 };
 
 template <>
-struct move_assign_helper<false, false, false>
+struct move_assign_helper<false, false, false, false, false>
 {
 	template <class T, class U>
 	CC_ALWAYS_INLINE
@@ -194,11 +495,12 @@ struct move_assign_helper<false, false, false>
 		using src_type = array_wrapper<T>;
 		using helper = resize_helper<src_type::is_destructively_resizable>;
 
+		using traits = move_assignment_traits<
+			array_wrapper<U>, array_wrapper<T>>;
+		using loop = loop_assign_helper<traits::can_use_permuted_copy>;
+
 		helper::apply(dst, src);
-		nd::for_each(src.extents(),
-			[&] (const auto& i) CC_ALWAYS_INLINE {
-				dst(i) = std::move(src(i));
-			});
+		loop::move(dst, std::move(src));
 	}
 };
 
@@ -213,6 +515,8 @@ struct assignment_helper
 			array_wrapper<U>, array_wrapper<T>>;
 		using helper = copy_assign_helper<
 			traits::can_use_direct_assignment,
+			traits::can_use_packet_view,
+			traits::can_use_fused_view,
 			traits::can_use_underlying_view,
 			traits::can_use_flat_view>;
 		helper::apply(dst, src);
@@ -227,6 +531,8 @@ struct assignment_helper
 			array_wrapper<U>, array_wrapper<T>>;
 		using helper = move_assign_helper<
 			traits::can_use_direct_assignment,
+			traits::can_use_packet_view,
+			traits::can_use_fused_view,
 			traits::can_use_underlying_view,
 			traits::can_use_flat_view>;
 		helper::apply(dst, std::move(src));
@@ -60,6 +60,52 @@ struct iterator_assignment_traits<LHSIter, void>
 	static constexpr auto is_move_assignable = false;
 };
 
+/*
+** Determines whether the packets produced by the packet view of the source can
+** be stored using the packet view of the destination.
+*/
+template <class Dst, class Src, bool ProvidesPacketViews>
+struct packet_assignment_traits
+{ static constexpr auto is_assignable = false; };
+
+template <class Dst, class Src>
+struct packet_assignment_traits<Dst, Src, true>
+{
+	using dst_view = decltype(std::declval<Dst&>().packet_view());
+	using src_view = decltype(std::declval<const Src&>().packet_view());
+
+	static constexpr auto is_assignable = std::is_same<
+		typename dst_view::packet_type,
+		typename src_view::packet_type
+	>::value;
+};
+
+/*
+** Determines whether the elements of the source can be copied to the
+** destination using `permuted_copy` (see `permuted_copy.hpp`). This requires
+** both arrays to store their elements contiguously, as plain values of the same
+** trivially-copyable type.
+*/
+template <class Dst, class Src, bool ProvidesUnderlyingViews>
+struct permuted_copy_traits
+{ static constexpr auto is_feasible = false; };
+
+template <class Dst, class Src>
+struct permuted_copy_traits<Dst, Src, true>
+{
+	using dst_di = typename Dst::underlying_iterator;
+	using src_di = typename Src::underlying_iterator;
+	using type   = typename Dst::underlying_type;
+
+	static constexpr auto is_feasible =
+	std::is_pointer<dst_di>::value                             &&
+	std::is_pointer<src_di>::value                             &&
+	std::is_same<type, typename Src::underlying_type>::value   &&
+	std::is_same<type, typename Dst::external_type>::value     &&
+	std::is_same<type, typename Src::external_type>::value     &&
+	std::is_trivially_copyable<type>::value;
+};
+
 /*
 ** General procedure for copy assignment. The basic idea is to use the most
 ** efficient mechanism for copy assignment that is supported by both src and
@@ -70,10 +116,16 @@ struct iterator_assignment_traits<LHSIter, void>
 ** - If dst needs to be resized but is not resizable, then raise an error.
 ** Otherwise, resize.
 ** - If dst and src have compatible storage orders:
+**   - If src is lazy, both dst and src provide packet views, and the packet
+**   types agree, then evaluate src one packet at a time using the packet views.
+**   - Else if src is lazy and both dst and src provide fused views, then
+**   evaluate src in a single loop over the offsets using the fused views.
 **   - If both dst and src support underlying views over the elements, and it is
 **   possible to copy from src's underlying view to dst's underlying view, then do so.
 **   - Else if dst provides a fast flat view implementation, then copy from
 **   src's flat view to dst's flat view.
+** - Else if dst and src store their elements contiguously, then copy using a
+** blocked transpose (see `permuted_copy.hpp`).
 ** - Else, copy using a for-each loop over src's range.
 */
 template <class Src, class Dst>
@@ -103,6 +155,20 @@ struct copy_assignment_traits
 	using src_di = typename Src::underlying_iterator;
 	using traits = iterator_assignment_traits<dst_di, src_di>;
 
+	static constexpr auto can_use_packet_view =
+	storage_orders_same &&
+	Src::is_lazy        &&
+	packet_assignment_traits<Dst, Src,
+		Dst::provides_packet_view &&
+		Src::provides_packet_view
+	>::is_assignable;
+
+	static constexpr auto can_use_fused_view =
+	storage_orders_same       &&
+	Src::is_lazy              &&
+	Dst::provides_fused_view  &&
+	Src::provides_fused_view;
+
 	static constexpr auto can_use_underlying_view =
 	storage_orders_same           &&
 	Dst::provides_underlying_view &&
@@ -112,6 +178,13 @@ struct copy_assignment_traits
 	static constexpr auto can_use_flat_view =
 	storage_orders_same &&
 	Dst::provides_fast_flat_view;
+
+	static constexpr auto can_use_permuted_copy =
+	!storage_orders_same &&
+	permuted_copy_traits<Dst, Src,
+		Dst::provides_underlying_view &&
+		Src::provides_underlying_view
+	>::is_feasible;
 };
 
 /*
@@ -145,6 +218,20 @@ struct move_assignment_traits
 	using src_di = typename Src::underlying_iterator;
 	using traits = iterator_assignment_traits<dst_di, src_di>;
 
+	static constexpr auto can_use_packet_view =
+	storage_orders_same &&
+	Src::is_lazy        &&
+	packet_assignment_traits<Dst, Src,
+		Dst::provides_packet_view &&
+		Src::provides_packet_view
+	>::is_assignable;
+
+	static constexpr auto can_use_fused_view =
+	storage_orders_same       &&
+	Src::is_lazy              &&
+	Dst::provides_fused_view  &&
+	Src::provides_fused_view;
+
 	static constexpr auto can_use_underlying_view =
 	storage_orders_same           &&
 	Dst::provides_underlying_view &&
@@ -154,6 +241,13 @@ struct move_assignment_traits
 	static constexpr auto can_use_flat_view =
 	storage_orders_same &&
 	Dst::provides_fast_flat_view;
+
+	static constexpr auto can_use_permuted_copy =
+	!storage_orders_same &&
+	permuted_copy_traits<Dst, Src,
+		Dst::provides_underlying_view &&
+		Src::provides_underlying_view
+	>::is_feasible;
 };
 
 /*
@@ -146,6 +146,15 @@ struct array_traits_no_view
 	static constexpr auto check_destructive_resize(...)
 	{ return false; }
 
+	template <class U>
+	static constexpr auto check_unsafe_resize(U*) ->
+	decltype(std::declval<U>().unsafe_resize(std::declval<U>().extents()), bool{})
+	{ return true; }
+
+	template <class U>
+	static constexpr auto check_unsafe_resize(...)
+	{ return false; }
+
 	template <class U>
 	static constexpr auto check_memory_size(U*) ->
 	decltype(std::declval<U>().memory_size(), bool{})
@@ -164,11 +173,22 @@ struct array_traits_no_view
 	static constexpr auto check_allocator(...)
 	{ return false; }
 
+	template <class U>
+	static constexpr auto check_alignment(U*) ->
+	decltype(U::alignment, size_t{})
+	{ return U::alignment; }
+
+	template <class U>
+	static constexpr auto check_alignment(...)
+	{ return size_t{0}; }
+
 	static constexpr auto is_lazy                      = T::is_lazy;
 	static constexpr auto is_conservatively_resizable  = check_conservative_resize<T>(0);
 	static constexpr auto is_destructively_resizable   = check_destructive_resize<T>(0);
+	static constexpr auto is_unsafely_resizable        = check_unsafe_resize<T>(0);
 	static constexpr auto provides_memory_size         = check_memory_size<T>(0);
 	static constexpr auto provides_allocator           = check_allocator<T>(0);
+	static constexpr auto alignment                    = check_alignment<T>(0);
 
 	using et = detail::element_access_traits<T, dims>;
 
@@ -211,8 +231,28 @@ struct array_traits : array_traits_no_view<T>
 	static constexpr auto check_flat_view(...)
 	{ return false; }
 
+	template <class U>
+	static constexpr auto check_packet_view(U*) ->
+	decltype(std::declval<const U>().packet_view(), bool{})
+	{ return true; }
+
+	template <class U>
+	static constexpr auto check_packet_view(...)
+	{ return false; }
+
+	template <class U>
+	static constexpr auto check_fused_view(U*) ->
+	decltype(std::declval<const U>().fused_view(), bool{})
+	{ return true; }
+
+	template <class U>
+	static constexpr auto check_fused_view(...)
+	{ return false; }
+
 	static constexpr auto provides_underlying_view     = check_underlying_view<T>(0);
 	static constexpr auto provides_fast_flat_view      = check_flat_view<T>(0);
+	static constexpr auto provides_packet_view         = check_packet_view<T>(0);
+	static constexpr auto provides_fused_view          = check_fused_view<T>(0);
 	static constexpr auto supports_fast_initialization = check_construction_view<T>(0);
 
 	using base            = array_traits_no_view<T>;
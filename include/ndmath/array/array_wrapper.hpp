@@ -55,7 +55,11 @@
 ** - allocator()         (optional, const and non-const)
 ** - flat_view()         (optional, const and non-const)
 ** - underlying_view()   (optional, const and non-const)
-** - resize()            (optional, const and non-const)
+** - packet_view()       (optional, const and non-const)
+** - fused_view()        (optional, const and non-const)
+** - conservative_resize() (optional, non-const)
+** - destructive_resize()  (optional, non-const)
+** - unsafe_resize()       (optional, non-const)
 **
 ** ## Requirement 4: Optional Support for "Late Initialization"
 **
@@ -120,10 +124,40 @@
 ** - Flat view: a 1D range over the elements of the array. If the underlying
 **   storage type provides an implementation of a flat view, then this
 **   implementation is used. In this case, `provides_fast_flat_view = true`.
-**   Otherwise, a generic flat view implementation is used. This genetic
-**   implementation uses a formula to compute the indices corresponding to a
-**   given offset. If an array type does not provide a "fast" flat view, then it
-**   is preferable to access the elements using indices.
+**   Otherwise, a generic flat view implementation is used. This generic
+**   implementation keeps the coordinates of the current element, and updates
+**   them incrementally as the iterator advances (see
+**   `segmented_flat_iterator.hpp`). Sequential traversals are reasonably
+**   efficient, but random access requires computing the coordinates
+**   corresponding to an offset. If an array type does not provide a "fast"
+**   flat view, then it is preferable to access the elements using indices.
+**
+** - Packet view: a view over the elements of the array, in the same order as
+**   the flat view, that loads and stores entire SIMD packets at a time (see
+**   `simd/packet_view.hpp`). This view only exists if `provides_packet_view =
+**   true`. Lazy arrays whose arguments all provide packet views are assigned
+**   using this view, so that each iteration evaluates an entire packet.
+**
+** - Fused view: a function object that returns the element of the array at a
+**   given offset into its storage, in the same order as the flat view (see
+**   `fused_view.hpp`). This view only exists if `provides_fused_view = true`.
+**   Lazy arrays with fused views are assigned using a single loop over raw
+**   pointers to the storage of the arguments.
+**
+** - Alignment: the alignment in bytes of the first element of the array, if the
+**   wrapped type declares it using a static member `alignment`; otherwise, zero.
+**   Dense arrays are aligned to a cache line by default (see
+**   `aligned_allocator.hpp`).
+**
+** - Strided view: an array that refers to a regularly-spaced subset of the
+**   elements of another array, obtained by invoking the latter with selectors
+**   such as `_` or `slice(a, b, s)` instead of coordinates (see
+**   `strided_view.hpp`). No elements are copied.
+**
+** - Permuted view: an array that refers to the elements of another array with
+**   its dimensions reordered, obtained using `transpose` or `permute_axes` (see
+**   `permuted_view.hpp`). Assigning a permuted view to a dense array transposes
+**   the elements using a cache-blocked kernel.
 */
 
 #ifndef Z9FD66BF0_E92D_4CAE_A49B_8D7708927910
@@ -141,8 +175,10 @@ class array_wrapper;
 #include <ndmath/array/array_construction.hpp>
 
 #include <ndmath/array/initializer_list.hpp>
+#include <ndmath/array/coords_to_offset.hpp>
 #include <ndmath/array/element_from_offset.hpp>
 #include <ndmath/array/flat_iterator.hpp>
+#include <ndmath/array/segmented_flat_iterator.hpp>
 
 /*
 ** Note: `elemwise_view.hpp` depends on `relational_operation.hpp` for `fast_eq`
@@ -150,6 +186,8 @@ class array_wrapper;
 */
 #include <ndmath/array/relational_operation.hpp>
 #include <ndmath/array/elemwise_view.hpp>
+#include <ndmath/array/strided_view.hpp>
+#include <ndmath/array/permuted_view.hpp>
 
 namespace nd {
 
@@ -442,21 +480,25 @@ public:
 	static constexpr auto is_lazy                      = traits::is_lazy;
 	static constexpr auto is_conservatively_resizable  = traits::is_conservatively_resizable;
 	static constexpr auto is_destructively_resizable   = traits::is_destructively_resizable;
+	static constexpr auto is_unsafely_resizable        = traits::is_unsafely_resizable;
 	static constexpr auto is_noexcept_accessible       = traits::is_noexcept_accessible;
 	static constexpr auto provides_underlying_view     = traits::provides_underlying_view;
 	static constexpr auto provides_fast_flat_view      = traits::provides_fast_flat_view;
+	static constexpr auto provides_packet_view         = traits::provides_packet_view;
+	static constexpr auto provides_fused_view          = traits::provides_fused_view;
 	static constexpr auto provides_memory_size         = traits::provides_memory_size;
 	static constexpr auto provides_allocator           = traits::provides_allocator;
+	static constexpr auto alignment                    = traits::alignment;
 	static constexpr auto supports_fast_initialization = traits::supports_fast_initialization;
 
 	using flat_iterator = std::conditional_t<
 		std::is_same<typename traits::flat_iterator, void>::value,
-		nd::flat_iterator<self, element_from_offset>,
+		segmented_flat_iterator<self>,
 		typename traits::flat_iterator
 	>;
 	using const_flat_iterator = std::conditional_t<
 		std::is_same<typename traits::const_flat_iterator, void>::value,
-		nd::flat_iterator<const self, element_from_offset>,
+		segmented_flat_iterator<const self>,
 		typename traits::const_flat_iterator
 	>;
 
@@ -701,7 +743,7 @@ public:
 
 	CC_ALWAYS_INLINE constexpr
 	auto size() const noexcept
-	{ return extents().size(); }
+	{ return detail::extents_size<size_type>(extents()); }
 
 	template <nd_enable_if(provides_memory_size)>
 	CC_ALWAYS_INLINE constexpr
@@ -735,12 +777,12 @@ public:
 	template <nd_enable_if(!provides_fast_flat_view)>
 	CC_ALWAYS_INLINE
 	auto flat_view() noexcept
-	{ return make_flat_view(*this, size(), element_from_offset{}); }
+	{ return make_segmented_flat_view(*this, size()); }
 
 	template <nd_enable_if(!provides_fast_flat_view)>
 	CC_ALWAYS_INLINE
 	auto flat_view() const noexcept
-	{ return make_flat_view(*this, size(), element_from_offset{}); }
+	{ return make_segmented_flat_view(*this, size()); }
 
 	template <nd_enable_if(provides_underlying_view)>
 	CC_ALWAYS_INLINE
@@ -752,6 +794,26 @@ public:
 	auto underlying_view() const noexcept
 	{ return m_wrapped.underlying_view(); }
 
+	template <nd_enable_if(provides_packet_view)>
+	CC_ALWAYS_INLINE
+	auto packet_view() noexcept
+	{ return m_wrapped.packet_view(); }
+
+	template <nd_enable_if(provides_packet_view)>
+	CC_ALWAYS_INLINE
+	auto packet_view() const noexcept
+	{ return m_wrapped.packet_view(); }
+
+	template <nd_enable_if(provides_fused_view)>
+	CC_ALWAYS_INLINE
+	auto fused_view() noexcept
+	{ return m_wrapped.fused_view(); }
+
+	template <nd_enable_if(provides_fused_view)>
+	CC_ALWAYS_INLINE
+	auto fused_view() const noexcept
+	{ return m_wrapped.fused_view(); }
+
 	template <nd_enable_if(supports_fast_initialization)>
 	CC_ALWAYS_INLINE
 	auto construction_view() noexcept
@@ -795,6 +857,37 @@ public:
 		return m_wrapped.at(ts...);
 	}
 
+	/*
+	** Used by the generic implementations of assignment, which visit the
+	** elements of the array using indices.
+	*/
+
+	template <class Index, nd_enable_if((
+		mpl::is_specialization_of<index_wrapper, Index>::value
+	))>
+	CC_ALWAYS_INLINE
+	decltype(auto) at(const Index& i)
+	noexcept(noexcept(is_noexcept_accessible))
+	{
+		return expand_index([&] (const auto... ts)
+			CC_ALWAYS_INLINE noexcept -> decltype(auto) {
+				return this->at(ts...);
+			}, i);
+	}
+
+	template <class Index, nd_enable_if((
+		mpl::is_specialization_of<index_wrapper, Index>::value
+	))>
+	CC_ALWAYS_INLINE constexpr
+	decltype(auto) at(const Index& i) const
+	noexcept(noexcept(is_noexcept_accessible))
+	{
+		return expand_index([&] (const auto... ts)
+			CC_ALWAYS_INLINE noexcept -> decltype(auto) {
+				return this->at(ts...);
+			}, i);
+	}
+
 	template <class... Ts, nd_enable_if((
 		supports_fast_initialization &&
 		sizeof...(Ts) == dims()      &&
@@ -829,6 +922,27 @@ public:
 	auto operator()(const Ts&... ts) const
 	nd_deduce_noexcept_and_return_type(this->at(ts...))
 
+	/*
+	** Slicing (see `strided_view.hpp`). The result refers to the elements
+	** of this array, so it must not outlive it.
+	*/
+
+	template <class... Ts, nd_enable_if((
+		sizeof...(Ts) == dims() &&
+		detail::is_slice_helper<Ts...>::value
+	))>
+	CC_ALWAYS_INLINE
+	auto operator()(const Ts&... ts) noexcept
+	{ return make_strided_view(*this, ts...); }
+
+	template <class... Ts, nd_enable_if((
+		sizeof...(Ts) == dims() &&
+		detail::is_slice_helper<Ts...>::value
+	))>
+	CC_ALWAYS_INLINE
+	auto operator()(const Ts&... ts) const noexcept
+	{ return make_strided_view(*this, ts...); }
+
 	/*
 	** Mutating operations.
 	*/
@@ -843,6 +957,11 @@ public:
 	void destructive_resize(const Range& r)
 	nd_deduce_noexcept(m_wrapped.destructive_resize(r))
 
+	template <class Range, nd_enable_if(is_unsafely_resizable)>
+	CC_ALWAYS_INLINE
+	void unsafe_resize(const Range& r)
+	nd_deduce_noexcept(m_wrapped.unsafe_resize(r))
+
 	/*
 	** Elementwise comparison view.
 	*/
@@ -36,6 +36,13 @@ class boolean_proxy final
 	** that the AND is redundant and decides to use rol anyway.
 	*/
 	Integer m_off;
+
+	using word_type = std::remove_const_t<Storage>;
+	static constexpr auto word_bits = Integer(8 * sizeof(Storage));
+
+	CC_ALWAYS_INLINE constexpr
+	auto mask() const noexcept
+	{ return word_type(word_type{1} << (m_off % word_bits)); }
 public:
 	CC_ALWAYS_INLINE constexpr
 	explicit boolean_proxy(Storage& src, Integer off)
@@ -61,13 +68,13 @@ public:
 	CC_ALWAYS_INLINE
 	auto& operator=(const bool val) noexcept
 	{
-		m_ref ^= (m_ref ^ -Storage{val}) & (1 << (m_off % sizeof(Storage)));
+		m_ref ^= (m_ref ^ -word_type{val}) & mask();
 		return *this;
 	}
 
 	CC_ALWAYS_INLINE constexpr
 	operator bool() const noexcept
-	{ return m_ref & (1 << (m_off % sizeof(Storage))); }
+	{ return m_ref & mask(); }
 };
 
 }
@@ -24,8 +24,12 @@ struct boolean_storage final
 private:
 	T m_data;
 public:
+	/*
+	** The word is zero-initialized, so that the bits past the end of an
+	** array are clear even before the elements are assigned.
+	*/
 	CC_ALWAYS_INLINE constexpr
-	boolean_storage() noexcept {}
+	boolean_storage() noexcept : m_data{} {}
 
 	CC_ALWAYS_INLINE constexpr
 	explicit boolean_storage(const T& rhs) noexcept
@@ -47,6 +51,26 @@ class boolean_proxy;
 
 namespace detail {
 
+template <class T>
+struct is_boolean_storage : std::false_type {};
+
+template <class T>
+struct is_boolean_storage<boolean_storage<T>> : std::true_type {};
+
+/*
+** The bits of the last word of an array of `n` packed booleans that belong to
+** the array. The remaining bits are kept clear in stored arrays, so that words
+** can be compared and written to files directly.
+*/
+template <class Word, class SizeType>
+CC_ALWAYS_INLINE constexpr
+auto tail_mask(const SizeType n) noexcept
+{
+	constexpr auto bits = SizeType(8 * sizeof(Word));
+	return n % bits == 0 ? Word(~Word{0}) :
+		Word((Word{1} << (n % bits)) - 1);
+}
+
 struct fast_not
 {
 	template <class T>
@@ -108,6 +132,89 @@ struct fast_or
 	const noexcept { return x || y; }
 };
 
+struct fast_xor
+{
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const boolean_storage<T>& x, const boolean_storage<T>& y)
+	const noexcept { return boolean_storage<T>{T(x.value() ^ y.value())}; }
+
+	template <class S1, class I1, class S2, class I2>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(
+		const boolean_proxy<S1, I1>& x,
+		const boolean_proxy<S2, I2>& y
+	) const noexcept { return bool(x) != bool(y); }
+
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const bool& x, const bool& y)
+	const noexcept { return x != y; }
+};
+
+/*
+** Computes `x && !y`.
+*/
+struct fast_andnot
+{
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const boolean_storage<T>& x, const boolean_storage<T>& y)
+	const noexcept { return boolean_storage<T>{T(x.value() & ~y.value())}; }
+
+	template <class S1, class I1, class S2, class I2>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(
+		const boolean_proxy<S1, I1>& x,
+		const boolean_proxy<S2, I2>& y
+	) const noexcept { return x && !y; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const bool& x, const bool& y)
+	const noexcept { return x && !y; }
+};
+
+template <class T>
+struct select_value
+{ using type = T; };
+
+template <class Storage, class Integer>
+struct select_value<boolean_proxy<Storage, Integer>>
+{ using type = bool; };
+
+/*
+** Computes `m ? x : y`. When all three arguments are words of packed booleans,
+** the selection is made for every bit of the word at once. Otherwise, the mask
+** can be anything convertible to `bool`, so that boolean arrays can be used to
+** select between the elements of arrays of any type.
+*/
+struct fast_select
+{
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(
+		const boolean_storage<T>& m,
+		const boolean_storage<T>& x,
+		const boolean_storage<T>& y
+	) const noexcept
+	{
+		return boolean_storage<T>{T((m.value() & x.value()) |
+			(~m.value() & y.value()))};
+	}
+
+	template <class M, class U, class V, nd_enable_if((
+		std::is_convertible<M, bool>::value
+	))>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const M& m, const U& x, const V& y) const noexcept
+	{
+		using result = std::common_type_t<
+			typename select_value<U>::type,
+			typename select_value<V>::type
+		>;
+		return bool(m) ? result(x) : result(y);
+	}
+};
+
 struct fast_eq
 {
 	template <class T>
@@ -10,58 +10,407 @@
 #ifndef Z01F92DF2_B6C6_46AE_9E8A_8FD28E108598
 #define Z01F92DF2_B6C6_46AE_9E8A_8FD28E108598
 
+#include <array>
+
 namespace nd {
 namespace detail {
 
 /*
-** Suppose we are given an array with extents $e_1, ..., e_n$ and coordinates
-** $c_1, ..., c_n$. Assume that the storage order of the array is such that
-** $e_n$ increases the fastest and $e_1$ the slowest. Then the offset is given
-** by
-** 	off = e_2 * ... * e_n * c_1 +
-** 	      e_3 * ... * e_n * c_2 +
-** 	      e_4 * ... * e_n * c_3 +
-** 	      ...                   +
-** 	      e_n * c_{n - 1} + c_n.
+** Suppose we are given an array with extents $e_1, ..., e_n$, starting
+** coordinates $s_1, ..., s_n$, and coordinates $c_1, ..., c_n$. Let $p_1, ...,
+** p_n$ be the storage order of the array, so that $c_{p_n}$ increases the
+** fastest and $c_{p_1}$ the slowest. Writing $d_i = c_{p_i} - s_{p_i}$, the
+** offset is given by
+** 	off = e_{p_2} * ... * e_{p_n} * d_1 +
+** 	      e_{p_3} * ... * e_{p_n} * d_2 +
+** 	      ...                           +
+** 	      e_{p_n} * d_{n - 1} + d_n.
+**
+** We evaluate this using Horner's rule. All arithmetic is performed using
+** `SizeType`, so that the offset does not wrap around when the number of
+** elements exceeds the range of the integral type used for the coordinates.
 **
-** This product can be computed recursively in an obvious way; this is what is
-** done below.
+** If the array pads its rows, then $e_{p_n}$ is replaced by the leading
+** dimension of the array, i.e. the number of elements occupied by each row in
+** memory.
 */
 
-template <size_t CurDim, size_t End, class SizeType>
+template <class Array>
+CC_ALWAYS_INLINE constexpr
+auto leading_dimension(const Array& arr, int) noexcept ->
+decltype(arr.leading_dimension())
+{ return arr.leading_dimension(); }
+
+template <class Array>
+CC_ALWAYS_INLINE constexpr
+auto leading_dimension(const Array& arr, long) noexcept
+{
+	using order_coord = std::decay_t<decltype(
+		arr.storage_order().at_c(sc_coord<Array::dims() - 1>))>;
+	return arr.extents().length(sc_coord<unsigned(order_coord::value())>);
+}
+
+template <size_t CurDim, size_t Dims, class SizeType>
 struct coords_to_offset_helper
 {
-	using next = coords_to_offset_helper<CurDim + 1, End, SizeType>;
+	using next = coords_to_offset_helper<CurDim + 1, Dims, SizeType>;
 
-	template <class Array, class T, class... Ts>
+	template <class Array, class Coords>
 	CC_ALWAYS_INLINE constexpr
-	static auto apply(
-		const Array& arr,
-		const SizeType prod,
-		const T t,
-		const Ts... ts
-	) noexcept
+	static auto apply(const Array& arr, const Coords& cs, const SizeType prod)
+	noexcept
 	{
-		return next::apply(arr, arr.extents().length(
-			arr.storage_order().at_c(sc_coord<CurDim>)) * prod +
-			t - arr.extents().start(sc_coord<CurDim>), ts...);
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		constexpr auto dim = unsigned(order_coord::value());
+
+		const auto len = CurDim + 1 == Dims ?
+			SizeType(leading_dimension(arr, 0)) :
+			SizeType(arr.extents().length(sc_coord<dim>));
+
+		return next::apply(arr, cs, prod * len +
+			SizeType(cs[dim] - arr.extents().start(sc_coord<dim>)));
 	}
+};
 
-	template <class Array>
+template <size_t Dims, class SizeType>
+struct coords_to_offset_helper<Dims, Dims, SizeType>
+{
+	template <class Array, class Coords>
 	CC_ALWAYS_INLINE constexpr
-	static auto apply(const Array&, const SizeType prod)
+	static auto apply(const Array&, const Coords&, const SizeType prod)
 	noexcept { return prod; }
 };
 
-template <size_t End, class SizeType>
-struct coords_to_offset_helper<End, End, SizeType>
+/*
+** Expanding the expression for the offset gives
+** 	off = s_1 * (c_1 - s_1) + ... + s_n * (c_n - s_n),
+** where the stride of coordinate $p_n$ is one, that of $p_{n - 1}$ is the
+** leading dimension, and that of $p_k$ is the product of the stride and extent
+** of $p_{k + 1}$ for $k < n - 1$. Arrays whose extents are only known at
+** runtime can compute this table once when their extents change, and expose it
+** using a member function `offset_strides()`. The offset is then a dot product
+** whose terms are independent, rather than a chain of multiplications that
+** reads every extent on each access.
+*/
+template <size_t CurDim, size_t Dims, class SizeType>
+struct offset_strides_helper
+{
+	using next = offset_strides_helper<CurDim - 1, Dims, SizeType>;
+
+	template <class Array, class Strides>
+	CC_ALWAYS_INLINE
+	static void apply(const Array& arr, Strides& s, const SizeType prod)
+	noexcept
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		constexpr auto dim = unsigned(order_coord::value());
+
+		const auto len = CurDim + 1 == Dims ?
+			SizeType(leading_dimension(arr, 0)) :
+			SizeType(arr.extents().length(sc_coord<dim>));
+
+		s[dim] = prod;
+		next::apply(arr, s, prod * len);
+	}
+};
+
+template <size_t Dims, class SizeType>
+struct offset_strides_helper<0, Dims, SizeType>
+{
+	template <class Array, class Strides>
+	CC_ALWAYS_INLINE
+	static void apply(const Array& arr, Strides& s, const SizeType prod)
+	noexcept
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<0>))>;
+		s[unsigned(order_coord::value())] = prod;
+	}
+};
+
+template <class SizeType, class Array>
+CC_ALWAYS_INLINE
+auto make_offset_strides(const Array& arr) noexcept
 {
-	template <class Array>
+	using helper = offset_strides_helper<Array::dims() - 1, Array::dims(), SizeType>;
+
+	auto s = std::array<SizeType, Array::dims()>{};
+	helper::apply(arr, s, SizeType{1});
+	return s;
+}
+
+template <class Array>
+CC_ALWAYS_INLINE constexpr
+auto offset_strides(const Array& arr, int) noexcept ->
+decltype(arr.offset_strides())
+{ return arr.offset_strides(); }
+
+template <class Array>
+CC_ALWAYS_INLINE
+auto offset_strides(const Array& arr, long) noexcept
+{ return make_offset_strides<typename Array::size_type>(arr); }
+
+template <size_t CurDim, size_t Dims, class SizeType>
+struct strided_offset_helper
+{
+	using next = strided_offset_helper<CurDim + 1, Dims, SizeType>;
+
+	template <class Array, class Strides, class Coords>
 	CC_ALWAYS_INLINE constexpr
-	static auto apply(const Array&, const SizeType prod)
-	noexcept { return prod; }
+	static auto apply(const Array& arr, const Strides& s, const Coords& cs)
+	noexcept
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		constexpr auto dim = unsigned(order_coord::value());
+
+		const auto d = SizeType(cs[dim] - arr.extents().start(sc_coord<dim>));
+		return (CurDim + 1 == Dims ? d : s[dim] * d) +
+			next::apply(arr, s, cs);
+	}
 };
 
+template <size_t Dims, class SizeType>
+struct strided_offset_helper<Dims, Dims, SizeType>
+{
+	template <class Array, class Strides, class Coords>
+	CC_ALWAYS_INLINE constexpr
+	static auto apply(const Array&, const Strides&, const Coords&)
+	noexcept { return SizeType{0}; }
+};
+
+template <class Array, class Coords>
+CC_ALWAYS_INLINE constexpr
+auto coords_to_offset_impl(const Array& arr, const Coords& cs, int) noexcept ->
+decltype(arr.offset_strides(), typename Array::size_type{})
+{
+	using size_type = typename Array::size_type;
+	using helper    = strided_offset_helper<0, Array::dims(), size_type>;
+	return helper::apply(arr, arr.offset_strides(), cs);
+}
+
+template <class Array, class Coords>
+CC_ALWAYS_INLINE constexpr
+auto coords_to_offset_impl(const Array& arr, const Coords& cs, long) noexcept
+{
+	using size_type = typename Array::size_type;
+	using helper    = coords_to_offset_helper<0, Array::dims(), size_type>;
+	return helper::apply(arr, cs, size_type{0});
+}
+
+/*
+** Visits the coordinates in storage order, so that the offset of each element
+** is obtained from that of the previous one by adding the stride of the
+** coordinate that changed. In particular, the innermost loop only increments
+** the offset.
+*/
+template <size_t CurDim, size_t Dims, bool IsInner = CurDim + 1 == Dims>
+struct offset_walk_helper
+{
+	using next = offset_walk_helper<CurDim + 1, Dims>;
+
+	template <class Array, class Strides, class Coords, class SizeType, class Func>
+	CC_ALWAYS_INLINE
+	static void apply(
+		const Array& arr,
+		const Strides& s,
+		Coords& cs,
+		const SizeType off,
+		const Func& f
+	)
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		using integer = std::decay_t<decltype(cs[0])>;
+
+		constexpr auto dim = unsigned(order_coord::value());
+		const auto a = integer(arr.extents().start(sc_coord<dim>));
+		const auto b = integer(a + arr.extents().length(sc_coord<dim>));
+		const auto stride = s[dim];
+
+		auto cur = off;
+		for (cs[dim] = a; cs[dim] != b; ++cs[dim], cur += stride) {
+			next::apply(arr, s, cs, cur, f);
+		}
+	}
+};
+
+template <size_t CurDim, size_t Dims>
+struct offset_walk_helper<CurDim, Dims, true>
+{
+	template <class Array, class Strides, class Coords, class SizeType, class Func>
+	CC_ALWAYS_INLINE
+	static void apply(
+		const Array& arr,
+		const Strides&,
+		Coords& cs,
+		const SizeType off,
+		const Func& f
+	)
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		using integer = std::decay_t<decltype(cs[0])>;
+
+		constexpr auto dim = unsigned(order_coord::value());
+		const auto a = integer(arr.extents().start(sc_coord<dim>));
+		const auto b = integer(a + arr.extents().length(sc_coord<dim>));
+
+		auto cur = off;
+		for (cs[dim] = a; cs[dim] != b; ++cs[dim], ++cur) {
+			invoke(cs, cur, f, std::make_index_sequence<Dims>{});
+		}
+	}
+private:
+	template <class Coords, class SizeType, class Func, size_t... Ts>
+	CC_ALWAYS_INLINE
+	static void invoke(
+		const Coords& cs,
+		const SizeType off,
+		const Func& f,
+		std::index_sequence<Ts...>
+	)
+	{
+		using integer = std::decay_t<decltype(cs[0])>;
+		f(nd::index<integer>(cs[Ts]...), off);
+	}
+};
+
+/*
+** Like `offset_walk_helper`, but steps the offsets of two arrays with the same
+** extents and storage order at once. The strides of the arrays can still
+** differ, e.g. if only one of them pads its rows.
+*/
+template <size_t CurDim, size_t Dims, bool IsInner = CurDim + 1 == Dims>
+struct offset_pair_walk_helper
+{
+	using next = offset_pair_walk_helper<CurDim + 1, Dims>;
+
+	template <
+		class Array, class Strides1, class Strides2, class Coords,
+		class SizeType1, class SizeType2, class Func
+	>
+	CC_ALWAYS_INLINE
+	static void apply(
+		const Array& arr,
+		const Strides1& s1,
+		const Strides2& s2,
+		Coords& cs,
+		const SizeType1 off1,
+		const SizeType2 off2,
+		const Func& f
+	)
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		using integer = std::decay_t<decltype(cs[0])>;
+
+		constexpr auto dim = unsigned(order_coord::value());
+		const auto a = integer(arr.extents().start(sc_coord<dim>));
+		const auto b = integer(a + arr.extents().length(sc_coord<dim>));
+		const auto stride1 = s1[dim];
+		const auto stride2 = s2[dim];
+
+		auto cur1 = off1;
+		auto cur2 = off2;
+		for (
+			cs[dim] = a; cs[dim] != b;
+			++cs[dim], cur1 += stride1, cur2 += stride2
+		) { next::apply(arr, s1, s2, cs, cur1, cur2, f); }
+	}
+};
+
+template <size_t CurDim, size_t Dims>
+struct offset_pair_walk_helper<CurDim, Dims, true>
+{
+	template <
+		class Array, class Strides1, class Strides2, class Coords,
+		class SizeType1, class SizeType2, class Func
+	>
+	CC_ALWAYS_INLINE
+	static void apply(
+		const Array& arr,
+		const Strides1&,
+		const Strides2&,
+		Coords& cs,
+		const SizeType1 off1,
+		const SizeType2 off2,
+		const Func& f
+	)
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		using integer = std::decay_t<decltype(cs[0])>;
+
+		constexpr auto dim = unsigned(order_coord::value());
+		const auto a = integer(arr.extents().start(sc_coord<dim>));
+		const auto b = integer(a + arr.extents().length(sc_coord<dim>));
+
+		auto cur1 = off1;
+		auto cur2 = off2;
+		for (cs[dim] = a; cs[dim] != b; ++cs[dim], ++cur1, ++cur2) {
+			invoke(cs, cur1, cur2, f, std::make_index_sequence<Dims>{});
+		}
+	}
+private:
+	template <
+		class Coords, class SizeType1, class SizeType2, class Func,
+		size_t... Ts
+	>
+	CC_ALWAYS_INLINE
+	static void invoke(
+		const Coords& cs,
+		const SizeType1 off1,
+		const SizeType2 off2,
+		const Func& f,
+		std::index_sequence<Ts...>
+	)
+	{
+		using integer = std::decay_t<decltype(cs[0])>;
+		f(nd::index<integer>(cs[Ts]...), off1, off2);
+	}
+};
+
+template <size_t CurDim, size_t Dims>
+struct extents_size_helper
+{
+	using next = extents_size_helper<CurDim + 1, Dims>;
+
+	template <class SizeType, class Range>
+	CC_ALWAYS_INLINE constexpr
+	static auto apply(const Range& r) noexcept
+	{
+		constexpr auto c = sc_coord<CurDim>;
+		return SizeType((r.finish(c) - r.start(c)) / r.stride(c) + 1) *
+			next::template apply<SizeType>(r);
+	}
+};
+
+template <size_t Dims>
+struct extents_size_helper<Dims, Dims>
+{
+	template <class SizeType, class Range>
+	CC_ALWAYS_INLINE constexpr
+	static auto apply(const Range&) noexcept
+	{ return SizeType{1}; }
+};
+
+/*
+** Computes the number of elements in the range `r` using `SizeType`. Unlike
+** `r.size()`, which uses the integral type of the coordinates of the range,
+** this does not overflow when the product of the extents exceeds the range of
+** the coordinate type.
+*/
+template <class SizeType, class Range>
+CC_ALWAYS_INLINE constexpr
+auto extents_size(const Range& r) noexcept
+{
+	using helper = extents_size_helper<0, Range::dims()>;
+	return helper::template apply<SizeType>(r);
+}
+
 }
 
 struct coords_to_offset
@@ -70,10 +419,10 @@ struct coords_to_offset
 	CC_ALWAYS_INLINE constexpr
 	static auto apply(const Array& arr, const Ts... ts) noexcept
 	{
-		using size_type = typename Array::size_type;
-		using helper = detail::coords_to_offset_helper<
-			0, Array::dims() - 1, size_type>;
-		return helper::apply(arr, ts...);
+		using integer = typename std::decay_t<decltype(arr.extents())>::integer;
+
+		const integer cs[] = {integer(ts)...};
+		return detail::coords_to_offset_impl(arr, cs, 0);
 	}
 };
 
@@ -86,6 +435,46 @@ static auto index_to_offset(const Array& arr, const Index& i) noexcept
 	}, i);
 }
 
+/*
+** Calls `f(i, off)` for each index `i` in the extents of `arr`, where `off` is
+** the offset of `i`. The indices are visited in the storage order of `arr`, and
+** the offsets are computed incrementally rather than using `coords_to_offset`
+** for each index.
+*/
+template <class Array, class Func>
+CC_ALWAYS_INLINE
+void for_each_offset(const Array& arr, const Func& f)
+{
+	using integer = typename std::decay_t<decltype(arr.extents())>::integer;
+	using helper  = detail::offset_walk_helper<0, Array::dims()>;
+
+	const auto s = detail::offset_strides(arr, 0);
+	integer cs[Array::dims()];
+	helper::apply(arr, s, cs, typename Array::size_type{0}, f);
+}
+
+/*
+** Calls `f(i, off1, off2)` for each index `i` in the extents of `arr1`, where
+** `off1` and `off2` are the offsets of `i` in `arr1` and `arr2`. Both arrays
+** must have the same extents and storage order.
+*/
+template <class Array1, class Array2, class Func>
+CC_ALWAYS_INLINE
+void for_each_offset(const Array1& arr1, const Array2& arr2, const Func& f)
+{
+	using integer = typename std::decay_t<decltype(arr1.extents())>::integer;
+	using helper  = detail::offset_pair_walk_helper<0, Array1::dims()>;
+
+	nd_assert(arr1.extents() == arr2.extents(),
+		"arrays must have the same extents");
+
+	const auto s1 = detail::offset_strides(arr1, 0);
+	const auto s2 = detail::offset_strides(arr2, 0);
+	integer cs[Array1::dims()];
+	helper::apply(arr1, s1, s2, cs, typename Array1::size_type{0},
+		typename Array2::size_type{0}, f);
+}
+
 }
 
 #endif
@@ -15,6 +15,22 @@
 #include <ndmath/array/boolean_proxy.hpp>
 #include <ndmath/array/construction_proxy.hpp>
 #include <ndmath/array/storage_order.hpp>
+#include <ndmath/array/fused_view.hpp>
+#include <ndmath/array/aligned_allocator.hpp>
+#include <ndmath/array/sized_allocator.hpp>
+#include <ndmath/array/arena_allocator.hpp>
+#include <ndmath/simd/packet_view.hpp>
+
+/*
+** The unsigned integral type of the words in which arrays of booleans are
+** packed. Wider words let the operations on the underlying view (e.g.
+** `fast_and`, `fast_eq`, and copies) process more elements per instruction.
+** Changing this type changes the type code recorded in array files, so files
+** containing boolean arrays can only be read using the same word type.
+*/
+#ifndef nd_bool_word_type
+	#define nd_bool_word_type std::uint64_t
+#endif
 
 namespace nd {
 
@@ -23,6 +39,16 @@ class dense_storage;
 
 namespace detail {
 
+/*
+** Chooses the narrowest of `unsigned` and `std::size_t` that can represent
+** the given number of elements.
+*/
+template <size_t N>
+using static_size_type = std::conditional_t<
+	N <= std::numeric_limits<unsigned>::max(),
+	unsigned, std::size_t
+>;
+
 template <class T>
 struct dense_storage_access
 {
@@ -33,6 +59,26 @@ struct dense_storage_access
 	static auto& at(const SizeType off, Array& arr) noexcept
 	{ return arr.data()[off]; }
 
+	/*
+	** Pointer to the elements, such that the element at offset `off` is
+	** `data(arr)[off]`. Not provided for packed booleans. The return type
+	** is checked in the context of this class, so it is only well-formed
+	** for storage that befriends it.
+	*/
+	template <class Array>
+	CC_ALWAYS_INLINE
+	static auto data(Array& arr) noexcept -> decltype(arr.data())
+	{ return arr.data(); }
+
+	/*
+	** Accesses an element of a buffer that does not yet belong to an
+	** array, e.g. while the elements are being relocated.
+	*/
+	template <class SizeType>
+	CC_ALWAYS_INLINE
+	static auto& element(underlying_type* p, const SizeType off) noexcept
+	{ return p[off]; }
+
 	template <class SizeType, class Extents, class StorageOrder>
 	CC_ALWAYS_INLINE
 	static auto uninitialized_at(
@@ -61,12 +107,21 @@ struct dense_storage_access
 	CC_ALWAYS_INLINE constexpr
 	static auto underlying_size(const SizeType n) noexcept
 	{ return n; }
+
+	template <class U>
+	CC_ALWAYS_INLINE constexpr
+	static auto& fill_value(const U& x) noexcept
+	{ return x; }
+
+	template <class SizeType>
+	CC_ALWAYS_INLINE
+	static void canonicalize(underlying_type*, const SizeType) noexcept {}
 };
 
 template <>
 struct dense_storage_access<bool>
 {
-	using storage_type    = unsigned;
+	using storage_type    = nd_bool_word_type;
 	using underlying_type = boolean_storage<storage_type>;
 
 	template <class SizeType, class Array>
@@ -95,6 +150,14 @@ struct dense_storage_access<bool>
 		return proxy_type{arr.data()[underlying_offset(off)].value(), off};
 	}
 
+	template <class SizeType>
+	CC_ALWAYS_INLINE
+	static auto element(underlying_type* p, const SizeType off) noexcept
+	{
+		using proxy_type = boolean_proxy<storage_type, SizeType>;
+		return proxy_type{p[underlying_offset(off)].value(), off};
+	}
+
 	template <class SizeType, class Extents, class StorageOrder>
 	CC_ALWAYS_INLINE
 	static auto uninitialized_at(
@@ -136,6 +199,76 @@ struct dense_storage_access<bool>
 		nd_assert(n != 0, "array must have nonzero size");
 		return SizeType{1} + underlying_offset(n - 1);
 	}
+
+	/*
+	** Every bit of the words used to initialize an array is set to the
+	** initial value.
+	*/
+	CC_ALWAYS_INLINE constexpr
+	static auto fill_value(const bool x) noexcept
+	{ return underlying_type{x ? storage_type(~storage_type{0}) : storage_type{0}}; }
+
+	CC_ALWAYS_INLINE constexpr
+	static auto& fill_value(const underlying_type& x) noexcept
+	{ return x; }
+
+	/*
+	** Clears the bits of the last word past the end of an array with `n`
+	** elements.
+	*/
+	template <class SizeType>
+	CC_ALWAYS_INLINE
+	static void canonicalize(underlying_type* p, const SizeType n) noexcept
+	{ p[underlying_offset(n - 1)].value() &= tail_mask<storage_type>(n); }
+};
+
+/*
+** Visits the elements in the intersection of two layouts in storage order, and
+** calls `f(from, to)` with the offset of each element in the first and second
+** layouts. Used to move the elements of an array to their new positions when it
+** is resized.
+*/
+template <size_t CurDim, size_t Dims>
+struct relocation_helper
+{
+	using next = relocation_helper<CurDim + 1, Dims>;
+
+	template <class StorageOrder, class Sizes, class SizeType, class Func>
+	CC_ALWAYS_INLINE
+	static void apply(
+		const StorageOrder& o,
+		const Sizes& len,
+		const Sizes& s1,
+		const Sizes& s2,
+		const SizeType off1,
+		const SizeType off2,
+		const Func& f
+	)
+	{
+		using order_coord = std::decay_t<decltype(o.at_c(sc_coord<CurDim>))>;
+		constexpr auto dim = unsigned(order_coord::value());
+
+		for (auto i = SizeType{0}; i != len[dim]; ++i) {
+			next::apply(o, len, s1, s2, off1 + i * s1[dim],
+				off2 + i * s2[dim], f);
+		}
+	}
+};
+
+template <size_t Dims>
+struct relocation_helper<Dims, Dims>
+{
+	template <class StorageOrder, class Sizes, class SizeType, class Func>
+	CC_ALWAYS_INLINE
+	static void apply(
+		const StorageOrder&,
+		const Sizes&,
+		const Sizes&,
+		const Sizes&,
+		const SizeType off1,
+		const SizeType off2,
+		const Func& f
+	) { f(off1, off2); }
 };
 
 struct construction_view_access
@@ -185,9 +318,14 @@ private:
 		strides{} == sc_index_n<dims(), 1>,
 		"Range of dense storage must have unit stride."
 	);
+	using size_c = decltype(std::declval<Extents>().size_c());
 public:
+	/*
+	** The number of elements is known at compile time, so we can use a
+	** 32-bit size type whenever it suffices without any risk of overflow.
+	*/
 	using external_type   = T;
-	using size_type       = unsigned;
+	using size_type       = detail::static_size_type<std::decay_t<size_c>::value()>;
 	using value_type      = std::decay_t<T>;
 	using underlying_type = typename helper::underlying_type;
 	static constexpr auto is_lazy = false;
@@ -195,11 +333,14 @@ public:
 	using base::extents;
 	using base::storage_order;
 private:
-	using size_c = decltype(std::declval<Extents>().size_c());
 	static constexpr auto m_size = helper::underlying_size(
-		std::decay_t<size_c>::value());
-
-	std::array<underlying_type, m_size> m_data;
+		size_type(std::decay_t<size_c>::value()));
+public:
+	static constexpr auto alignment =
+	detail::static_alignment<underlying_type, m_size>;
+	static constexpr auto pads_rows = false;
+private:
+	alignas(alignment) std::array<underlying_type, m_size> m_data;
 public:
 	CC_ALWAYS_INLINE constexpr
 	explicit dense_storage()
@@ -225,8 +366,9 @@ public:
 		std::is_nothrow_constructible<underlying_type, const U&>::value))
 	{
 		for (auto i = size_type{0}; i != underlying_size(); ++i) {
-			::new (&m_data[i]) underlying_type(init);
+			::new (&m_data[i]) underlying_type(helper::fill_value(init));
 		}
+		helper::canonicalize(data(), size());
 	}
 
 	/*
@@ -238,9 +380,9 @@ public:
 	noexcept(noexcept(
 		std::is_nothrow_constructible<underlying_type, const T&>::value))
 	{
-		for_each(extents(), [&] (const auto& i) 
+		for_each_offset(*this, [&] (const auto& i, const auto off)
 			CC_ALWAYS_INLINE noexcept {
-				::new (&m_data[index_to_offset(*this, i)])
+				::new (&m_data[off])
 				underlying_type(get_init_list_element<T, dims()>(list, i));
 			});
 	}
@@ -260,11 +402,10 @@ public:
 			}
 		}
 
-		for_each(extents(), [&] (const auto& i) 
+		for_each_offset(*this, [&] (const auto& i, const auto off)
 			CC_ALWAYS_INLINE noexcept {
-				expand_index([&] (auto... ts) CC_ALWAYS_INLINE noexcept {
-					return at(ts...);
-				}, i) = get_init_list_element<T, dims()>(list, i);
+				helper::at(off, *this) =
+				get_init_list_element<T, dims()>(list, i);
 			});
 	}
 
@@ -376,6 +517,32 @@ public:
 	CC_ALWAYS_INLINE
 	auto underlying_view() const noexcept
 	{ return boost::make_iterator_range(m_data.begin(), m_data.end()); }
+
+	template <nd_enable_if((detail::is_packable<T>))>
+	CC_ALWAYS_INLINE
+	auto packet_view() noexcept
+	{
+		constexpr auto aligned = detail::is_packet_aligned<T, alignment>;
+		return make_packet_view<aligned>(data(), size());
+	}
+
+	template <nd_enable_if((detail::is_packable<T>))>
+	CC_ALWAYS_INLINE
+	auto packet_view() const noexcept
+	{
+		constexpr auto aligned = detail::is_packet_aligned<T, alignment>;
+		return make_packet_view<aligned>(data(), size());
+	}
+
+	template <nd_enable_if((std::is_same<T, underlying_type>::value))>
+	CC_ALWAYS_INLINE
+	auto fused_view() noexcept
+	{ return make_fused_leaf(data(), size()); }
+
+	template <nd_enable_if((std::is_same<T, underlying_type>::value))>
+	CC_ALWAYS_INLINE
+	auto fused_view() const noexcept
+	{ return make_fused_leaf(data(), size()); }
 private:
 	CC_ALWAYS_INLINE
 	auto data() noexcept
@@ -387,7 +554,7 @@ private:
 
 	CC_ALWAYS_INLINE constexpr
 	auto size() const noexcept
-	{ return size_type{extents().size()}; }
+	{ return detail::extents_size<size_type>(extents()); }
 
 	CC_ALWAYS_INLINE constexpr
 	auto underlying_size() const noexcept
@@ -433,18 +600,68 @@ private:
 		"Range of dense storage must have unit stride."
 	);
 public:
+	/*
+	** The size type is determined by the allocator, so that it is
+	** `std::size_t` by default. A narrower size type can be selected using
+	** `sized_allocator`.
+	*/
 	using external_type   = T;
-	using size_type       = unsigned;
 	using value_type      = std::decay_t<T>;
 	using underlying_type = typename helper::underlying_type;
 	using allocator_type  = mpl::apply<Alloc, underlying_type>;
+	using size_type       = typename std::allocator_traits<allocator_type>::size_type;
 	static constexpr auto is_lazy = false;
 
 	using base::extents;
 	using base::storage_order;
 private:
+	using layout_traits = detail::allocator_layout_traits<allocator_type>;
+	using inner_coord   = std::decay_t<decltype(
+		std::declval<StorageOrder>().at_c(sc_coord<dims() - 1>))>;
+
+	using outer_coord   = std::decay_t<decltype(
+		std::declval<StorageOrder>().at_c(sc_coord<0>))>;
+
+	static constexpr auto inner_dim = unsigned(inner_coord::value());
+	static constexpr auto outer_dim = unsigned(outer_coord::value());
+
+	/*
+	** Allocators can provide `reallocate(p, n, new_n)` to grow a block of
+	** trivially copyable elements without necessarily copying them. If
+	** it throws, the block `p` must already have been released.
+	*/
+	static constexpr auto uses_reallocate =
+	std::is_trivially_copyable<underlying_type>::value &&
+	detail::can_reallocate<allocator_type>::value;
+public:
+	/*
+	** If the allocator requests row padding, then the leading dimension
+	** is rounded up so that each row starts on an aligned boundary. Since
+	** the elements of a padded array are no longer contiguous, it does not
+	** provide the views that treat the elements as a single block of
+	** memory.
+	*/
+	static constexpr auto alignment = layout_traits::alignment;
+	static constexpr auto pads_rows =
+	layout_traits::pads_rows                       &&
+	std::is_same<T, underlying_type>::value        &&
+	alignment % sizeof(underlying_type) == 0;
+
+	/*
+	** If the extents are only known at runtime, then the strides used by
+	** `coords_to_offset` are recomputed whenever the extents change, so
+	** that each access is a dot product with the coordinates.
+	*/
+	static constexpr auto caches_strides = !Extents::allows_static_access;
+private:
+	using stride_table = std::array<size_type, caches_strides ? dims() : 0>;
+
 	underlying_type* m_data{nullptr};
 	allocator_type m_alloc{};
+	stride_table m_strides{};
+
+	// Number of elements of the underlying type that are allocated.
+	size_type m_capacity{0};
 public:
 	CC_ALWAYS_INLINE constexpr
 	explicit dense_storage() noexcept {}
@@ -455,8 +672,10 @@ public:
 		allocator_type alloc = allocator_type{}
 	) : base{e}, m_alloc{alloc}
 	{
-		nd_assert(e.size() > 0, "cannot create array of size zero");
-		m_data = m_alloc.allocate(underlying_size());
+		nd_assert(detail::extents_size<size_type>(e) > 0,
+			"cannot create array of size zero");
+		allocate_storage(underlying_size());
+		update_strides();
 
 		/*
 		** XXX: Calling allocator::construct is technically required in
@@ -493,12 +712,16 @@ public:
 		allocator_type alloc = allocator_type{}
 	) : base{e}, m_alloc{alloc}
 	{
-		nd_assert(e.size() > 0, "cannot create array of size zero");
+		nd_assert(detail::extents_size<size_type>(e) > 0,
+			"cannot create array of size zero");
+
+		allocate_storage(underlying_size());
+		update_strides();
 
-		m_data = m_alloc.allocate(underlying_size());
 		for (auto i = size_type{0}; i != underlying_size(); ++i) {
-			m_alloc.construct(&m_data[i], init);
+			m_alloc.construct(&m_data[i], helper::fill_value(init));
 		}
+		helper::canonicalize(data(), storage_size(extents()));
 	}
 
 	/*
@@ -510,12 +733,15 @@ public:
 		const Extents& e, allocator_type alloc = allocator_type{})
 	: base{e}, m_alloc{alloc}
 	{
-		nd_assert(e.size() > 0, "cannot create array of size zero");
-		m_data = m_alloc.allocate(underlying_size());
+		nd_assert(detail::extents_size<size_type>(e) > 0,
+			"cannot create array of size zero");
+		allocate_storage(underlying_size());
 
-		for_each(extents(), [&] (const auto& i) 
+		update_strides();
+
+		for_each_offset(*this, [&] (const auto& i, const auto off)
 			CC_ALWAYS_INLINE noexcept {
-				m_alloc.construct(&m_data[index_to_offset(*this, i)],
+				m_alloc.construct(&m_data[off],
 					get_init_list_element<T, dims()>(list, i));
 			});
 	}
@@ -529,8 +755,10 @@ public:
 		const Extents& e, allocator_type alloc = allocator_type{})
 	: base{e}, m_alloc{alloc}
 	{
-		nd_assert(e.size() > 0, "cannot create array of size zero");
-		m_data = m_alloc.allocate(underlying_size());
+		nd_assert(detail::extents_size<size_type>(e) > 0,
+			"cannot create array of size zero");
+		allocate_storage(underlying_size());
+		update_strides();
 
 		/*
 		** XXX: Calling allocator::construct is technically required in
@@ -548,11 +776,10 @@ public:
 			}
 		}
 
-		for_each(extents(), [&] (const auto& i) 
+		for_each_offset(*this, [&] (const auto& i, const auto off)
 			CC_ALWAYS_INLINE noexcept {
-				expand_index([&] (auto... ts) CC_ALWAYS_INLINE noexcept {
-					return at(ts...);
-				}, i) = get_init_list_element<T, dims()>(list, i);
+				helper::at(off, *this) =
+				get_init_list_element<T, dims()>(list, i);
 			});
 	}
 
@@ -563,8 +790,10 @@ public:
 		allocator_type alloc = allocator_type{}
 	) : base{e}, m_alloc{alloc}
 	{
-		nd_assert(e.size() > 0, "cannot create array of size zero");
-		m_data = m_alloc.allocate(underlying_size());
+		nd_assert(detail::extents_size<size_type>(e) > 0,
+			"cannot create array of size zero");
+		allocate_storage(underlying_size());
+		update_strides();
 	}
 
 	CC_ALWAYS_INLINE
@@ -593,7 +822,11 @@ public:
 		const Extents& e,
 		allocator_type alloc = allocator_type{}
 	) : base{e}, m_alloc{alloc}
-	{ nd_assert(e.size() > 0, "cannot create array of size zero"); }
+	{
+		nd_assert(detail::extents_size<size_type>(e) > 0,
+			"cannot create array of size zero");
+		update_strides();
+	}
 
 	CC_ALWAYS_INLINE
 	explicit dense_storage(uninitialized_t, const dense_storage& rhs)
@@ -620,10 +853,8 @@ public:
 	{
 		if (m_data == nullptr) return;
 
-		for (auto i = size_type{0}; i != underlying_size(); ++i) {
-			m_alloc.destroy(&m_data[i]);
-		}
-		m_alloc.deallocate(m_data, underlying_size());
+		destroy_range(0, underlying_size());
+		m_alloc.deallocate(m_data, m_capacity);
 	}
 
 	/*
@@ -643,32 +874,37 @@ public:
 	CC_ALWAYS_INLINE
 	auto& operator=(dense_storage&& rhs) noexcept
 	{
-		this->~dense_storage();
-		extents(rhs.extents());
-		m_data = rhs.m_data;
-		rhs.m_data = nullptr;
+		take(rhs);
 		return *this;
 	}
 
+	/*
+	** The buffer of `rhs` is only taken if it was obtained from the same
+	** type of allocator, since it is later freed using ours. Otherwise,
+	** `array_wrapper` moves the elements one at a time.
+	*/
+
 	template <class U, class Extents_, class StorageOrder_, class Alloc_,
 	nd_enable_if((
 		!std::is_same<Alloc_, void>::value &&
 		std::is_same<value_type,
 			typename dense_storage<U, Extents_, StorageOrder_, Alloc_>::value_type
 		>::value &&
+		!pads_rows && !dense_storage<U, Extents_, StorageOrder_, Alloc_>::pads_rows &&
+		std::is_same<allocator_type,
+			typename dense_storage<U, Extents_, StorageOrder_, Alloc_>::allocator_type
+		>::value &&
 		std::is_assignable<
 			Extents, decltype(std::declval<
-				dense_storage<U, Extents_, StorageOrder_, Alloc_>		
+				dense_storage<U, Extents_, StorageOrder_, Alloc_>
 			>().extents())
 		>::value
 	))>
 	CC_ALWAYS_INLINE
 	auto& operator=(dense_storage<U, Extents_, StorageOrder_, Alloc_>&& rhs)
+	noexcept
 	{
-		this->~dense_storage();
-		extents(rhs.extents());
-		m_data = rhs.m_data;
-		rhs.m_data = nullptr;
+		take(rhs);
 		return *this;
 	}
 
@@ -676,6 +912,22 @@ public:
 	auto memory_size() const noexcept
 	{ return sizeof(underlying_type) * underlying_size(); }
 
+	/*
+	** Used by `coords_to_offset` to compute the distance between the
+	** starting elements of consecutive rows.
+	*/
+	CC_ALWAYS_INLINE constexpr
+	auto leading_dimension() const noexcept
+	{ return leading_dimension(extents()); }
+
+	/*
+	** Used by `coords_to_offset` to compute offsets as a dot product.
+	*/
+	template <nd_enable_if(caches_strides)>
+	CC_ALWAYS_INLINE constexpr
+	auto& offset_strides() const noexcept
+	{ return m_strides; }
+
 	CC_ALWAYS_INLINE
 	auto& allocator() noexcept
 	{ return m_alloc; }
@@ -699,6 +951,7 @@ public:
 	decltype(auto) uninitialized_at(const Ts... ts) noexcept
 	{ return helper::uninitialized_at(coords_to_offset::apply(*this, ts...), *this); }
 
+	template <nd_enable_if(!pads_rows)>
 	CC_ALWAYS_INLINE
 	auto flat_view() noexcept
 	{
@@ -708,6 +961,7 @@ public:
 		return make_flat_view(*this, size(), func);
 	}
 
+	template <nd_enable_if(!pads_rows)>
 	CC_ALWAYS_INLINE
 	auto flat_view() const noexcept
 	{
@@ -717,6 +971,7 @@ public:
 		return make_flat_view(*this, size(), func);
 	}
 
+	template <nd_enable_if(!pads_rows)>
 	CC_ALWAYS_INLINE
 	auto construction_view() noexcept
 	{
@@ -724,48 +979,125 @@ public:
 		return make_construction_view(*this, underlying_size(), access{});
 	}
 
+	template <nd_enable_if(!pads_rows)>
 	CC_ALWAYS_INLINE
 	auto underlying_view() noexcept
 	{ return boost::make_iterator_range(m_data, m_data + underlying_size()); }
 
+	template <nd_enable_if(!pads_rows)>
 	CC_ALWAYS_INLINE
 	auto underlying_view() const noexcept
 	{ return boost::make_iterator_range(m_data, m_data + underlying_size()); }
 
+	template <nd_enable_if((detail::is_packable<T> && !pads_rows))>
+	CC_ALWAYS_INLINE
+	auto packet_view() noexcept
+	{
+		constexpr auto aligned = detail::is_packet_aligned<T, alignment>;
+		return make_packet_view<aligned>(data(), size());
+	}
+
+	template <nd_enable_if((detail::is_packable<T> && !pads_rows))>
+	CC_ALWAYS_INLINE
+	auto packet_view() const noexcept
+	{
+		constexpr auto aligned = detail::is_packet_aligned<T, alignment>;
+		return make_packet_view<aligned>(data(), size());
+	}
+
+	template <nd_enable_if((
+		std::is_same<T, underlying_type>::value && !pads_rows))>
+	CC_ALWAYS_INLINE
+	auto fused_view() noexcept
+	{ return make_fused_leaf(data(), size()); }
+
+	template <nd_enable_if((
+		std::is_same<T, underlying_type>::value && !pads_rows))>
+	CC_ALWAYS_INLINE
+	auto fused_view() const noexcept
+	{ return make_fused_leaf(data(), size()); }
+
+	/*
+	** Resizes the array without preserving its elements. The allocation is
+	** reused if it is large enough.
+	*/
 	template <class Extents_, nd_enable_if((
 		std::is_assignable<Extents, Extents_>::value))>
 	CC_ALWAYS_INLINE
 	void destructive_resize(const Extents_& e)
 	{
-		nd_assert(e.size() > 0, "cannot resize array size to zero");
+		nd_assert(detail::extents_size<size_type>(e) > 0,
+			"cannot resize array size to zero");
 
-		if (e.size() < extents().size()) {
-			auto off = helper::underlying_size(e.size());
-			for (auto i = off; i != underlying_size(); ++i) {
-				m_alloc.destroy(&m_data[i]);
-			}
-		}
-		else if (e.size() > extents().size()) {
+		const auto old_size = m_data == nullptr ? size_type{0} : underlying_size();
+		const auto new_size = helper::underlying_size(storage_size(e));
+
+		if (new_size > m_capacity) {
 			this->~dense_storage();
-			auto new_size = helper::underlying_size(e.size());
 			m_data = m_alloc.allocate(new_size, m_data);
+			m_capacity = new_size;
 
 			/*
 			** XXX: Technically, this branch should always be
 			** taken, for reasons discussed earlier.
 			*/
 			if (!std::is_trivial<underlying_type>::value) {
-				for (auto i = size_type{0}; i != new_size; ++i) {
-					m_alloc.construct(&m_data[i]);
-				}
+				construct_range(0, new_size);
 			}
 		}
+		else if (new_size < old_size) {
+			destroy_range(new_size, old_size);
+		}
+		else if (!std::is_trivial<underlying_type>::value) {
+			construct_range(old_size, new_size);
+		}
+
 		extents(e);
+		update_strides();
+		helper::canonicalize(data(), storage_size(e));
 	}
 
 	/*
-	** TODO: unsafe resize.
+	** Resizes the array while preserving the elements whose coordinates
+	** lie within both the old and new extents. The remaining elements are
+	** default-constructed, unless they are trivial.
+	**
+	** If only the extent of the outermost coordinate in storage order
+	** changes (e.g. rows are appended to a row-major matrix), then the
+	** offsets of the existing elements do not change. In this case, the
+	** capacity grows geometrically, so that a sequence of such resizes
+	** takes amortized constant time per element. When the elements are
+	** trivially copyable and the allocator provides `reallocate`, the
+	** allocation is grown without necessarily copying the elements (e.g.
+	** using `realloc`, which can remap the pages of large blocks).
+	** Otherwise, the elements are moved to a new allocation of exactly the
+	** required size.
+	*/
+	template <class Extents_, nd_enable_if((
+		std::is_assignable<Extents, Extents_>::value))>
+	CC_ALWAYS_INLINE
+	void conservative_resize(const Extents_& e)
+	{ preserving_resize<true>(e); }
+
+	/*
+	** Like `conservative_resize`, but the new elements are left
+	** unconstructed. The caller must construct each of them (e.g. using
+	** `uninitialized_at`) before the array is used or destroyed. Arrays of
+	** booleans are always initialized, since the elements share words.
+	*/
+	template <class Extents_, nd_enable_if((
+		std::is_assignable<Extents, Extents_>::value))>
+	CC_ALWAYS_INLINE
+	void unsafe_resize(const Extents_& e)
+	{ preserving_resize<false>(e); }
+
+	/*
+	** The number of elements of the underlying type that fit in the
+	** current allocation.
 	*/
+	CC_ALWAYS_INLINE constexpr
+	auto capacity() const noexcept
+	{ return m_capacity; }
 private:
 	CC_ALWAYS_INLINE
 	auto data() noexcept
@@ -777,11 +1109,250 @@ private:
 
 	CC_ALWAYS_INLINE constexpr
 	auto size() const noexcept
-	{ return size_type{extents().size()}; }
+	{ return detail::extents_size<size_type>(extents()); }
+
+	/*
+	** The number of elements occupied by each row in memory, including the
+	** padding.
+	*/
+	template <class Extents_>
+	CC_ALWAYS_INLINE constexpr
+	static auto leading_dimension(const Extents_& e) noexcept
+	{
+		constexpr auto m = size_type(std::max(
+			alignment / sizeof(underlying_type), size_t{1}));
+		const auto n = size_type(e.length(sc_coord<inner_dim>));
+		return pads_rows ? (n + m - 1) / m * m : n;
+	}
+
+	template <class Extents_>
+	CC_ALWAYS_INLINE constexpr
+	static auto storage_size(const Extents_& e) noexcept
+	{
+		const auto n = detail::extents_size<size_type>(e);
+		if (!pads_rows) { return n; }
+		return n / size_type(e.length(sc_coord<inner_dim>)) *
+			leading_dimension(e);
+	}
 
 	CC_ALWAYS_INLINE constexpr
 	auto underlying_size() const noexcept
-	{ return helper::underlying_size(size()); }
+	{ return helper::underlying_size(storage_size(extents())); }
+
+	CC_ALWAYS_INLINE
+	void allocate_storage(const size_type n)
+	{
+		m_data = m_alloc.allocate(n);
+		m_capacity = n;
+	}
+
+	CC_ALWAYS_INLINE
+	void construct_range(const size_type first, const size_type last)
+	{
+		for (auto i = first; i != last; ++i) {
+			m_alloc.construct(&m_data[i]);
+		}
+	}
+
+	CC_ALWAYS_INLINE
+	void destroy_range(const size_type first, const size_type last) noexcept
+	{
+		for (auto i = first; i != last; ++i) {
+			m_alloc.destroy(&m_data[i]);
+		}
+	}
+
+	template <size_t... Ts, class Extents_>
+	CC_ALWAYS_INLINE
+	auto same_offsets(const Extents_& e, std::index_sequence<Ts...>)
+	const noexcept
+	{
+		const bool same[] = {(
+			Ts == outer_dim ||
+			size_type(e.length(sc_coord<Ts>)) ==
+			size_type(extents().length(sc_coord<Ts>))
+		)...};
+		return std::all_of(std::begin(same), std::end(same),
+			[] (const bool b) { return b; });
+	}
+
+	/*
+	** Moves the first `n` elements to an allocation with room for `cap`
+	** elements.
+	**
+	** `reallocate` may release the old block before it fails (e.g. if
+	** `realloc` succeeds but the aligned copy cannot be allocated), so we
+	** give up ownership of it first. On failure, the array is left without
+	** storage, as it would be after being moved from.
+	*/
+	CC_ALWAYS_INLINE
+	void grow(const size_type cap, const size_type, std::true_type)
+	{
+		const auto p = m_data;
+		const auto c = m_capacity;
+		m_data = nullptr;
+		m_capacity = 0;
+
+		m_data = m_alloc.reallocate(p, c, cap);
+		m_capacity = cap;
+	}
+
+	CC_ALWAYS_INLINE
+	void grow(const size_type cap, const size_type n, std::false_type)
+	{
+		const auto p = m_alloc.allocate(cap);
+		for (auto i = size_type{0}; i != n; ++i) {
+			m_alloc.construct(&p[i], std::move(m_data[i]));
+		}
+
+		destroy_range(0, n);
+		m_alloc.deallocate(m_data, m_capacity);
+		m_data = p;
+		m_capacity = cap;
+	}
+
+	template <bool Construct, class Extents_>
+	void preserving_resize(const Extents_& e)
+	{
+		nd_assert(detail::extents_size<size_type>(e) > 0,
+			"cannot resize array size to zero");
+
+		if (m_data == nullptr) {
+			destructive_resize(e);
+			return;
+		}
+
+		/*
+		** The words of a boolean array must be initialized, so that
+		** the bits past the end of the array are clear.
+		*/
+		constexpr auto construct =
+		!std::is_same<T, underlying_type>::value ||
+		(Construct && !std::is_trivial<underlying_type>::value);
+
+		const auto old_size = underlying_size();
+		const auto new_size = helper::underlying_size(storage_size(e));
+
+		if (same_offsets(e, std::make_index_sequence<dims()>{})) {
+			if (new_size > m_capacity) {
+				grow(std::max(new_size, 2 * m_capacity), old_size,
+					std::integral_constant<bool, uses_reallocate>{});
+			}
+
+			if (new_size < old_size) {
+				destroy_range(new_size, old_size);
+			}
+			else if (construct) {
+				construct_range(old_size, new_size);
+			}
+
+			extents(e);
+			update_strides();
+			helper::canonicalize(data(), storage_size(e));
+			return;
+		}
+
+		const auto old_data = m_data;
+		const auto old_cap  = m_capacity;
+		const auto old_s    = detail::make_offset_strides<size_type>(*this);
+
+		// The extents of the elements that are preserved.
+		auto len = decltype(old_s){};
+		overlap(e, len, std::make_index_sequence<dims()>{});
+
+		allocate_storage(new_size);
+		extents(e);
+		update_strides();
+		const auto new_s = detail::make_offset_strides<size_type>(*this);
+
+		if (construct) {
+			construct_range(0, new_size);
+		}
+
+		using relocation = detail::relocation_helper<0, dims()>;
+		relocation::apply(storage_order(), len, old_s, new_s,
+			size_type{0}, size_type{0},
+			[&] (const auto from, const auto to) CC_ALWAYS_INLINE {
+				relocate(old_data, from, to,
+					std::integral_constant<bool, construct>{});
+			});
+
+		for (auto i = size_type{0}; i != old_size; ++i) {
+			m_alloc.destroy(&old_data[i]);
+		}
+		m_alloc.deallocate(old_data, old_cap);
+		helper::canonicalize(data(), storage_size(e));
+	}
+
+	template <size_t... Ts, class Extents_, class Sizes>
+	CC_ALWAYS_INLINE
+	void overlap(const Extents_& e, Sizes& len, std::index_sequence<Ts...>)
+	const noexcept
+	{
+		const size_type l[] = {std::min(
+			size_type(e.length(sc_coord<Ts>)),
+			size_type(extents().length(sc_coord<Ts>))
+		)...};
+		std::copy(std::begin(l), std::end(l), len.begin());
+	}
+
+	CC_ALWAYS_INLINE
+	void relocate(
+		underlying_type* src,
+		const size_type from,
+		const size_type to,
+		std::true_type
+	) { helper::element(m_data, to) = std::move(helper::element(src, from)); }
+
+	CC_ALWAYS_INLINE
+	void relocate(
+		underlying_type* src,
+		const size_type from,
+		const size_type to,
+		std::false_type
+	) { m_alloc.construct(&m_data[to], std::move(src[from])); }
+
+	/*
+	** Frees our buffer, and takes ownership of that of `rhs` along with
+	** the allocator from which it was obtained.
+	*/
+	template <class Storage>
+	CC_ALWAYS_INLINE
+	void take(Storage& rhs) noexcept
+	{
+		using traits = std::allocator_traits<allocator_type>;
+		using propagate =
+		typename traits::propagate_on_container_move_assignment;
+
+		this->~dense_storage();
+		extents(rhs.extents());
+		update_strides();
+		move_allocator(rhs.m_alloc, propagate{});
+		m_data = rhs.m_data;
+		m_capacity = rhs.m_capacity;
+		rhs.m_data = nullptr;
+		rhs.m_capacity = 0;
+	}
+
+	CC_ALWAYS_INLINE
+	void move_allocator(allocator_type& rhs, std::true_type) noexcept
+	{ m_alloc = std::move(rhs); }
+
+	CC_ALWAYS_INLINE
+	void move_allocator(allocator_type& rhs, std::false_type) noexcept
+	{
+		nd_assert(m_alloc == rhs, "allocators of moved arrays must "
+			"compare equal if they do not propagate");
+	}
+
+	template <nd_enable_if(caches_strides)>
+	CC_ALWAYS_INLINE
+	void update_strides() noexcept
+	{ m_strides = detail::make_offset_strides<size_type>(*this); }
+
+	template <nd_enable_if(!caches_strides)>
+	CC_ALWAYS_INLINE
+	void update_strides() noexcept {}
 };
 
 template <class T>
@@ -995,7 +1566,7 @@ auto make_darray(const Ts... ts)
 	// We must redundantly specialize the allocator and use
 	// `unspecialize_allocator`, so that types of the source and destination
 	// arrays agree for copy assignment, move assignment, etc.
-	using allocator       = detail::unspecialize_allocator<std::allocator<underlying_type>>;
+	using allocator       = detail::unspecialize_allocator<aligned_allocator<underlying_type>>;
 	using storage_type    = dense_storage<T, extents, storage_order, allocator>;
 	using array_type      = array_wrapper<storage_type>;
 	return array_type{nd::extents(ts...)};
@@ -1004,7 +1575,7 @@ auto make_darray(const Ts... ts)
 template <
 	class T,
 	class Extents,
-	class Alloc        = std::allocator<underlying_type<T>>,
+	class Alloc        = aligned_allocator<underlying_type<T>>,
 	class StorageOrder = std::decay_t<decltype(default_storage_order<Extents::dims()>)>,
 	nd_enable_if((
 		mpl::is_specialization_of<range, Extents>::value &&
@@ -1030,7 +1601,7 @@ template <
 	class T,
 	class U,
 	class Extents,
-	class Alloc        = std::allocator<underlying_type<T>>,
+	class Alloc        = aligned_allocator<underlying_type<T>>,
 	class StorageOrder = std::decay_t<decltype(default_storage_order<Extents::dims()>)>,
 	nd_enable_if((
 		std::is_constructible<underlying_type<T>, const U&>::value &&
@@ -1056,7 +1627,7 @@ auto make_darray(
 template <
 	class T,
 	class Extents,
-	class Alloc        = std::allocator<underlying_type<T>>,
+	class Alloc        = aligned_allocator<underlying_type<T>>,
 	class StorageOrder = std::decay_t<decltype(default_storage_order<Extents::dims()>)>,
 	nd_enable_if((
 		mpl::is_specialization_of<range, Extents>::value           &&
@@ -1140,7 +1711,8 @@ auto make_darray(
 	using external_type = typename source_type::external_type;
 	using extents       = std::decay_t<decltype(arr.extents())>;
 	using storage_order = std::decay_t<StorageOrder>;
-	using allocator     = mpl::quote<std::allocator>;
+	using allocator     = detail::unspecialize_allocator<
+	                      	aligned_allocator<underlying_type<external_type>>>;
 	using storage_type  = dense_storage<external_type, extents, storage_order, allocator>;
 	using array_type    = array_wrapper<storage_type>;
 	return array_type{std::forward<Array>(arr), e};
@@ -17,71 +17,66 @@ namespace nd {
 namespace detail {
 
 /*
-** Suppose we are given an array with extents $e_1, ..., e_n$ and an offset off.
-** Assume that the storage order of the array is such that $e_n$ increases the
-** fastest and $e_1$ the slowest. Then the coordinates $c_1, ..., c_n$
-** corresponding to off are given by:
-** - c_1 = floor(off / e_2 * ... * e_n)
-** - c_2 = floor(off / e_3 * ... * e_n) % e_2
-** - c_3 = floor(off / e_4 * ... * e_n) % e_3
-** - c_n = off % e_n
+** Suppose we are given an array with extents $e_1, ..., e_n$, starting
+** coordinates $s_1, ..., s_n$, and an offset off. Let $p_1, ..., p_n$ be the
+** storage order of the array, so that $c_{p_n}$ increases the fastest and
+** $c_{p_1}$ the slowest. Then the coordinates $c_1, ..., c_n$ corresponding to
+** off are given by:
+** - c_{p_n} = s_{p_n} + off % e_{p_n}
+** - c_{p_{n - 1}} = s_{p_{n - 1}} + floor(off / e_{p_n}) % e_{p_{n - 1}}
+** - ...
+** - c_{p_1} = s_{p_1} + floor(off / e_{p_2} * ... * e_{p_n})
 **
-** Technical note on return value: we have to deduce the return value beforehand
-** and pass it as a template parameter, because using auto would convert
-** references to values, which is not what we want.
+** The helper below visits the dimensions in reverse storage order, dividing
+** the offset by each extent in turn. The offset is kept in `SizeType`; the
+** coordinates themselves are always representable using the integral type of
+** the extents.
 */
 
-template <
-	size_t CurDim,
-	size_t LastDim,
-	class SizeType,
-	bool IsNoexceptAccessible
->
+template <size_t CurDim, class SizeType>
 struct element_from_offset_helper
 {
-	using next = element_from_offset_helper<CurDim + 1, LastDim, SizeType,
-		IsNoexceptAccessible>;
+	using next = element_from_offset_helper<CurDim - 1, SizeType>;
 
-	template <class Array, class... Ts>
+	template <class Array, class Coords>
 	CC_ALWAYS_INLINE constexpr
-	static decltype(auto) apply(
-		const SizeType off,
-		const SizeType prod,
-		Array& arr,
-		const Ts&... ts
-	) noexcept(IsNoexceptAccessible)
+	static void apply(const SizeType off, const Array& arr, Coords& cs)
+	noexcept
 	{
-		return next::apply(
-			off,
-			prod * arr.extents().length(
-				arr.storage_order().at_c(sc_coord<LastDim - CurDim>)),
-			arr,
-			arr.extents().start(sc_coord<LastDim - CurDim>) +
-			(off / prod) % arr.extents().length(
-				arr.storage_order().at_c(sc_coord<LastDim - CurDim>)),
-			ts...
-		);
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		using integer = std::decay_t<decltype(cs[0])>;
+
+		constexpr auto dim = unsigned(order_coord::value());
+		const auto len = SizeType(arr.extents().length(sc_coord<dim>));
+
+		cs[dim] = arr.extents().start(sc_coord<dim>) + integer(off % len);
+		next::apply(off / len, arr, cs);
 	}
 };
 
-template <
-	size_t LastDim,
-	class SizeType,
-	bool IsNoexceptAccessible
->
-struct element_from_offset_helper<LastDim, LastDim, SizeType, IsNoexceptAccessible>
+template <class SizeType>
+struct element_from_offset_helper<0, SizeType>
 {
-	template <class Array, class... Ts>
+	template <class Array, class Coords>
 	CC_ALWAYS_INLINE constexpr
-	static decltype(auto) apply(
-		const SizeType off,
-		const SizeType prod,
-		Array& arr,
-		const Ts&... ts
-	) noexcept(IsNoexceptAccessible)
-	{ return arr.at(arr.extents().start(sc_coord<0>) + off / prod, ts...); }
+	static void apply(const SizeType off, const Array& arr, Coords& cs)
+	noexcept
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<0>))>;
+		using integer = std::decay_t<decltype(cs[0])>;
+
+		constexpr auto dim = unsigned(order_coord::value());
+		cs[dim] = arr.extents().start(sc_coord<dim>) + integer(off);
+	}
 };
 
+template <class Array, class Coords, size_t... Ts>
+CC_ALWAYS_INLINE constexpr
+decltype(auto) at_coords(Array& arr, const Coords& cs, std::index_sequence<Ts...>)
+nd_deduce_noexcept(arr.at(cs[Ts]...))
+
 }
 
 struct element_from_offset
@@ -91,12 +86,14 @@ struct element_from_offset
 	decltype(auto) operator()(const typename Array::size_type off, Array& arr) const
 	noexcept(array_traits_no_view<std::decay_t<Array>>::is_noexcept_accessible)
 	{
-		using traits = array_traits_no_view<std::decay_t<Array>>;
+		using traits    = array_traits_no_view<std::decay_t<Array>>;
 		using size_type = typename traits::size_type;
-		using helper = detail::element_from_offset_helper<
-			0, traits::dims - 1, size_type,
-			traits::is_noexcept_accessible>;
-		return helper::apply(off, 1, arr);
+		using integer   = typename std::decay_t<decltype(arr.extents())>::integer;
+		using helper    = detail::element_from_offset_helper<traits::dims - 1, size_type>;
+
+		integer cs[traits::dims];
+		helper::apply(off, arr, cs);
+		return detail::at_coords(arr, cs, std::make_index_sequence<traits::dims>{});
 	}
 };
 
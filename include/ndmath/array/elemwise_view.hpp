@@ -3,15 +3,57 @@
 ** Author:    Aditya Ramesh
 ** Date:      08/15/2015
 ** Contact:   _@adityaramesh.com
+**
+** Lazy elementwise expressions over arrays.
+**
+** # Broadcasting
+**
+** The operands of an expression need not have the same extents. They are
+** broadcast using the rules of NumPy, except that a dimension is only
+** stretched if its length is known at compile time:
+**
+** - The operands are aligned by their trailing dimensions, and an operand with
+**   fewer dimensions than the expression is stretched along the missing
+**   leading dimensions.
+** - An operand whose length along a dimension is statically one is stretched
+**   along that dimension.
+**
+** Along the dimensions that are not stretched, the extents of the operands must
+** be the same. The stretched dimensions have zero stride: the operand is always
+** read at its starting coordinate along them, so that e.g. adding a bias vector
+** to each row of a matrix reads the vector in place:
+**
+** 	auto m = nd::make_darray<float>(nd::extents(rows, cols));
+** 	auto b = nd::make_darray<float>(nd::extents(cols));
+** 	auto r = nd::make_darray<float>(nd::extents(rows, cols));
+** 	r = m + b;
+**
+** Expressions that broadcast do not provide underlying, flat, packet, or fused
+** views, so they are evaluated one index at a time.
+**
+** # Scalar operands
+**
+** One of the operands of a binary operator can be an arithmetic scalar or a
+** coordinate (e.g. `nd::sc_coord<2>`), in which case it is bound to the
+** function instead of being materialized as an array. Such expressions keep
+** all of the views of the array operand, so `r = 2.0f * m + 1.0f` is evaluated
+** using packets when `m` is a float array. Packets are only used when the
+** scalar does not change the type of the result; e.g. `m * 2.0` is evaluated
+** one element at a time, since the product is promoted to `double`. Coordinates
+** are converted to the element type of the array first, so `m / sc_coord<2>`
+** divides the elements of a signed array as signed integers.
 */
 
 #ifndef Z485491EA_9715_4B7F_973C_58E0EA5942C8
 #define Z485491EA_9715_4B7F_973C_58E0EA5942C8
 
+#include <tuple>
 #include <ndmath/array/boolean_storage.hpp>
+#include <ndmath/array/fused_view.hpp>
 #include <ndmath/array/zip_with_iterator.hpp>
 #include <ndmath/utility/fusion.hpp>
 #include <ndmath/utility/named_operator.hpp>
+#include <ndmath/simd/packet_view.hpp>
 
 namespace nd {
 
@@ -43,10 +85,29 @@ struct check_extents_helper
 	static auto apply(Tuple) noexcept {}
 };
 
+/*
+** Storage orders with different numbers of dimensions are never compared, since
+** this happens when operands are broadcast.
+*/
+template <
+	class T,
+	class U,
+	bool SameDims = std::decay_t<T>::dims() == std::decay_t<U>::dims()
+>
+struct storage_orders_same_2_helper
+{
+	static constexpr auto value =
+	decltype(std::declval<T>().storage_order()){} ==
+	decltype(std::declval<U>().storage_order()){};
+};
+
+template <class T, class U>
+struct storage_orders_same_2_helper<T, U, false>
+{ static constexpr auto value = false; };
+
 template <class T, class U>
 static constexpr auto storage_orders_same_2 =
-decltype(std::declval<T>().storage_order()){} ==
-decltype(std::declval<U>().storage_order()){};
+storage_orders_same_2_helper<T, U>::value;
 
 template <bool V, class T, class... Ts>
 struct storage_orders_same_helper;
@@ -66,6 +127,192 @@ storage_orders_same_helper<true, Ts...>::value;
 template <class T>
 using allows_static_access = mpl::bool_<T::allows_static_access>;
 
+template <class T>
+using extents_type = std::decay_t<decltype(std::declval<T>().extents())>;
+
+/*
+** The length of the extents along `Dim` if it is known at compile time, and
+** zero otherwise.
+*/
+template <
+	class Range,
+	size_t Dim,
+	bool IsStatic = Range::template dim_allows_static_access<Dim>()
+>
+struct static_length : std::integral_constant<long, 0> {};
+
+template <class Range, size_t Dim>
+struct static_length<Range, Dim, true> :
+std::integral_constant<long, long(length<Dim, Range>)> {};
+
+/*
+** Describes each dimension of an operand of a broadcast expression with `Dims`
+** dimensions: -1 if the operand does not have the dimension, zero if its length
+** is only known at runtime, and its length otherwise.
+*/
+template <size_t Dims>
+struct dim_codes
+{ long values[Dims]; };
+
+template <size_t Dims, class T, size_t... Ts>
+CC_ALWAYS_INLINE constexpr
+auto make_dim_codes(std::index_sequence<Ts...>) noexcept
+{
+	using range = extents_type<T>;
+	constexpr auto lead = Dims - sizeof...(Ts);
+	const long lens[] = {static_length<range, Ts>::value...};
+
+	auto r = dim_codes<Dims>{};
+	for (auto d = size_t{0}; d != Dims; ++d) {
+		r.values[d] = d < lead ? -1 : lens[d - lead];
+	}
+	return r;
+}
+
+template <size_t Dims, class T>
+CC_ALWAYS_INLINE constexpr
+auto make_dim_codes() noexcept
+{
+	using seq = std::make_index_sequence<extents_type<T>::dims()>;
+	return make_dim_codes<Dims, T>(seq{});
+}
+
+template <class... Ts>
+CC_ALWAYS_INLINE constexpr
+auto broadcast_dims() noexcept
+{
+	const size_t dims[] = {extents_type<Ts>::dims()...};
+
+	auto r = size_t{0};
+	for (auto k = size_t{0}; k != sizeof...(Ts); ++k) {
+		r = dims[k] > r ? dims[k] : r;
+	}
+	return r;
+}
+
+/*
+** Whether any operand is stretched along a dimension, i.e. is missing it, or
+** has length one along it while another operand does not.
+*/
+template <class... Ts>
+CC_ALWAYS_INLINE constexpr
+auto broadcasts() noexcept
+{
+	constexpr auto n = broadcast_dims<Ts...>();
+	const dim_codes<n> cs[] = {make_dim_codes<n, Ts>()...};
+
+	for (auto d = size_t{0}; d != n; ++d) {
+		auto ones = false, others = false;
+		for (auto k = size_t{0}; k != sizeof...(Ts); ++k) {
+			if (cs[k].values[d] == -1) return true;
+			(cs[k].values[d] == 1 ? ones : others) = true;
+		}
+		if (ones && others) return true;
+	}
+	return false;
+}
+
+/*
+** The operand that provides the extents of the expression along `d`: the first
+** one that is not stretched along `d`, or the first one that has the dimension
+** if all of them are.
+*/
+template <class... Ts>
+CC_ALWAYS_INLINE constexpr
+auto broadcast_source(const size_t d) noexcept
+{
+	constexpr auto n = broadcast_dims<Ts...>();
+	const dim_codes<n> cs[] = {make_dim_codes<n, Ts>()...};
+
+	auto r = sizeof...(Ts);
+	for (auto k = size_t{0}; k != sizeof...(Ts); ++k) {
+		if (cs[k].values[d] == -1) continue;
+		if (cs[k].values[d] != 1) return k;
+		if (r == sizeof...(Ts)) r = k;
+	}
+	return r;
+}
+
+/*
+** The first operand that has all of the dimensions of the expression, which
+** provides its storage order.
+*/
+template <class... Ts>
+CC_ALWAYS_INLINE constexpr
+auto broadcast_full() noexcept
+{
+	constexpr auto n = broadcast_dims<Ts...>();
+	const size_t dims[] = {extents_type<Ts>::dims()...};
+
+	for (auto k = size_t{0}; k != sizeof...(Ts); ++k) {
+		if (dims[k] == n) return k;
+	}
+	return size_t{0};
+}
+
+template <size_t Dims, size_t Dim, class... Ts>
+struct broadcast_extent
+{
+	static constexpr auto source = broadcast_source<Ts...>(Dim);
+	using type = std::tuple_element_t<source, std::tuple<Ts...>>;
+	static constexpr auto coord = Dim - (Dims - extents_type<type>::dims());
+
+	template <class Tuple>
+	CC_ALWAYS_INLINE
+	static auto start(const Tuple& t) noexcept
+	{ return get<source>(t).extents().start_c(sc_coord<coord>); }
+
+	template <class Tuple>
+	CC_ALWAYS_INLINE
+	static auto finish(const Tuple& t) noexcept
+	{ return get<source>(t).extents().finish_c(sc_coord<coord>); }
+};
+
+/*
+** Reads the element of the operand `x` that corresponds to the coordinates
+** `cs` of the expression.
+*/
+template <size_t Dims, class T, class Coords, size_t... Ts>
+CC_ALWAYS_INLINE
+decltype(auto)
+broadcast_at(T& x, const Coords& cs, std::index_sequence<Ts...>) noexcept
+{
+	using range   = extents_type<T>;
+	using integer = std::decay_t<decltype(cs[0])>;
+	constexpr auto lead = Dims - sizeof...(Ts);
+
+	return x((static_length<range, Ts>::value == 1 ?
+		integer(x.extents().start(sc_coord<Ts>)) : cs[lead + Ts])...);
+}
+
+template <size_t Dims, class T, class Coords>
+CC_ALWAYS_INLINE
+decltype(auto) broadcast_at(T& x, const Coords& cs) noexcept
+{
+	using seq = std::make_index_sequence<extents_type<T>::dims()>;
+	return broadcast_at<Dims>(x, cs, seq{});
+}
+
+template <size_t Dims, class Range, class T, size_t... Ts>
+CC_ALWAYS_INLINE
+void check_broadcast(const Range& r, const T& x, std::index_sequence<Ts...>)
+noexcept
+{
+	using range = extents_type<T>;
+	constexpr auto lead = Dims - sizeof...(Ts);
+
+	const auto& e = x.extents();
+	const bool ok[] = {(
+		static_length<range, Ts>::value == 1 || (
+		e.start(sc_coord<Ts>) == r.start(sc_coord<lead + Ts>) &&
+		e.length(sc_coord<Ts>) == r.length(sc_coord<lead + Ts>))
+	)...};
+
+	for (const auto& b : ok) {
+		nd_assert(b, "extents cannot be broadcast.\n▶ $ ↛ $", e, r);
+	}
+}
+
 template <class T>
 struct remove_rvalue_reference
 { using type = T; };
@@ -79,6 +326,103 @@ using remove_rvalue_reference_t = typename remove_rvalue_reference<T>::type;
 
 struct elemwise_comp {};
 
+/*
+** Whitelist of the functions that can be applied to packets as well as to
+** scalars. Arbitrary user-supplied functions are not probed, since a generic
+** lambda with a deduced return type would cause a hard error if it turns out
+** that the body is ill-formed for packets.
+*/
+template <class Func>
+struct is_packet_function : std::false_type {};
+
+#define nd_define_packet_function(name) \
+	template <>                     \
+	struct is_packet_function<name> \
+	: std::true_type {};
+
+nd_define_packet_function(unary_plus)
+nd_define_packet_function(unary_minus)
+nd_define_packet_function(bit_not)
+nd_define_packet_function(plus)
+nd_define_packet_function(minus)
+nd_define_packet_function(multiplies)
+nd_define_packet_function(divides)
+nd_define_packet_function(modulus)
+nd_define_packet_function(bit_and)
+nd_define_packet_function(bit_or)
+nd_define_packet_function(bit_xor)
+nd_define_packet_function(left_shift)
+nd_define_packet_function(right_shift)
+
+#undef nd_define_packet_function
+
+/*
+** Binds a scalar to one of the operands of a binary function, so that
+** expressions like `a * 2` are evaluated without materializing an array of
+** constants. The bound functions are stored by value in the views, and the
+** scalar is broadcast to a packet in the loop body of each kernel, where the
+** compiler hoists it into a register.
+*/
+template <class Func, class S>
+struct bind_left final
+{
+	S value;
+
+	template <class U, nd_enable_if((!is_packet<U>::value))>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const U& u) const
+	nd_deduce_noexcept_and_return_type(Func{}(value, u))
+
+	template <class V, size_t Lanes>
+	CC_ALWAYS_INLINE
+	auto operator()(const packet<V, Lanes>& p) const
+	nd_deduce_noexcept_and_return_type(Func{}(
+		packet<V, Lanes>::broadcast(V(value)), p))
+};
+
+template <class Func, class S>
+struct bind_right final
+{
+	S value;
+
+	template <class U, nd_enable_if((!is_packet<U>::value))>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const U& u) const
+	nd_deduce_noexcept_and_return_type(Func{}(u, value))
+
+	template <class V, size_t Lanes>
+	CC_ALWAYS_INLINE
+	auto operator()(const packet<V, Lanes>& p) const
+	nd_deduce_noexcept_and_return_type(Func{}(
+		p, packet<V, Lanes>::broadcast(V(value))))
+};
+
+/*
+** Coordinates are converted to the element type of the array operand before
+** they are bound. Otherwise, the coordinates of `sc_coord`, which are unsigned,
+** would cause signed elements to be promoted to unsigned.
+*/
+template <class T>
+using coord_operand = std::decay_t<typename array_wrapper<T>::external_type>;
+
+template <class Func, class T, class Coord>
+CC_ALWAYS_INLINE constexpr
+auto bind_coord_left(const coord_wrapper<Coord>& c) noexcept
+{ return bind_left<Func, coord_operand<T>>{coord_operand<T>(c.value())}; }
+
+template <class Func, class T, class Coord>
+CC_ALWAYS_INLINE constexpr
+auto bind_coord_right(const coord_wrapper<Coord>& c) noexcept
+{ return bind_right<Func, coord_operand<T>>{coord_operand<T>(c.value())}; }
+
+template <class Func, class S>
+struct is_packet_function<bind_left<Func, S>>
+: is_packet_function<Func> {};
+
+template <class Func, class S>
+struct is_packet_function<bind_right<Func, S>>
+: is_packet_function<Func> {};
+
 template <class T>
 struct is_elemwise_comp_expr_helper
 : std::false_type {};
@@ -127,6 +471,37 @@ private:
 	static constexpr auto supported_by_underlying_type(...)
 	{ return false; }
 
+	/*
+	** The first parameter is checked before the trailing return type, so
+	** `Func` is never invoked on packets unless it is whitelisted.
+	*/
+	template <class... Us>
+	static constexpr auto supported_by_packet_type(std::enable_if_t<
+		detail::is_packet_function<Func>::value && sizeof...(Us) != 0
+	>*) ->
+	decltype(
+		std::declval<Func>()(
+			std::declval<typename decltype(
+				std::declval<Us>().packet_view())::packet_type>()...
+		),
+		bool{}
+	)
+	{
+		using packet = decltype(std::declval<Func>()(
+			std::declval<typename decltype(
+				std::declval<Us>().packet_view())::packet_type>()...
+		));
+		return std::is_same<
+			typename packet::value_type,
+			std::decay_t<std::result_of_t<
+				Func(typename std::decay_t<Us>::external_type...)>>
+		>::value;
+	}
+
+	template <class... Us>
+	static constexpr auto supported_by_packet_type(...)
+	{ return false; }
+
 	using extents_list = mpl::list<std::decay_t<decltype(std::declval<Ts>().extents())>...>;
 	using access_list  = mpl::transform<extents_list, mpl::quote<detail::allows_static_access>>;
 	using match        = mpl::find<mpl::true_, access_list>;
@@ -141,6 +516,10 @@ private:
 		mpl::is_same<match, mpl::no_match>,
 		mpl::list_index_c<0>, match
 	>;
+
+	static constexpr auto result_dims = detail::broadcast_dims<Ts...>();
+	static constexpr auto broadcasts  = detail::broadcasts<Ts...>();
+	static constexpr auto full        = detail::broadcast_full<Ts...>();
 public:
 	using external_type = std::decay_t<
 		std::result_of_t<Func(typename std::decay_t<Ts>::external_type...)>
@@ -173,15 +552,14 @@ private:
 	** As a workaround, I'm using a custom tuple implementation.
 	*/
 	tuple<Ts...> m_refs;
-	const Func& m_func;
+	Func m_func;
 public:
 	CC_ALWAYS_INLINE
 	explicit elemwise_view(const Func& f, Ts... ts)
 	noexcept : m_refs{ts...}, m_func{f}
 	{
 		#ifndef nd_no_debug
-			using helper = detail::check_extents_helper;
-			helper::apply(m_refs);
+			check_extents();
 		#endif
 	}
 
@@ -189,7 +567,7 @@ public:
 	auto memory_size() const noexcept
 	{ return size_type{}; }
 
-	template <class... Us>
+	template <class... Us, nd_enable_if((!broadcasts))>
 	CC_ALWAYS_INLINE
 	decltype(auto) at(const Us&... us) noexcept
 	{
@@ -200,7 +578,7 @@ public:
 		);
 	}
 
-	template <class... Us>
+	template <class... Us, nd_enable_if((!broadcasts))>
 	CC_ALWAYS_INLINE constexpr
 	decltype(auto) at(const Us&... us) const noexcept
 	{
@@ -211,7 +589,38 @@ public:
 		);
 	}
 
+	template <class... Us, nd_enable_if((broadcasts))>
+	CC_ALWAYS_INLINE
+	decltype(auto) at(const Us&... us) noexcept
+	{
+		using integer = std::common_type_t<Us...>;
+		const integer cs[] = {integer(us)...};
+
+		return expand(m_refs,
+			[&] (auto&... ts) CC_ALWAYS_INLINE noexcept {
+				return m_func(detail::broadcast_at<
+					result_dims>(ts, cs)...);
+			}
+		);
+	}
+
+	template <class... Us, nd_enable_if((broadcasts))>
+	CC_ALWAYS_INLINE
+	decltype(auto) at(const Us&... us) const noexcept
+	{
+		using integer = std::common_type_t<Us...>;
+		const integer cs[] = {integer(us)...};
+
+		return expand(m_refs,
+			[&] (const auto&... ts) CC_ALWAYS_INLINE noexcept {
+				return m_func(detail::broadcast_at<
+					result_dims>(ts, cs)...);
+			}
+		);
+	}
+
 	template <nd_enable_if((
+		!broadcasts &&
 		detail::storage_orders_same<Ts...> &&
 		mpl::and_c<std::decay_t<Ts>::provides_underlying_view...>::value &&
 		supported_by_underlying_type<Ts...>(0)
@@ -226,6 +635,7 @@ public:
 	}
 
 	template <nd_enable_if((
+		!broadcasts &&
 		detail::storage_orders_same<Ts...> &&
 		mpl::and_c<std::decay_t<Ts>::provides_underlying_view...>::value &&
 		supported_by_underlying_type<Ts...>(0)
@@ -240,6 +650,7 @@ public:
 	}
 
 	template <nd_enable_if((
+		!broadcasts &&
 		detail::storage_orders_same<Ts...> &&
 		mpl::and_c<std::decay_t<Ts>::provides_fast_flat_view...>::value
 	))>
@@ -253,6 +664,7 @@ public:
 	}
 
 	template <nd_enable_if((
+		!broadcasts &&
 		detail::storage_orders_same<Ts...> &&
 		mpl::and_c<std::decay_t<Ts>::provides_fast_flat_view...>::value
 	))>
@@ -265,13 +677,92 @@ public:
 			});
 	}
 
+	template <nd_enable_if((
+		!broadcasts &&
+		detail::storage_orders_same<Ts...> &&
+		mpl::and_c<std::decay_t<Ts>::provides_packet_view...>::value &&
+		supported_by_packet_type<Ts...>(0)
+	))>
+	CC_ALWAYS_INLINE
+	auto packet_view() const noexcept
+	{
+		return expand(m_refs,
+			[&] (const auto&... ts) CC_ALWAYS_INLINE noexcept {
+				return make_elemwise_packet_view(m_func,
+					ts.packet_view()...);
+			});
+	}
+
+	/*
+	** Since each argument only provides a fused view if the leaves beneath
+	** it share its storage order, checking the storage orders of the
+	** arguments suffices to ensure that all of the leaves of the expression
+	** agree.
+	*/
+	template <nd_enable_if((
+		!broadcasts &&
+		detail::storage_orders_same<Ts...> &&
+		mpl::and_c<std::decay_t<Ts>::provides_fused_view...>::value
+	))>
+	CC_ALWAYS_INLINE
+	auto fused_view() const noexcept
+	{
+		return expand(m_refs,
+			[&] (const auto&... ts) CC_ALWAYS_INLINE noexcept {
+				return make_fused_node(m_func, ts.fused_view()...);
+			});
+	}
+
 	CC_ALWAYS_INLINE constexpr
 	decltype(auto) storage_order() const noexcept
-	{ return get<0>(m_refs).storage_order(); }
+	{ return get<full>(m_refs).storage_order(); }
 
+	template <nd_enable_if((!broadcasts))>
 	CC_ALWAYS_INLINE
 	decltype(auto) extents() const noexcept
 	{ return get<index::value>(m_refs).extents(); }
+
+	/*
+	** Each coordinate is taken from the extents of the operand given by
+	** `detail::broadcast_source`, so the coordinates that are known at
+	** compile time remain so.
+	*/
+	template <nd_enable_if((broadcasts))>
+	CC_ALWAYS_INLINE
+	auto extents() const noexcept
+	{ return broadcast_extents(std::make_index_sequence<result_dims>{}); }
+private:
+	template <size_t... Ds>
+	CC_ALWAYS_INLINE
+	auto broadcast_extents(std::index_sequence<Ds...>) const noexcept
+	{
+		return make_range(
+			nd::index(detail::broadcast_extent<
+				result_dims, Ds, Ts...>::start(m_refs)...),
+			nd::index(detail::broadcast_extent<
+				result_dims, Ds, Ts...>::finish(m_refs)...)
+		);
+	}
+
+	template <nd_enable_if((!broadcasts))>
+	CC_ALWAYS_INLINE
+	void check_extents() const noexcept
+	{
+		using helper = detail::check_extents_helper;
+		helper::apply(m_refs);
+	}
+
+	template <nd_enable_if((broadcasts))>
+	CC_ALWAYS_INLINE
+	void check_extents() const noexcept
+	{
+		const auto e = extents();
+		nd::for_each(m_refs, [&] (const auto& x) CC_ALWAYS_INLINE noexcept {
+			using seq = std::make_index_sequence<
+				detail::extents_type<decltype(x)>::dims()>;
+			detail::check_broadcast<result_dims>(e, x, seq{});
+		});
+	}
 };
 
 template <class T>
@@ -455,7 +946,33 @@ nd_define_unary_expr(~, detail::bit_not)
 	template <class T, class U>                                                 \
 	CC_ALWAYS_INLINE constexpr                                                  \
 	auto operator symbol (const array_wrapper<T>& t, const array_wrapper<U>& u) \
-	noexcept { return zip_with(name{}, t, u); }
+	noexcept { return zip_with(name{}, t, u); }                                \
+                                                                                    \
+	template <class T, class S, nd_enable_if((std::is_arithmetic<S>::value))>   \
+	CC_ALWAYS_INLINE constexpr                                                  \
+	auto operator symbol (const array_wrapper<T>& t, const S s)                 \
+	noexcept { return zip_with(detail::bind_right<name, S>{s}, t); }            \
+                                                                                    \
+	template <class S, class T, nd_enable_if((std::is_arithmetic<S>::value))>   \
+	CC_ALWAYS_INLINE constexpr                                                  \
+	auto operator symbol (const S s, const array_wrapper<T>& t)                 \
+	noexcept { return zip_with(detail::bind_left<name, S>{s}, t); }             \
+                                                                                    \
+	template <class T, class Coord>                                             \
+	CC_ALWAYS_INLINE constexpr                                                  \
+	auto operator symbol (                                                      \
+		const array_wrapper<T>& t,                                          \
+		const coord_wrapper<Coord>& c                                       \
+	) noexcept                                                                  \
+	{ return zip_with(detail::bind_coord_right<name, T>(c), t); }              \
+                                                                                    \
+	template <class Coord, class T>                                             \
+	CC_ALWAYS_INLINE constexpr                                                  \
+	auto operator symbol (                                                      \
+		const coord_wrapper<Coord>& c,                                      \
+		const array_wrapper<T>& t                                           \
+	) noexcept                                                                  \
+	{ return zip_with(detail::bind_coord_left<name, T>(c), t); }
 
 // Arithmetic expressions.
 nd_define_binary_expr(+, detail::plus)
@@ -563,6 +1080,22 @@ struct fast_or_helper
 	const noexcept { return zip_with(detail::fast_or{}, t, u); }
 };
 
+struct fast_xor_helper
+{
+	template <class T, class U>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const array_wrapper<T>& t, const array_wrapper<U>& u)
+	const noexcept { return zip_with(detail::fast_xor{}, t, u); }
+};
+
+struct fast_andnot_helper
+{
+	template <class T, class U>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const array_wrapper<T>& t, const array_wrapper<U>& u)
+	const noexcept { return zip_with(detail::fast_andnot{}, t, u); }
+};
+
 struct fast_eq_helper
 {
 	/*
@@ -641,16 +1174,41 @@ CC_ALWAYS_INLINE constexpr
 auto fast_not(const array_wrapper<T>& t) noexcept
 { return zip_with(detail::fast_not{}, t); }
 
-static constexpr auto fast_and = make_named_operator(detail::fast_and_helper{});
-static constexpr auto fast_or  = make_named_operator(detail::fast_or_helper{});
-static constexpr auto fast_eq  = make_named_operator(detail::fast_eq_helper{});
-static constexpr auto fast_neq = make_named_operator(detail::fast_neq_helper{});
+static constexpr auto fast_and    = make_named_operator(detail::fast_and_helper{});
+static constexpr auto fast_or     = make_named_operator(detail::fast_or_helper{});
+static constexpr auto fast_xor    = make_named_operator(detail::fast_xor_helper{});
+static constexpr auto fast_andnot = make_named_operator(detail::fast_andnot_helper{});
+static constexpr auto fast_eq     = make_named_operator(detail::fast_eq_helper{});
+static constexpr auto fast_neq    = make_named_operator(detail::fast_neq_helper{});
+
+/*
+** Selects the elements of `x` where `m` is true, and those of `y` elsewhere.
+** If all three arrays are boolean arrays with the same storage order, the
+** selection is performed one word of packed booleans at a time.
+*/
+template <class M, class T, class U>
+CC_ALWAYS_INLINE constexpr
+auto where(
+	const array_wrapper<M>& m,
+	const array_wrapper<T>& x,
+	const array_wrapper<U>& y
+) noexcept { return zip_with(detail::fast_select{}, m, x, y); }
 
 #define nd_define_reflexive_op(symbol)                                              \
 	template <class T, class U>                                                 \
 	CC_ALWAYS_INLINE                                                            \
 	auto& operator symbol ## = (array_wrapper<T>& t, const array_wrapper<U>& u) \
-	noexcept { return t = t symbol u; }
+	noexcept { return t = t symbol u; }                                         \
+                                                                                    \
+	template <class T, class S, nd_enable_if((std::is_arithmetic<S>::value))>   \
+	CC_ALWAYS_INLINE                                                            \
+	auto& operator symbol ## = (array_wrapper<T>& t, const S s)                 \
+	noexcept { return t = t symbol s; }                                         \
+                                                                                    \
+	template <class T, class Coord>                                             \
+	CC_ALWAYS_INLINE                                                            \
+	auto& operator symbol ## = (array_wrapper<T>& t, const coord_wrapper<Coord>& c) \
+	noexcept { return t = t symbol c; }
 
 // Arithmetic operations.
 nd_define_reflexive_op(+)
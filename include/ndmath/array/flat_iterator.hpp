@@ -10,6 +10,11 @@
 ** Technical note: this header may be used by unwrapped array types, so we
 ** cannot assume that the typedefs and functions provided by `array_wrapper` are
 ** present.
+**
+** The position is stored using the `size_type` of the array, so that views over
+** arrays with more than 2^32 elements work when the array uses a 64-bit size
+** type. The access function is stored by value: the views are usually created
+** from temporary function objects, which would otherwise dangle.
 */
 
 #ifndef ZC7A16085_DE65_42E8_BBCD_804DD37DAF07
@@ -22,24 +27,24 @@ class flat_iterator final
 {
 	using size_type = typename T::size_type;
 public:
-	using difference_type   = size_type;
-	using reference         = std::result_of_t<AccessFunc(difference_type, T&)>;
-	using const_reference   = std::result_of_t<AccessFunc(difference_type, const T&)>;
+	using difference_type   = std::make_signed_t<size_type>;
+	using reference         = std::result_of_t<AccessFunc(size_type, T&)>;
+	using const_reference   = std::result_of_t<AccessFunc(size_type, const T&)>;
 	using value_type        = std::decay_t<reference>;
 	using pointer           = value_type*;
 	using const_pointer     = const value_type*;
 	using iterator_category = std::random_access_iterator_tag;
 private:
-	difference_type m_pos{};
+	size_type m_pos{};
 	T& m_ref;
-	const AccessFunc& m_func;
+	AccessFunc m_func;
 public:
 	CC_ALWAYS_INLINE constexpr
 	explicit flat_iterator(T& src, const AccessFunc& func)
 	noexcept : m_ref{src}, m_func{func} {}
 
 	CC_ALWAYS_INLINE constexpr
-	explicit flat_iterator(T& src, const difference_type size, const AccessFunc& func)
+	explicit flat_iterator(T& src, const size_type size, const AccessFunc& func)
 	noexcept : m_pos{size}, m_ref{src}, m_func{func} {}
 
 	CC_ALWAYS_INLINE constexpr
@@ -152,7 +157,7 @@ public:
 
 	CC_ALWAYS_INLINE constexpr auto
 	operator-(const flat_iterator& rhs)
-	const noexcept { return m_pos - rhs.m_pos; }
+	const noexcept { return difference_type(m_pos - rhs.m_pos); }
 };
 
 template <class T, class AccessFunc>
@@ -196,24 +201,24 @@ class construction_iterator final
 {
 	using size_type = typename T::size_type;
 public:
-	using difference_type   = size_type;
-	using reference         = std::result_of_t<AccessFunc(difference_type, T&)>;
+	using difference_type   = std::make_signed_t<size_type>;
+	using reference         = std::result_of_t<AccessFunc(size_type, T&)>;
 	using const_reference   = reference;
 	using value_type        = std::decay_t<reference>;
 	using pointer           = value_type*;
 	using const_pointer     = pointer;
 	using iterator_category = std::random_access_iterator_tag;
 private:
-	difference_type m_pos{};
+	size_type m_pos{};
 	T& m_ref;
-	const AccessFunc& m_func;
+	AccessFunc m_func;
 public:
 	CC_ALWAYS_INLINE constexpr
 	explicit construction_iterator(T& src, const AccessFunc& func)
 	noexcept : m_ref{src}, m_func{func} {}
 
 	CC_ALWAYS_INLINE constexpr
-	explicit construction_iterator(T& src, const difference_type size, const AccessFunc& func)
+	explicit construction_iterator(T& src, const size_type size, const AccessFunc& func)
 	noexcept : m_pos{size}, m_ref{src}, m_func{func} {}
 
 	CC_ALWAYS_INLINE constexpr
@@ -307,7 +312,7 @@ public:
 
 	CC_ALWAYS_INLINE constexpr auto
 	operator-(const construction_iterator& rhs)
-	const noexcept { return m_pos - rhs.m_pos; }
+	const noexcept { return difference_type(m_pos - rhs.m_pos); }
 };
 
 template <class T, class AccessFunc>
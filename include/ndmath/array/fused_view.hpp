@@ -0,0 +1,115 @@
+/*
+** File Name: fused_view.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** A fused view evaluates the element of an array at a given offset into its
+** storage using only raw pointers. The fused view of a dense array is a pointer
+** to its data, and the fused view of an `elemwise_view` applies its function to
+** the fused views of its arguments. So the fused view of a nested expression
+** such as `a * b + c` is a flat tuple of pointers to the leaves, together with
+** the functions that combine them. Assigning the expression to a dense array
+** then compiles to a single loop over the offsets, without any of the proxy
+** iterators used by the flat and underlying views.
+**
+** An `elemwise_view` only provides a fused view if all of its arguments do, and
+** if they all have the same storage order. By induction, all of the leaves of an
+** expression with a fused view have the same storage order, so that a given
+** offset refers to the same coordinates in each leaf.
+*/
+
+#ifndef Z8585EAF5_B7B3_431B_B8CE_5888176E0B73
+#define Z8585EAF5_B7B3_431B_B8CE_5888176E0B73
+
+#include <ndmath/utility/fusion.hpp>
+
+namespace nd {
+
+template <class T, class SizeType>
+class fused_leaf final
+{
+public:
+	using size_type = SizeType;
+private:
+	T* m_data;
+	size_type m_size;
+public:
+	CC_ALWAYS_INLINE constexpr
+	explicit fused_leaf(T* data, const size_type size)
+	noexcept : m_data{data}, m_size{size} {}
+
+	CC_ALWAYS_INLINE constexpr
+	auto data() const noexcept
+	{ return m_data; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto size() const noexcept
+	{ return m_size; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto& operator()(const size_type off) const noexcept
+	{ return m_data[off]; }
+};
+
+template <class T, class SizeType>
+CC_ALWAYS_INLINE constexpr
+auto make_fused_leaf(T* data, const SizeType size) noexcept
+{ return fused_leaf<T, SizeType>{data, size}; }
+
+template <class Func, class... Views>
+class fused_node final
+{
+public:
+	using size_type = std::common_type_t<typename Views::size_type...>;
+private:
+	tuple<Views...> m_views;
+	Func m_func;
+public:
+	CC_ALWAYS_INLINE constexpr
+	explicit fused_node(const Func& f, const Views&... views)
+	noexcept : m_views{views...}, m_func(f) {}
+
+	CC_ALWAYS_INLINE constexpr
+	auto size() const noexcept
+	{ return size_type(get<0>(m_views).size()); }
+
+	CC_ALWAYS_INLINE
+	auto operator()(const size_type off) const noexcept
+	{
+		return expand(m_views,
+			[&] (const auto&... vs) CC_ALWAYS_INLINE noexcept {
+				return m_func(vs(off)...);
+			});
+	}
+};
+
+template <class Func, class... Views>
+CC_ALWAYS_INLINE constexpr
+auto make_fused_node(const Func& f, const Views&... views) noexcept
+{ return fused_node<Func, Views...>{f, views...}; }
+
+namespace detail {
+
+/*
+** Evaluates the fused view `src` at each offset, and stores the result into the
+** storage referred to by the fused leaf `dst`. The destination may also be one
+** of the leaves of `src`, since each element is read before it is written.
+*/
+template <class Dst, class Src>
+CC_ALWAYS_INLINE
+void fused_copy(const Dst& dst, const Src& src) noexcept
+{
+	using size_type = typename Dst::size_type;
+
+	const auto p = dst.data();
+	const auto n = dst.size();
+
+	for (auto i = size_type{0}; i != n; ++i) {
+		p[i] = src(i);
+	}
+}
+
+}}
+
+#endif
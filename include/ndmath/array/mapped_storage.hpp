@@ -0,0 +1,569 @@
+/*
+** File Name: mapped_storage.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Dense storage whose elements live in a memory-mapped file, so that arrays
+** larger than physical memory can be used in expressions without first being
+** read into a buffer. The pages of the file are loaded by the kernel on demand.
+**
+** Each file begins with a small header that records the element type, the
+** extents, and the storage order of the array. The elements follow the header
+** at an offset that is a multiple of 64 bytes, in the same layout used by
+** `dense_storage` without row padding. All fields are stored in the byte order
+** of the machine that created the file. The same format is read and written by
+** `load_array` and `save_array` (see `io/array_file.hpp`).
+**
+** - `create_mapped<T>(path, extents, order)` creates (or truncates) the file
+**   and maps it for reading and writing. The elements are zero-initialized.
+** - `open_mapped<T, Dims>(path, mode, order)` maps an existing file. The
+**   element type, number of dimensions, and storage order in the header must
+**   match those requested. The mode is one of:
+**   - `map_mode::read_only`: writing to the array is undefined behavior.
+**   - `map_mode::read_write`: changes are written back to the file.
+**   - `map_mode::copy_on_write`: changes are private to the mapping, and the
+**     file is left unmodified.
+**
+** `advise` passes an access pattern hint for the entire mapping to `madvise`,
+** and `flush` writes modified pages back to the file. Both are members of the
+** wrapped type, so they are accessed using `arr.wrapped()`.
+**
+** Errors reported by the operating system are thrown as `std::system_error`,
+** and malformed or mismatching headers as `std::runtime_error`.
+*/
+
+#ifndef ZA0CD789A_6305_402C_8AEB_63DE8473D95F
+#define ZA0CD789A_6305_402C_8AEB_63DE8473D95F
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <ndmath/array/dense_storage.hpp>
+
+namespace nd {
+
+enum class map_mode
+{
+	read_only,
+	read_write,
+	copy_on_write
+};
+
+enum class access_hint
+{
+	normal,
+	sequential,
+	random,
+	will_need,
+	dont_need
+};
+
+namespace detail {
+
+static constexpr char mapped_magic[8] = {'N', 'D', 'M', 'A', 'T', 'H', 'M', 'M'};
+static constexpr auto mapped_version = uint32_t{1};
+static constexpr auto mapped_alignment = size_t{64};
+
+/*
+** Followed by the extents of the array as `uint64_t` values, and then the
+** storage order as `uint32_t` values.
+*/
+struct mapped_header
+{
+	char     magic[8];
+	uint32_t version;
+	uint32_t type_code;
+	uint32_t dims;
+	uint32_t byte_order;
+	uint64_t data_offset;
+};
+
+/*
+** Identifies the element type of the array by its kind and the size of the
+** underlying type.
+*/
+template <class T>
+CC_ALWAYS_INLINE constexpr
+auto mapped_type_code() noexcept
+{
+	static_assert(
+		std::is_arithmetic<T>::value,
+		"Only arrays of arithmetic types can be memory-mapped."
+	);
+
+	const auto kind =
+		std::is_same<T, bool>::value      ? uint32_t{1} :
+		std::is_floating_point<T>::value  ? uint32_t{4} :
+		std::is_signed<T>::value          ? uint32_t{2} : uint32_t{3};
+	return kind << 16 | uint32_t(sizeof(underlying_type<T>));
+}
+
+CC_ALWAYS_INLINE constexpr
+auto mapped_data_offset(const size_t dims) noexcept
+{
+	const auto n = sizeof(mapped_header) + dims * (sizeof(uint64_t) +
+		sizeof(uint32_t));
+	return (n + mapped_alignment - 1) / mapped_alignment * mapped_alignment;
+}
+
+[[noreturn]] inline
+void throw_system_error(const std::string& what)
+{ throw std::system_error{errno, std::generic_category(), what}; }
+
+/*
+** Closes the file descriptor when it goes out of scope, including when an
+** exception is thrown.
+*/
+class file_descriptor final
+{
+	int m_fd;
+public:
+	CC_ALWAYS_INLINE
+	explicit file_descriptor(const std::string& path, const int flags)
+	: m_fd{::open(path.c_str(), flags, 0644)}
+	{
+		if (m_fd == -1) {
+			throw_system_error("failed to open \"" + path + "\"");
+		}
+	}
+
+	/*
+	** Takes ownership of a file descriptor that has already been opened.
+	*/
+	CC_ALWAYS_INLINE
+	explicit file_descriptor(const int fd) noexcept : m_fd{fd} {}
+
+	CC_ALWAYS_INLINE
+	file_descriptor(file_descriptor&& rhs) noexcept : m_fd{rhs.m_fd}
+	{ rhs.m_fd = -1; }
+
+	CC_ALWAYS_INLINE
+	~file_descriptor()
+	{
+		if (m_fd != -1) {
+			::close(m_fd);
+		}
+	}
+
+	file_descriptor(const file_descriptor&) = delete;
+	auto& operator=(const file_descriptor&) = delete;
+
+	CC_ALWAYS_INLINE
+	auto get() const noexcept
+	{ return m_fd; }
+};
+
+template <class Extents, size_t... Ks>
+CC_ALWAYS_INLINE
+auto mapped_lengths(const Extents& e, std::index_sequence<Ks...>) noexcept
+{
+	return std::array<uint64_t, sizeof...(Ks)>{{
+		uint64_t(e.length(sc_coord<Ks>))...}};
+}
+
+template <size_t... Ks>
+CC_ALWAYS_INLINE
+auto runtime_extents(const uint64_t* lens, std::index_sequence<Ks...>) noexcept
+{ return nd::extents(unsigned(lens[Ks])...); }
+
+template <class Order, size_t... Ks>
+CC_ALWAYS_INLINE constexpr
+auto order_values(std::index_sequence<Ks...> seq) noexcept
+{
+	return std::array<uint32_t, sizeof...(Ks)>{{
+		uint32_t(order_value<Order>(Ks, seq))...}};
+}
+
+/*
+** Writes the header for an array with the given element type, extents, and
+** storage order to the first `mapped_data_offset(dims)` bytes of `p`.
+*/
+template <class T, class StorageOrder, class Extents>
+CC_ALWAYS_INLINE
+void write_mapped_header(char* p, const Extents& e) noexcept
+{
+	constexpr auto dims = Extents::dims();
+	using seq = std::make_index_sequence<dims>;
+
+	auto h = mapped_header{};
+	std::memcpy(h.magic, mapped_magic, sizeof(h.magic));
+	h.version     = mapped_version;
+	h.type_code   = mapped_type_code<T>();
+	h.dims        = uint32_t(dims);
+	h.byte_order  = uint32_t{0x01020304};
+	h.data_offset = mapped_data_offset(dims);
+
+	const auto lens = mapped_lengths(e, seq{});
+	const auto order = order_values<StorageOrder>(seq{});
+
+	std::memset(p, 0, mapped_data_offset(dims));
+	std::memcpy(p, &h, sizeof(h));
+	p += sizeof(h);
+	std::memcpy(p, lens.data(), sizeof(uint64_t) * dims);
+	p += sizeof(uint64_t) * dims;
+	std::memcpy(p, order.data(), sizeof(uint32_t) * dims);
+}
+
+/*
+** Checks that the header in the first `mapped_data_offset(Dims)` bytes of `p`
+** was written for an array with the given element type, number of dimensions,
+** and storage order, and returns the extents recorded in it.
+*/
+template <class T, class StorageOrder, size_t Dims>
+CC_ALWAYS_INLINE
+auto read_mapped_header(const char* p, const std::string& path)
+{
+	using seq = std::make_index_sequence<Dims>;
+
+	auto h = mapped_header{};
+	uint64_t lens[Dims];
+	uint32_t order[Dims];
+	std::memcpy(&h, p, sizeof(h));
+	std::memcpy(lens, p + sizeof(h), sizeof(lens));
+	std::memcpy(order, p + sizeof(h) + sizeof(lens), sizeof(order));
+
+	const auto expected = order_values<StorageOrder>(seq{});
+	if (
+		std::memcmp(h.magic, mapped_magic, sizeof(h.magic)) ||
+		h.version     != mapped_version                      ||
+		h.byte_order  != uint32_t{0x01020304}                ||
+		h.data_offset != mapped_data_offset(Dims)
+	) {
+		throw std::runtime_error{"\"" + path + "\" is not an "
+			"array file created on this platform"};
+	}
+	if (
+		h.type_code != mapped_type_code<T>() ||
+		h.dims != Dims                       ||
+		!std::equal(order, order + Dims, expected.begin())
+	) {
+		throw std::runtime_error{"element type, number of "
+			"dimensions, or storage order of \"" + path +
+			"\" does not match that of the array"};
+	}
+	return runtime_extents(lens, seq{});
+}
+
+}
+
+template <class T, class Extents, class StorageOrder>
+class mapped_storage final : layout_base<Extents, StorageOrder>
+{
+public:
+	CC_ALWAYS_INLINE constexpr
+	static auto dims() noexcept
+	{ return Extents::dims(); }
+private:
+	using base   = layout_base<Extents, StorageOrder>;
+	using helper = detail::dense_storage_access<T>;
+	using seq    = std::make_index_sequence<dims()>;
+
+	friend struct detail::dense_storage_access<T>;
+public:
+	using external_type   = T;
+	using value_type      = std::decay_t<T>;
+	using underlying_type = typename helper::underlying_type;
+	using size_type       = size_t;
+	static constexpr auto is_lazy = false;
+
+	/*
+	** The mapping starts on a page boundary, and the elements start at a
+	** multiple of `mapped_alignment` from the beginning of the file.
+	*/
+	static constexpr auto alignment = detail::mapped_alignment;
+
+	using base::extents;
+	using base::storage_order;
+private:
+	void* m_map{nullptr};
+	size_t m_length{0};
+	underlying_type* m_data{nullptr};
+	map_mode m_mode{map_mode::read_only};
+public:
+	CC_ALWAYS_INLINE
+	explicit mapped_storage() noexcept {}
+
+	/*
+	** Creates the file at `path`, or truncates it if it already exists.
+	*/
+	CC_ALWAYS_INLINE
+	explicit mapped_storage(const std::string& path, const Extents& e) :
+	base{e}, m_mode{map_mode::read_write}
+	{
+		const auto off = detail::mapped_data_offset(dims());
+		const auto n = helper::underlying_size(
+			detail::extents_size<size_type>(e));
+		const auto len = off + sizeof(underlying_type) * n;
+		const detail::file_descriptor fd{path, O_RDWR | O_CREAT | O_TRUNC};
+
+		if (::ftruncate(fd.get(), off_t(len)) == -1) {
+			detail::throw_system_error("failed to resize \"" + path + "\"");
+		}
+		map(fd.get(), path, off, n);
+
+		detail::write_mapped_header<T, StorageOrder>(
+			static_cast<char*>(m_map), e);
+	}
+
+	/*
+	** Maps an existing file. The extents are read from the header.
+	*/
+	CC_ALWAYS_INLINE
+	explicit mapped_storage(const std::string& path, const map_mode mode) :
+	m_mode{mode}
+	{
+		using detail::throw_system_error;
+
+		constexpr auto off = detail::mapped_data_offset(dims());
+		const auto flags = mode == map_mode::read_write ? O_RDWR : O_RDONLY;
+		const detail::file_descriptor fd{path, flags};
+
+		struct ::stat st;
+		if (::fstat(fd.get(), &st) == -1) {
+			throw_system_error("failed to stat \"" + path + "\"");
+		}
+		if (size_t(st.st_size) < off) {
+			throw std::runtime_error{"\"" + path + "\" is too small "
+				"to be a mapped array"};
+		}
+
+		char buf[off];
+		if (::pread(fd.get(), buf, off, 0) != ssize_t(off)) {
+			throw_system_error("failed to read header of \"" + path + "\"");
+		}
+
+		extents(detail::read_mapped_header<T, StorageOrder, dims()>(
+			buf, path));
+		const auto n = helper::underlying_size(
+			detail::extents_size<size_type>(extents()));
+
+		if (size_t(st.st_size) < off + sizeof(underlying_type) * n) {
+			throw std::runtime_error{"\"" + path + "\" is smaller "
+				"than the size recorded in its header"};
+		}
+		map(fd.get(), path, off, n);
+	}
+
+	CC_ALWAYS_INLINE
+	mapped_storage(mapped_storage&& rhs) noexcept :
+	base{rhs.extents()}, m_map{rhs.m_map}, m_length{rhs.m_length},
+	m_data{rhs.m_data}, m_mode{rhs.m_mode}
+	{
+		rhs.m_map = nullptr;
+		rhs.m_data = nullptr;
+	}
+
+	CC_ALWAYS_INLINE
+	~mapped_storage()
+	{
+		if (m_map != nullptr) {
+			::munmap(m_map, m_length);
+		}
+	}
+
+	mapped_storage(const mapped_storage&) = delete;
+	auto& operator=(const mapped_storage&) = delete;
+	auto& operator=(mapped_storage&&) = delete;
+
+	CC_ALWAYS_INLINE
+	auto mode() const noexcept
+	{ return m_mode; }
+
+	CC_ALWAYS_INLINE
+	void advise(const access_hint h) const
+	{
+		const int advice[] = {MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM,
+			MADV_WILLNEED, MADV_DONTNEED};
+		if (::madvise(m_map, m_length, advice[int(h)]) == -1) {
+			detail::throw_system_error("madvise failed");
+		}
+	}
+
+	/*
+	** Blocks until the modified pages have been written to the file. This
+	** has no effect unless the mode is `map_mode::read_write`.
+	*/
+	CC_ALWAYS_INLINE
+	void flush() const
+	{
+		if (m_mode != map_mode::read_write) return;
+		if (::msync(m_map, m_length, MS_SYNC) == -1) {
+			detail::throw_system_error("msync failed");
+		}
+	}
+
+	CC_ALWAYS_INLINE constexpr
+	auto memory_size() const noexcept
+	{ return sizeof(underlying_type) * underlying_size(); }
+
+	template <class... Ts>
+	CC_ALWAYS_INLINE
+	decltype(auto) at(const Ts... ts) noexcept
+	{ return helper::at(coords_to_offset::apply(*this, ts...), *this); }
+
+	template <class... Ts>
+	CC_ALWAYS_INLINE
+	decltype(auto) at(const Ts... ts) const noexcept
+	{ return helper::at(coords_to_offset::apply(*this, ts...), *this); }
+
+	CC_ALWAYS_INLINE
+	auto flat_view() noexcept
+	{
+		auto func = [&](const auto off, auto& arr) CC_ALWAYS_INLINE
+		nd_deduce_noexcept_and_return_type(helper::at(off, arr));
+
+		return make_flat_view(*this, size(), func);
+	}
+
+	CC_ALWAYS_INLINE
+	auto flat_view() const noexcept
+	{
+		auto func = [&](const auto off, const auto& arr) CC_ALWAYS_INLINE
+		nd_deduce_noexcept_and_return_type(helper::at(off, arr));
+
+		return make_flat_view(*this, size(), func);
+	}
+
+	CC_ALWAYS_INLINE
+	auto underlying_view() noexcept
+	{ return boost::make_iterator_range(m_data, m_data + underlying_size()); }
+
+	CC_ALWAYS_INLINE
+	auto underlying_view() const noexcept
+	{ return boost::make_iterator_range(m_data, m_data + underlying_size()); }
+
+	template <nd_enable_if((detail::is_packable<T>))>
+	CC_ALWAYS_INLINE
+	auto packet_view() noexcept
+	{
+		constexpr auto aligned = detail::is_packet_aligned<T, alignment>;
+		return make_packet_view<aligned>(data(), size());
+	}
+
+	template <nd_enable_if((detail::is_packable<T>))>
+	CC_ALWAYS_INLINE
+	auto packet_view() const noexcept
+	{
+		constexpr auto aligned = detail::is_packet_aligned<T, alignment>;
+		return make_packet_view<aligned>(data(), size());
+	}
+
+	template <nd_enable_if((std::is_same<T, underlying_type>::value))>
+	CC_ALWAYS_INLINE
+	auto fused_view() noexcept
+	{ return make_fused_leaf(data(), size()); }
+
+	template <nd_enable_if((std::is_same<T, underlying_type>::value))>
+	CC_ALWAYS_INLINE
+	auto fused_view() const noexcept
+	{ return make_fused_leaf(data(), size()); }
+private:
+	CC_ALWAYS_INLINE
+	void map(const int fd, const std::string& path, const size_t off,
+		const size_t n)
+	{
+		const auto prot = m_mode == map_mode::read_only ?
+			PROT_READ : PROT_READ | PROT_WRITE;
+		const auto flags = m_mode == map_mode::copy_on_write ?
+			MAP_PRIVATE : MAP_SHARED;
+
+		m_length = off + sizeof(underlying_type) * n;
+		m_map = ::mmap(nullptr, m_length, prot, flags, fd, 0);
+
+		if (m_map == MAP_FAILED) {
+			m_map = nullptr;
+			detail::throw_system_error("failed to map \"" + path + "\"");
+		}
+		m_data = reinterpret_cast<underlying_type*>(
+			static_cast<char*>(m_map) + off);
+	}
+
+	CC_ALWAYS_INLINE
+	auto data() noexcept
+	{ return m_data; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto data() const noexcept
+	{ return m_data; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto size() const noexcept
+	{ return detail::extents_size<size_type>(extents()); }
+
+	CC_ALWAYS_INLINE constexpr
+	auto underlying_size() const noexcept
+	{ return helper::underlying_size(size()); }
+};
+
+namespace detail {
+
+template <size_t Dims>
+using mapped_extents = std::decay_t<decltype(runtime_extents(
+	std::declval<const uint64_t*>(), std::make_index_sequence<Dims>{}))>;
+
+template <class Extents, size_t... Ks>
+CC_ALWAYS_INLINE
+auto to_mapped_extents(const Extents& e, std::index_sequence<Ks...>) noexcept
+{ return nd::extents(unsigned(e.length(sc_coord<Ks>))...); }
+
+}
+
+template <
+	class T,
+	class Extents,
+	class StorageOrder = std::decay_t<decltype(default_storage_order<Extents::dims()>)>,
+	nd_enable_if((
+		mpl::is_specialization_of<range, Extents>::value &&
+		mpl::is_specialization_of<index_wrapper, StorageOrder>::value
+	))
+>
+CC_ALWAYS_INLINE
+auto create_mapped(
+	const std::string& path,
+	const Extents& e,
+	StorageOrder = default_storage_order<Extents::dims()>
+)
+{
+	constexpr auto dims = Extents::dims();
+	using extents_type = detail::mapped_extents<dims>;
+	using storage_type = mapped_storage<T, extents_type, StorageOrder>;
+	using array_type   = array_wrapper<storage_type>;
+
+	return array_type{path, detail::to_mapped_extents(e,
+		std::make_index_sequence<dims>{})};
+}
+
+template <
+	class T,
+	size_t Dims,
+	class StorageOrder = std::decay_t<decltype(default_storage_order<Dims>)>,
+	nd_enable_if((
+		mpl::is_specialization_of<index_wrapper, StorageOrder>::value
+	))
+>
+CC_ALWAYS_INLINE
+auto open_mapped(
+	const std::string& path,
+	const map_mode mode = map_mode::read_only,
+	StorageOrder = default_storage_order<Dims>
+)
+{
+	using extents_type = detail::mapped_extents<Dims>;
+	using storage_type = mapped_storage<T, extents_type, StorageOrder>;
+	using array_type   = array_wrapper<storage_type>;
+	return array_type{path, mode};
+}
+
+}
+
+#endif
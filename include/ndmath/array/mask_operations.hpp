@@ -0,0 +1,229 @@
+/*
+** File Name: mask_operations.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Operations that use boolean arrays to locate and filter elements. Positions
+** are offsets into the flat view, so the mask and the arrays it is applied to
+** must have the same extents and storage order.
+**
+** - `find_first(m)` returns the offset of the first true element of `m`, and
+**   `find_next(m, pos)` returns the offset of the first true element after
+**   `pos`. Both return `m.size()` if there is no such element.
+** - `for_each_set(m, f)` invokes `f(off)` for the offset of each true element
+**   of `m`, in increasing order.
+** - `compress(arr, m, out)` writes the elements of `arr` at which `m` is true
+**   to the output iterator `out`, and returns the iterator past the last
+**   element written. The number of elements written is `count(m)`.
+** - `expand(first, m, arr)` is the inverse of `compress`: the elements read
+**   from the input iterator `first` are written to the positions of `arr` at
+**   which `m` is true, and the iterator past the last element read is
+**   returned. The other elements of `arr` are left unchanged.
+**
+** If the underlying view of `m` consists of words of packed booleans (see
+** `reduction.hpp`), each word is scanned using count-trailing-zeros, so words
+** without any true elements are skipped at once.
+*/
+
+#ifndef Z6D1C3B8E_4F0A_4E5B_9A27_C81F5D3E2B96
+#define Z6D1C3B8E_4F0A_4E5B_9A27_C81F5D3E2B96
+
+#include <ndmath/array/reduction.hpp>
+
+namespace nd {
+namespace detail {
+
+template <class T>
+CC_ALWAYS_INLINE constexpr
+auto count_trailing_zeros(const T x) noexcept
+{ return size_t(__builtin_ctzll((unsigned long long)x)); }
+
+template <bool UsesPackedBooleans>
+struct mask_scan_helper;
+
+template <>
+struct mask_scan_helper<true>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static auto find_from(const array_wrapper<T>& m, const size_t start)
+	noexcept
+	{
+		using size_type = typename array_wrapper<T>::size_type;
+		using word_type = std::decay_t<decltype(
+			(*m.underlying_view().begin()).value())>;
+		constexpr auto bits = size_t(8 * sizeof(word_type));
+
+		const auto n = size_t(m.size());
+		if (start >= n) return size_type(n);
+
+		const auto words = (n + bits - 1) / bits;
+		auto i = start / bits;
+		auto it = m.underlying_view().begin() + i;
+		auto w = word_type((*it).value() &
+			(~word_type{0} << (start % bits)));
+
+		for (;;) {
+			if (w != 0) {
+				// The bits of the last word past the end of the
+				// array need not be zero.
+				return size_type(std::min(
+					i * bits + count_trailing_zeros(w), n));
+			}
+			if (++i == words) return size_type(n);
+			w = (*++it).value();
+		}
+	}
+
+	template <class T, class Func>
+	CC_ALWAYS_INLINE
+	static void for_each_set(const array_wrapper<T>& m, const Func& f)
+	{
+		using size_type = typename array_wrapper<T>::size_type;
+		using word_type = std::decay_t<decltype(
+			(*m.underlying_view().begin()).value())>;
+
+		const auto w = logical_reduction_helper<true>::words(m);
+		constexpr auto bits = size_t(8 * sizeof(word_type));
+		auto it = m.underlying_view().begin();
+
+		const auto visit = [&] (const size_t base, word_type x)
+			CC_ALWAYS_INLINE {
+				while (x != 0) {
+					f(size_type(base + count_trailing_zeros(x)));
+					x &= x - 1;
+				}
+			};
+
+		for (auto i = size_t{0}; i != std::get<0>(w); ++i, ++it) {
+			visit(i * bits, (*it).value());
+		}
+		if (std::get<1>(w) != 0) {
+			visit(std::get<0>(w) * bits,
+				word_type((*it).value() & std::get<2>(w)));
+		}
+	}
+};
+
+template <>
+struct mask_scan_helper<false>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static auto find_from(const array_wrapper<T>& m, const size_t start)
+	noexcept
+	{
+		using size_type = typename array_wrapper<T>::size_type;
+
+		const auto n = size_t(m.size());
+		if (start >= n) return size_type(n);
+
+		// Only the first position is located using the offset, since
+		// random access may be expensive for the flat view.
+		auto it = m.flat_view().begin();
+		it += start;
+
+		for (auto i = start; i != n; ++i, ++it) {
+			if (bool(*it)) return size_type(i);
+		}
+		return size_type(n);
+	}
+
+	template <class T, class Func>
+	CC_ALWAYS_INLINE
+	static void for_each_set(const array_wrapper<T>& m, const Func& f)
+	{
+		using size_type = typename array_wrapper<T>::size_type;
+
+		auto i = size_type{0};
+		for (const auto& x : m.flat_view()) {
+			if (bool(x)) f(i);
+			++i;
+		}
+	}
+};
+
+template <class T>
+using mask_scan = mask_scan_helper<
+	array_wrapper<T>::provides_underlying_view &&
+	is_boolean_storage<typename array_wrapper<T>::underlying_type>::value
+>;
+
+template <class T, class U>
+CC_ALWAYS_INLINE
+void check_mask(const array_wrapper<T>& arr, const array_wrapper<U>& m)
+noexcept
+{
+	static_assert(
+		storage_orders_same<const array_wrapper<T>&,
+			const array_wrapper<U>&>,
+		"Array and mask must have the same storage order."
+	);
+
+	nd_assert(
+		arr.extents() == m.extents(),
+		"mismatching extents.\n▶ $ ≠ $",
+		arr.extents(), m.extents()
+	);
+}
+
+}
+
+template <class T>
+CC_ALWAYS_INLINE
+auto find_first(const array_wrapper<T>& m) noexcept
+{ return detail::mask_scan<T>::find_from(m, 0); }
+
+template <class T>
+CC_ALWAYS_INLINE
+auto find_next(
+	const array_wrapper<T>& m,
+	const typename array_wrapper<T>::size_type pos
+) noexcept
+{ return detail::mask_scan<T>::find_from(m, size_t(pos) + 1); }
+
+template <class T, class Func>
+CC_ALWAYS_INLINE
+void for_each_set(const array_wrapper<T>& m, const Func& f)
+{ detail::mask_scan<T>::for_each_set(m, f); }
+
+template <class T, class U, class OutputIterator>
+CC_ALWAYS_INLINE
+auto compress(
+	const array_wrapper<T>& arr,
+	const array_wrapper<U>& m,
+	OutputIterator out
+)
+{
+	detail::check_mask(arr, m);
+
+	const auto src = arr.flat_view().begin();
+	for_each_set(m, [&] (const auto off) CC_ALWAYS_INLINE {
+		*out = src[off];
+		++out;
+	});
+	return out;
+}
+
+template <class InputIterator, class U, class T>
+CC_ALWAYS_INLINE
+auto expand(
+	InputIterator first,
+	const array_wrapper<U>& m,
+	array_wrapper<T>& arr
+)
+{
+	detail::check_mask(arr, m);
+
+	auto dst = arr.flat_view().begin();
+	for_each_set(m, [&] (const auto off) CC_ALWAYS_INLINE {
+		dst[off] = *first;
+		++first;
+	});
+	return first;
+}
+
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*
+** File Name: permuted_copy.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Copies the elements of one contiguous array to another with the same extents
+** but a different storage order. Traversing the source in the order of the
+** destination (or vice versa) touches a new cache line for nearly every element
+** once the arrays are larger than the cache. Instead, let `a` be the dimension
+** that varies fastest in the destination, and `b` the dimension that varies
+** fastest in the source. For each combination of the remaining coordinates,
+** the plane spanned by `a` and `b` is transposed one square tile at a time, so
+** that the cache lines of both arrays that belong to a tile are reused before
+** they are evicted. Within each tile, square blocks of packets are transposed
+** in registers (see `simd/transpose.hpp`).
+*/
+
+#ifndef Z97988C2D_7A5D_4747_9348_D9E137293A4A
+#define Z97988C2D_7A5D_4747_9348_D9E137293A4A
+
+#include <algorithm>
+#include <ndmath/simd/transpose.hpp>
+
+namespace nd {
+namespace detail {
+
+/*
+** The length of each side of the tiles, in elements. A pair of 32 x 32 tiles
+** of doubles occupies 16 KB, which fits comfortably in L1.
+*/
+static constexpr auto permuted_copy_tile = size_t{32};
+
+template <bool UsePackets>
+struct transpose_tile_helper
+{
+	/*
+	** Sets `dst[r * ldd + c] = src[c * lds + r]` for `r` in `[r0, r1)` and
+	** `c` in `[c0, c1)`.
+	*/
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(T* dst, const size_t ldd, const T* src,
+		const size_t lds, const size_t r0, const size_t r1,
+		const size_t c0, const size_t c1) noexcept
+	{
+		for (auto r = r0; r != r1; ++r) {
+			for (auto c = c0; c != c1; ++c) {
+				dst[r * ldd + c] = src[c * lds + r];
+			}
+		}
+	}
+};
+
+template <>
+struct transpose_tile_helper<true>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(T* dst, const size_t ldd, const T* src,
+		const size_t lds, const size_t r0, const size_t r1,
+		const size_t c0, const size_t c1) noexcept
+	{
+		using scalar = transpose_tile_helper<false>;
+		using packet_type = packet<T>;
+		constexpr auto lanes = packet_type::lanes;
+
+		const auto rf = r0 + (r1 - r0) / lanes * lanes;
+		const auto cf = c0 + (c1 - c0) / lanes * lanes;
+		packet_type p[lanes];
+
+		for (auto r = r0; r != rf; r += lanes) {
+			for (auto c = c0; c != cf; c += lanes) {
+				for (auto k = size_t{0}; k != lanes; ++k) {
+					p[k] = packet_type::load(src + (c + k) * lds + r);
+				}
+				transpose_packets(p);
+				for (auto k = size_t{0}; k != lanes; ++k) {
+					p[k].store(dst + (r + k) * ldd + c);
+				}
+			}
+		}
+		scalar::apply(dst, ldd, src, lds, r0, rf, cf, c1);
+		scalar::apply(dst, ldd, src, lds, rf, r1, c0, c1);
+	}
+};
+
+/*
+** Sets `dst[r * ldd + c] = src[c * lds + r]` for all `r < rows` and `c <
+** cols`.
+*/
+template <class T>
+CC_ALWAYS_INLINE
+void blocked_transpose(T* dst, const size_t ldd, const T* src,
+	const size_t lds, const size_t rows, const size_t cols) noexcept
+{
+	constexpr auto use_packets = is_packable<T> && packet<T>::lanes > 1;
+	constexpr auto tile = use_packets ?
+		std::max(permuted_copy_tile, packet<T>::lanes) : permuted_copy_tile;
+
+	using helper = transpose_tile_helper<use_packets>;
+
+	for (auto r = size_t{0}; r < rows; r += tile) {
+		const auto r1 = std::min(r + tile, rows);
+		for (auto c = size_t{0}; c < cols; c += tile) {
+			const auto c1 = std::min(c + tile, cols);
+			helper::apply(dst, ldd, src, lds, r, r1, c, c1);
+		}
+	}
+}
+
+/*
+** Computes the distance in memory between consecutive elements along each
+** dimension of a contiguous array, given its storage order.
+*/
+template <class Array, size_t... Ks>
+CC_ALWAYS_INLINE
+void contiguous_strides(const Array& arr, const size_t* lens, unsigned* order,
+	size_t* strides, std::index_sequence<Ks...>) noexcept
+{
+	using order_type = std::decay_t<decltype(arr.storage_order())>;
+	constexpr unsigned values[] = {unsigned(std::decay_t<decltype(
+		std::declval<order_type>().at_c(sc_coord<Ks>))>::value())...};
+	constexpr auto dims = sizeof...(Ks);
+
+	auto s = size_t{1};
+	for (auto k = dims; k != 0; --k) {
+		order[k - 1] = values[k - 1];
+		strides[values[k - 1]] = s;
+		s *= lens[values[k - 1]];
+	}
+}
+
+template <class T, class U, size_t... Ks>
+CC_ALWAYS_INLINE
+void permuted_copy(array_wrapper<T>& dst, const array_wrapper<U>& src,
+	std::index_sequence<Ks...> seq) noexcept
+{
+	constexpr auto dims = sizeof...(Ks);
+	const auto e = dst.extents();
+	const size_t lens[] = {size_t(e.length(sc_coord<Ks>))...};
+
+	unsigned dst_order[dims];
+	unsigned src_order[dims];
+	size_t ds[dims];
+	size_t ss[dims];
+	contiguous_strides(dst, lens, dst_order, ds, seq);
+	contiguous_strides(src, lens, src_order, ss, seq);
+
+	const auto a = dst_order[dims - 1];
+	const auto b = src_order[dims - 1];
+	const auto p = dst.underlying_view().begin();
+	const auto q = src.underlying_view().begin();
+
+	/*
+	** The remaining dimensions are visited in the storage order of the
+	** destination, so that it is written sequentially.
+	*/
+	unsigned outer[dims];
+	auto m = size_t{0};
+	for (auto k = size_t{0}; k != dims; ++k) {
+		if (dst_order[k] != a && dst_order[k] != b) {
+			outer[m++] = dst_order[k];
+		}
+	}
+
+	size_t cs[dims] = {};
+	for (;;) {
+		auto doff = size_t{0};
+		auto soff = size_t{0};
+		for (auto j = size_t{0}; j != m; ++j) {
+			doff += cs[j] * ds[outer[j]];
+			soff += cs[j] * ss[outer[j]];
+		}
+
+		if (a == b) {
+			std::copy_n(q + soff, lens[a], p + doff);
+		}
+		else {
+			blocked_transpose(p + doff, ds[b], q + soff, ss[a],
+				lens[b], lens[a]);
+		}
+
+		auto j = m;
+		for (; j != 0; --j) {
+			if (++cs[j - 1] != lens[outer[j - 1]]) break;
+			cs[j - 1] = 0;
+		}
+		if (j == 0) break;
+	}
+}
+
+/*
+** Copies `src` to `dst` using the procedure described at the top of this file.
+** Both arrays must have the same extents, and provide underlying views whose
+** iterators are pointers to the same trivially-copyable element type.
+*/
+template <class T, class U>
+CC_ALWAYS_INLINE
+void permuted_copy(array_wrapper<T>& dst, const array_wrapper<U>& src) noexcept
+{
+	using seq = std::make_index_sequence<array_wrapper<T>::dims()>;
+	permuted_copy(dst, src, seq{});
+}
+
+}}
+
+#endif
@@ -0,0 +1,187 @@
+/*
+** File Name: permuted_view.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** A permuted view refers to the elements of another array with its dimensions
+** reordered, without copying them. `permute_axes<Ps...>(arr)` returns a view
+** whose `i`th dimension is dimension `Ps[i]` of `arr`, and `transpose(arr)`
+** reverses the dimensions of `arr`.
+**
+** The view shares the memory of its parent, so its storage order is the
+** storage order of the parent with the dimensions renumbered. This means that
+** assigning a permuted view to a dense array with the default storage order
+** performs an actual transposition of the elements, which is implemented using
+** a blocked transpose whenever both arrays are contiguous (see
+** `permuted_copy.hpp`). Likewise, assigning a view to an array with the same
+** storage order simply copies the underlying memory. As with any other view,
+** the destination of the assignment must not overlap with the parent, so
+** `a = transpose(a)` does not transpose `a` in place.
+*/
+
+#ifndef Z20139761_7210_4F6E_B4EF_E5439B54744A
+#define Z20139761_7210_4F6E_B4EF_E5439B54744A
+
+namespace nd {
+namespace detail {
+
+template <size_t... Ps>
+CC_ALWAYS_INLINE constexpr
+auto is_permutation() noexcept
+{
+	constexpr size_t ps[] = {Ps...};
+	constexpr auto n = sizeof...(Ps);
+
+	for (auto i = size_t{0}; i != n; ++i) {
+		if (ps[i] >= n) return false;
+		for (auto j = size_t{0}; j != i; ++j) {
+			if (ps[i] == ps[j]) return false;
+		}
+	}
+	return true;
+}
+
+/*
+** Returns the dimension of the view corresponding to dimension `q` of the
+** parent.
+*/
+template <size_t... Ps>
+CC_ALWAYS_INLINE constexpr
+auto inverse_permutation(const size_t q) noexcept
+{
+	constexpr size_t ps[] = {Ps...};
+	auto i = size_t{0};
+	while (ps[i] != q) { ++i; }
+	return i;
+}
+
+}
+
+template <class Array, size_t... Ps>
+class permuted_view final
+{
+	static_assert(
+		std::is_lvalue_reference<Array>::value,
+		"Permuted views can only refer to lvalues."
+	);
+
+	using parent_type  = std::decay_t<Array>;
+	using parent_order = std::decay_t<decltype(
+		std::declval<parent_type>().storage_order())>;
+
+	static constexpr auto dims = sizeof...(Ps);
+	using seq = std::make_index_sequence<dims>;
+
+	static_assert(
+		dims == parent_type::dims() && detail::is_permutation<Ps...>(),
+		"Axes of permuted view must be a permutation of the "
+		"dimensions of the parent."
+	);
+public:
+	using external_type = typename parent_type::external_type;
+	using size_type     = typename parent_type::size_type;
+	using integer       = typename std::decay_t<decltype(
+		std::declval<parent_type>().extents())>::integer;
+
+	static constexpr auto is_lazy = false;
+private:
+	Array m_ref;
+public:
+	CC_ALWAYS_INLINE constexpr
+	explicit permuted_view(Array ref) noexcept : m_ref(ref) {}
+
+	CC_ALWAYS_INLINE
+	auto extents() const noexcept
+	{
+		const auto e = m_ref.extents();
+		return make_range(
+			c_index(e.start_c(sc_coord<Ps>)...),
+			c_index(e.finish_c(sc_coord<Ps>)...),
+			c_index(e.stride_c(sc_coord<Ps>)...)
+		);
+	}
+
+	CC_ALWAYS_INLINE constexpr
+	static auto storage_order() noexcept
+	{ return order_helper(seq{}); }
+
+	template <class... Us>
+	CC_ALWAYS_INLINE
+	decltype(auto) at(const Us... us) const noexcept
+	{
+		const integer cs[] = {integer(us)...};
+		return at_helper(cs, seq{});
+	}
+
+	/*
+	** The underlying view of the parent is also the underlying view of the
+	** permuted view, since the storage order of the latter accounts for the
+	** permutation.
+	*/
+	template <class A = Array>
+	CC_ALWAYS_INLINE
+	auto underlying_view() const noexcept ->
+	decltype(std::declval<A>().underlying_view())
+	{ return m_ref.underlying_view(); }
+private:
+	template <size_t... Ks>
+	CC_ALWAYS_INLINE constexpr
+	static auto order_helper(std::index_sequence<Ks...>) noexcept
+	{
+		return basic_sc_index<unsigned, unsigned(
+			detail::inverse_permutation<Ps...>(
+				detail::order_value<parent_order>(Ks, seq{})))...>;
+	}
+
+	template <size_t... Qs>
+	CC_ALWAYS_INLINE
+	decltype(auto) at_helper(const integer* cs, std::index_sequence<Qs...>)
+	const noexcept
+	{ return m_ref(cs[detail::inverse_permutation<Ps...>(Qs)]...); }
+};
+
+template <size_t... Ps, class T>
+CC_ALWAYS_INLINE
+auto permute_axes(array_wrapper<T>& arr) noexcept
+{
+	using view = permuted_view<array_wrapper<T>&, Ps...>;
+	return array_wrapper<view>{view{arr}};
+}
+
+template <size_t... Ps, class T>
+CC_ALWAYS_INLINE
+auto permute_axes(const array_wrapper<T>& arr) noexcept
+{
+	using view = permuted_view<const array_wrapper<T>&, Ps...>;
+	return array_wrapper<view>{view{arr}};
+}
+
+namespace detail {
+
+template <class T, size_t... Ks>
+CC_ALWAYS_INLINE
+auto transpose(T& arr, std::index_sequence<Ks...>) noexcept
+{ return permute_axes<(sizeof...(Ks) - 1 - Ks)...>(arr); }
+
+}
+
+template <class T>
+CC_ALWAYS_INLINE
+auto transpose(array_wrapper<T>& arr) noexcept
+{
+	using seq = std::make_index_sequence<array_wrapper<T>::dims()>;
+	return detail::transpose(arr, seq{});
+}
+
+template <class T>
+CC_ALWAYS_INLINE
+auto transpose(const array_wrapper<T>& arr) noexcept
+{
+	using seq = std::make_index_sequence<array_wrapper<T>::dims()>;
+	return detail::transpose(arr, seq{});
+}
+
+}
+
+#endif
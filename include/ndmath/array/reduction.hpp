@@ -0,0 +1,863 @@
+/*
+** File Name: reduction.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Reductions over entire arrays, and along a single axis.
+**
+** # Full Reductions
+**
+** `sum`, `prod`, `min`, and `max` visit the elements in the order of the flat
+** view. The loop keeps several independent accumulators, so that consecutive
+** iterations do not depend on each other, and the accumulators are combined at
+** the end. If the array provides a packet view and the result has the same
+** type as the elements, then each accumulator is an entire packet. The
+** reductions accept an optional policy:
+**
+** - `serial` (the default).
+** - `parallel<Grain>`: the flat view is split into chunks of at least `Grain`
+**   elements, which are reduced by the threads of `thread_pool::instance()`.
+**   Arrays with fewer than `nd_parallel_threshold` elements are reduced
+**   serially.
+** - `pairwise_summation` (`sum` only): the flat view is recursively split in
+**   half, so that the rounding error grows with the logarithm of the size of
+**   the array rather than linearly.
+** - `kahan_summation` (`sum` only): compensated summation using a single
+**   accumulator. This is slower than the other policies, and is defeated by
+**   `-ffast-math`.
+**
+** `argmin` and `argmax` return the index of the first extremal element. `any`,
+** `all`, and `count` convert each element to `bool`. If the underlying view of
+** the array consists of words of packed booleans (e.g. `dense_storage<bool>`,
+** or an elementwise operation on such arrays), then these functions operate on
+** entire words at a time using popcount.
+**
+** `reduce(arr, init, f)` folds `f` over the flat view, starting with `init`. No
+** assumptions are made about the associativity of `f`, so a single accumulator
+** is used.
+**
+** # Axis Reductions
+**
+** Each of the functions above except `count` also accepts an axis as its last
+** argument. The result is a dynamic array whose extents are those of the source
+** with the axis removed. The source is traversed once in the order given by its
+** extents, and each element is accumulated into the corresponding element of
+** the result, so that reducing along a slow axis does not stride through
+** memory.
+*/
+
+#ifndef ZFAEF150D_8F98_4CFD_9EB8_2B10429531EF
+#define ZFAEF150D_8F98_4CFD_9EB8_2B10429531EF
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+#include <ndmath/array/dense_storage.hpp>
+#include <ndmath/range/for_each.hpp>
+#include <ndmath/range/loop_attribute.hpp>
+#include <ndmath/utility/operations.hpp>
+#include <ndmath/utility/thread_pool.hpp>
+
+namespace nd {
+
+struct pairwise_summation_t {};
+static constexpr auto pairwise_summation = pairwise_summation_t{};
+
+struct kahan_summation_t {};
+static constexpr auto kahan_summation = kahan_summation_t{};
+
+namespace detail {
+
+/*
+** The number of independent accumulators used by the reduction loops.
+*/
+static constexpr auto reduction_accumulators = size_t{4};
+
+/*
+** The elements of the arrays passed to the pairwise summation routine are
+** summed directly once the length of a subrange is at most this number.
+*/
+static constexpr auto pairwise_block_size = size_t{128};
+
+/*
+** Each operation defines the type of the accumulator used to reduce elements of
+** type `T`, and the initial value of the accumulator given the first element
+** of the array. The latter allows `min` and `max` to be implemented without
+** requiring an identity element.
+*/
+
+struct sum_op
+{
+	static constexpr auto is_packet_op = true;
+
+	template <class T>
+	using result_type = std::decay_t<decltype(
+		std::declval<T>() + std::declval<T>())>;
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	static auto identity(const T&) noexcept
+	{ return T(0); }
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const T& x, const T& y) const noexcept
+	{ return T(x + y); }
+};
+
+struct prod_op
+{
+	static constexpr auto is_packet_op = true;
+
+	template <class T>
+	using result_type = std::decay_t<decltype(
+		std::declval<T>() * std::declval<T>())>;
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	static auto identity(const T&) noexcept
+	{ return T(1); }
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const T& x, const T& y) const noexcept
+	{ return T(x * y); }
+};
+
+struct min_op
+{
+	static constexpr auto is_packet_op = false;
+
+	template <class T>
+	using result_type = std::decay_t<T>;
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	static auto identity(const T& x) noexcept
+	{ return x; }
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const T& x, const T& y) const noexcept
+	{ return y < x ? y : x; }
+};
+
+struct max_op
+{
+	static constexpr auto is_packet_op = false;
+
+	template <class T>
+	using result_type = std::decay_t<T>;
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	static auto identity(const T& x) noexcept
+	{ return x; }
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const T& x, const T& y) const noexcept
+	{ return x < y ? y : x; }
+};
+
+struct and_op
+{
+	static constexpr auto is_packet_op = false;
+
+	template <class T>
+	using result_type = bool;
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	static auto identity(const T&) noexcept
+	{ return true; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const bool x, const bool y) const noexcept
+	{ return x && y; }
+};
+
+struct or_op
+{
+	static constexpr auto is_packet_op = false;
+
+	template <class T>
+	using result_type = bool;
+
+	template <class T>
+	CC_ALWAYS_INLINE constexpr
+	static auto identity(const T&) noexcept
+	{ return false; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto operator()(const bool x, const bool y) const noexcept
+	{ return x || y; }
+};
+
+template <class Op, class T>
+using reduction_result = typename Op::template result_type<
+	typename array_wrapper<T>::external_type>;
+
+/*
+** Reduces the elements at the offsets `[first, last)` of the flat view whose
+** first iterator is `begin`.
+*/
+template <class Op, class Iterator, class Acc>
+class flat_reduction_kernel final
+{
+	Iterator m_begin;
+	Acc m_init;
+public:
+	using result_type = Acc;
+
+	CC_ALWAYS_INLINE
+	explicit flat_reduction_kernel(const Iterator& begin, const Acc& init)
+	noexcept : m_begin(begin), m_init(init) {}
+
+	template <class SizeType>
+	CC_ALWAYS_INLINE
+	auto operator()(const SizeType first, const SizeType last) const noexcept
+	{
+		constexpr auto k = reduction_accumulators;
+		const auto op = Op{};
+
+		Acc acc[k];
+		for (auto j = size_t{0}; j != k; ++j) {
+			acc[j] = m_init;
+		}
+
+		auto it = m_begin + first;
+		auto i = first;
+
+		for (; last - i >= k; i += k) {
+			for (auto j = size_t{0}; j != k; ++j, ++it) {
+				acc[j] = op(acc[j], Acc(*it));
+			}
+		}
+		for (; i != last; ++i, ++it) {
+			acc[0] = op(acc[0], Acc(*it));
+		}
+		for (auto j = size_t{1}; j != k; ++j) {
+			acc[0] = op(acc[0], acc[j]);
+		}
+		return acc[0];
+	}
+};
+
+/*
+** Like `flat_reduction_kernel`, except that each accumulator is a packet. The
+** offsets of the subranges must be multiples of the number of lanes.
+*/
+template <class Op, class View>
+class packet_reduction_kernel final
+{
+	using packet_type = typename View::packet_type;
+	using value_type  = typename View::value_type;
+
+	View m_view;
+	value_type m_init;
+public:
+	using result_type = value_type;
+
+	CC_ALWAYS_INLINE
+	explicit packet_reduction_kernel(const View& view, const value_type init)
+	noexcept : m_view(view), m_init(init) {}
+
+	template <class SizeType>
+	CC_ALWAYS_INLINE
+	auto operator()(const SizeType first, const SizeType last) const noexcept
+	{
+		constexpr auto k = reduction_accumulators;
+		constexpr auto lanes = SizeType(View::lanes);
+		const auto op = Op{};
+
+		packet_type acc[k];
+		for (auto j = size_t{0}; j != k; ++j) {
+			acc[j] = packet_type::broadcast(m_init);
+		}
+
+		auto i = first;
+		for (; last - i >= k * lanes; i += k * lanes) {
+			for (auto j = size_t{0}; j != k; ++j) {
+				acc[j] = op(acc[j], m_view.load(SizeType(i + j * lanes)));
+			}
+		}
+		for (; last - i >= lanes; i += lanes) {
+			acc[0] = op(acc[0], m_view.load(i));
+		}
+		for (auto j = size_t{1}; j != k; ++j) {
+			acc[0] = op(acc[0], acc[j]);
+		}
+
+		auto r = acc[0][0];
+		for (auto j = size_t{1}; j != lanes; ++j) {
+			r = op(r, acc[0][j]);
+		}
+		if (i != last) {
+			const auto n = SizeType(last - i);
+			const auto p = m_view.load(i, n);
+			for (auto j = SizeType{0}; j != n; ++j) {
+				r = op(r, p[j]);
+			}
+		}
+		return r;
+	}
+};
+
+template <bool PacketViewFeasible>
+struct reduction_kernel_helper;
+
+template <>
+struct reduction_kernel_helper<true>
+{
+	template <class Op, class T, class Acc>
+	CC_ALWAYS_INLINE
+	static auto make(const array_wrapper<T>& arr, const Acc& init) noexcept
+	{
+		using view = decltype(arr.packet_view());
+		return packet_reduction_kernel<Op, view>{arr.packet_view(), init};
+	}
+};
+
+template <>
+struct reduction_kernel_helper<false>
+{
+	template <class Op, class T, class Acc>
+	CC_ALWAYS_INLINE
+	static auto make(const array_wrapper<T>& arr, const Acc& init) noexcept
+	{
+		using iterator = decltype(arr.flat_view().begin());
+		return flat_reduction_kernel<Op, iterator, Acc>{
+			arr.flat_view().begin(), init};
+	}
+};
+
+template <class Op, class T>
+CC_ALWAYS_INLINE
+auto make_reduction_kernel(const array_wrapper<T>& arr) noexcept
+{
+	using array_type = array_wrapper<T>;
+	using acc        = reduction_result<Op, T>;
+
+	constexpr auto packet_view_feasible =
+		Op::is_packet_op &&
+		array_type::provides_packet_view &&
+		std::is_same<acc, typename array_type::external_type>::value;
+
+	using helper = reduction_kernel_helper<packet_view_feasible>;
+	const auto init = Op::identity(acc(*arr.flat_view().begin()));
+	return helper::template make<Op>(arr, init);
+}
+
+template <class Kernel, class SizeType>
+CC_ALWAYS_INLINE
+auto pairwise_reduce(const Kernel& k, const SizeType first, const SizeType last)
+noexcept -> typename Kernel::result_type
+{
+	if (last - first <= pairwise_block_size) {
+		return k(first, last);
+	}
+
+	/*
+	** The midpoint is rounded to a multiple of the block size, which is
+	** also a multiple of the number of lanes of any packet.
+	*/
+	const auto blocks = (last - first) / pairwise_block_size;
+	const auto mid = SizeType(first + (blocks + 1) / 2 * pairwise_block_size);
+	return pairwise_reduce(k, first, mid) + pairwise_reduce(k, mid, last);
+}
+
+template <size_t Grain, class Op, class Kernel, class SizeType>
+auto parallel_reduce(const Kernel& k, const SizeType n)
+{
+	using result_type = typename Kernel::result_type;
+
+	auto& pool = thread_pool::instance();
+	const auto threads = pool.concurrency();
+
+	if (
+		in_parallel_region() || threads == 1 ||
+		size_t(n) < nd_parallel_threshold
+	) {
+		return k(SizeType{0}, n);
+	}
+
+	/*
+	** Use a few chunks per thread, so that the threads that finish early
+	** can steal work from the others. The length of each chunk is a
+	** multiple of the block size, so that the packets remain aligned.
+	*/
+	auto len = std::max(size_t{Grain}, (size_t(n) + 4 * threads - 1) / (4 * threads));
+	len = (len + pairwise_block_size - 1) / pairwise_block_size * pairwise_block_size;
+	const auto chunks = (size_t(n) + len - 1) / len;
+
+	auto partial = std::vector<result_type>(chunks);
+	pool.run(chunks, [&] (const size_t i) {
+		partial[i] = k(SizeType(i * len),
+			SizeType(std::min(size_t(n), (i + 1) * len)));
+	});
+
+	const auto op = Op{};
+	auto r = partial[0];
+	for (auto i = size_t{1}; i != chunks; ++i) {
+		r = op(r, partial[i]);
+	}
+	return r;
+}
+
+template <class Op, class T>
+CC_ALWAYS_INLINE
+auto reduce_full(const array_wrapper<T>& arr, serial)
+{ return make_reduction_kernel<Op>(arr)(decltype(arr.size()){0}, arr.size()); }
+
+template <class Op, class T, size_t Grain>
+CC_ALWAYS_INLINE
+auto reduce_full(const array_wrapper<T>& arr, parallel<Grain>)
+{ return parallel_reduce<Grain, Op>(make_reduction_kernel<Op>(arr), arr.size()); }
+
+template <class Op, class T>
+CC_ALWAYS_INLINE
+auto reduce_full(const array_wrapper<T>& arr, pairwise_summation_t)
+{
+	static_assert(
+		std::is_same<Op, sum_op>::value,
+		"Pairwise summation only applies to sums."
+	);
+	return pairwise_reduce(make_reduction_kernel<Op>(arr),
+		decltype(arr.size()){0}, arr.size());
+}
+
+template <class Op, class T>
+CC_ALWAYS_INLINE
+auto reduce_full(const array_wrapper<T>& arr, kahan_summation_t)
+{
+	static_assert(
+		std::is_same<Op, sum_op>::value,
+		"Kahan summation only applies to sums."
+	);
+
+	using acc = reduction_result<Op, T>;
+	auto s = acc(0);
+	auto c = acc(0);
+
+	for (const auto& x : arr.flat_view()) {
+		const auto y = acc(x) - c;
+		const auto t = s + y;
+		c = (t - s) - y;
+		s = t;
+	}
+	return s;
+}
+
+/*
+** Converts an offset into the flat view of an array to the corresponding
+** index.
+*/
+template <class T, size_t... Ps>
+CC_ALWAYS_INLINE
+auto offset_to_index(
+	const array_wrapper<T>& arr,
+	const typename array_wrapper<T>::size_type off,
+	std::index_sequence<Ps...>
+) noexcept
+{
+	using array_type = array_wrapper<T>;
+	using size_type  = typename array_type::size_type;
+	using integer    = typename std::decay_t<decltype(arr.extents())>::integer;
+	using helper     = element_from_offset_helper<array_type::dims() - 1, size_type>;
+
+	integer cs[array_type::dims()];
+	helper::apply(off, arr, cs);
+	return index<integer>(cs[Ps]...);
+}
+
+template <class Compare, class T>
+CC_ALWAYS_INLINE
+auto arg_reduce(const array_wrapper<T>& arr, const Compare& comp) noexcept
+{
+	using array_type = array_wrapper<T>;
+	using size_type  = typename array_type::size_type;
+	using value_type = typename array_type::external_type;
+
+	const auto n = arr.size();
+	auto it = arr.flat_view().begin();
+	auto best = value_type(*it);
+	auto pos = size_type{0};
+
+	++it;
+	for (auto i = size_type{1}; i < n; ++i, ++it) {
+		const auto x = value_type(*it);
+		if (comp(x, best)) {
+			best = x;
+			pos = i;
+		}
+	}
+	return offset_to_index(arr, pos,
+		std::make_index_sequence<array_type::dims()>{});
+}
+
+template <class T>
+CC_ALWAYS_INLINE constexpr
+auto popcount(const T x) noexcept
+{ return size_t(__builtin_popcountll((unsigned long long)x)); }
+
+/*
+** Implements `any`, `all`, and `count` using the words of packed booleans in
+** the underlying view. The bits of the last word past the end of the array are
+** masked out, since they need not be zero.
+*/
+template <bool UsesPackedBooleans>
+struct logical_reduction_helper;
+
+template <>
+struct logical_reduction_helper<true>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static auto words(const array_wrapper<T>& arr) noexcept
+	{
+		using word_type = std::decay_t<decltype(
+			(*arr.underlying_view().begin()).value())>;
+		constexpr auto bits = size_t(8 * sizeof(word_type));
+
+		const auto n = size_t(arr.size());
+		return std::make_tuple(n / bits, n % bits,
+			tail_mask<word_type>(n));
+	}
+
+	template <class T>
+	CC_ALWAYS_INLINE
+	static bool any(const array_wrapper<T>& arr) noexcept
+	{
+		const auto w = words(arr);
+		auto it = arr.underlying_view().begin();
+
+		for (auto i = size_t{0}; i != std::get<0>(w); ++i, ++it) {
+			if ((*it).value() != 0) return true;
+		}
+		return std::get<1>(w) != 0 && ((*it).value() & std::get<2>(w)) != 0;
+	}
+
+	template <class T>
+	CC_ALWAYS_INLINE
+	static bool all(const array_wrapper<T>& arr) noexcept
+	{
+		using word_type = std::decay_t<decltype(
+			(*arr.underlying_view().begin()).value())>;
+
+		const auto w = words(arr);
+		const auto m = std::get<2>(w);
+		auto it = arr.underlying_view().begin();
+
+		for (auto i = size_t{0}; i != std::get<0>(w); ++i, ++it) {
+			if ((*it).value() != ~word_type{0}) return false;
+		}
+		return std::get<1>(w) == 0 || ((*it).value() & m) == m;
+	}
+
+	template <class T>
+	CC_ALWAYS_INLINE
+	static auto count(const array_wrapper<T>& arr) noexcept
+	{
+		using size_type = typename array_wrapper<T>::size_type;
+
+		const auto w = words(arr);
+		auto it = arr.underlying_view().begin();
+		size_t acc[reduction_accumulators] = {};
+		auto i = size_t{0};
+
+		for (; std::get<0>(w) - i >= reduction_accumulators;) {
+			for (auto j = size_t{0}; j != reduction_accumulators; ++j, ++i, ++it) {
+				acc[j] += popcount((*it).value());
+			}
+		}
+		for (; i != std::get<0>(w); ++i, ++it) {
+			acc[0] += popcount((*it).value());
+		}
+		if (std::get<1>(w) != 0) {
+			acc[0] += popcount((*it).value() & std::get<2>(w));
+		}
+
+		auto r = size_t{0};
+		for (auto j = size_t{0}; j != reduction_accumulators; ++j) {
+			r += acc[j];
+		}
+		return size_type(r);
+	}
+};
+
+template <>
+struct logical_reduction_helper<false>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static bool any(const array_wrapper<T>& arr) noexcept
+	{
+		for (const auto& x : arr.flat_view()) {
+			if (bool(x)) return true;
+		}
+		return false;
+	}
+
+	template <class T>
+	CC_ALWAYS_INLINE
+	static bool all(const array_wrapper<T>& arr) noexcept
+	{
+		for (const auto& x : arr.flat_view()) {
+			if (!bool(x)) return false;
+		}
+		return true;
+	}
+
+	template <class T>
+	CC_ALWAYS_INLINE
+	static auto count(const array_wrapper<T>& arr) noexcept
+	{
+		using size_type = typename array_wrapper<T>::size_type;
+
+		auto r = size_type{0};
+		for (const auto& x : arr.flat_view()) {
+			r += bool(x);
+		}
+		return r;
+	}
+};
+
+template <class T>
+using logical_reduction = logical_reduction_helper<
+	array_wrapper<T>::provides_underlying_view &&
+	is_boolean_storage<typename array_wrapper<T>::underlying_type>::value
+>;
+
+template <class Range, size_t... Ps>
+CC_ALWAYS_INLINE
+auto reduced_extents(const Range& r, const size_t axis, std::index_sequence<Ps...>)
+noexcept
+{
+	using integer = typename Range::integer;
+
+	const integer lens[] = {integer(
+		(r.finish(sc_coord<Ps>) - r.start(sc_coord<Ps>)) /
+		r.stride(sc_coord<Ps>) + 1)...};
+
+	return nd::extents(lens[Ps < axis ? Ps : Ps + 1]...);
+}
+
+/*
+** Invokes `f(rs, k, x)` for each element `x` of `arr`, where `rs` are the
+** coordinates of the element with `axis` removed, and `k` is its coordinate
+** along the axis. Both are relative to the start of the extents.
+*/
+template <class T, class Func>
+CC_ALWAYS_INLINE
+void visit_axis(const array_wrapper<T>& arr, const size_t axis, const Func& f)
+{
+	using integer = typename std::decay_t<decltype(arr.extents())>::integer;
+	constexpr auto dims = array_wrapper<T>::dims();
+
+	const auto e = arr.extents();
+	integer s[dims];
+	expand_index([&] (const auto... ts) CC_ALWAYS_INLINE noexcept {
+		const integer cs[] = {integer(ts)...};
+		std::copy(cs, cs + dims, s);
+	}, e.start());
+
+	nd::for_each(e, [&] (const auto& i) CC_ALWAYS_INLINE {
+		expand_index([&] (const auto... ts) CC_ALWAYS_INLINE {
+			const integer cs[] = {integer(ts)...};
+			integer rs[dims - 1];
+
+			for (auto p = size_t{0}, q = size_t{0}; p != dims; ++p) {
+				if (p != axis) {
+					rs[q++] = cs[p] - s[p];
+				}
+			}
+			f(rs, size_t(cs[axis] - s[axis]), arr(ts...));
+		}, i);
+	});
+}
+
+template <class Acc, class T, class Init, class Func>
+CC_ALWAYS_INLINE
+auto reduce_axis(
+	const array_wrapper<T>& arr,
+	const size_t axis,
+	const Init& init,
+	const Func& f
+)
+{
+	constexpr auto dims = array_wrapper<T>::dims();
+	static_assert(dims >= 2, "Axis reductions require at least two dimensions.");
+	nd_assert(axis < dims, "axis out of bounds.\n▶ $ ≥ $", axis, dims);
+
+	using seq = std::make_index_sequence<dims - 1>;
+	auto res = make_darray<Acc>(reduced_extents(arr.extents(), axis, seq{}));
+
+	visit_axis(arr, axis, [&] (const auto& rs, const size_t k, const auto& x)
+		CC_ALWAYS_INLINE {
+			auto&& r = at_coords(res, rs, seq{});
+			r = k == 0 ? Acc(init(x)) : Acc(f(Acc(r), x));
+		});
+	return res;
+}
+
+template <class Op, class T>
+CC_ALWAYS_INLINE
+auto reduce_axis(const array_wrapper<T>& arr, const size_t axis)
+{
+	using acc = reduction_result<Op, T>;
+	const auto op = Op{};
+
+	return reduce_axis<acc>(arr, axis,
+		[&] (const auto& x) CC_ALWAYS_INLINE {
+			return op(Op::identity(acc(x)), acc(x));
+		},
+		[&] (const acc& r, const auto& x) CC_ALWAYS_INLINE {
+			return op(r, acc(x));
+		});
+}
+
+template <class Compare, class T>
+CC_ALWAYS_INLINE
+auto arg_reduce_axis(
+	const array_wrapper<T>& arr,
+	const size_t axis,
+	const Compare& comp
+)
+{
+	using integer    = typename std::decay_t<decltype(arr.extents())>::integer;
+	using value_type = typename array_wrapper<T>::external_type;
+	constexpr auto dims = array_wrapper<T>::dims();
+
+	static_assert(dims >= 2, "Axis reductions require at least two dimensions.");
+	nd_assert(axis < dims, "axis out of bounds.\n▶ $ ≥ $", axis, dims);
+
+	using seq = std::make_index_sequence<dims - 1>;
+	const auto e = reduced_extents(arr.extents(), axis, seq{});
+	auto best = make_darray<value_type>(e);
+	auto res = make_darray<integer>(e);
+
+	visit_axis(arr, axis, [&] (const auto& rs, const size_t k, const auto& x)
+		CC_ALWAYS_INLINE {
+			auto&& b = at_coords(best, rs, seq{});
+			auto&& r = at_coords(res, rs, seq{});
+			const auto v = value_type(x);
+
+			if (k == 0 || comp(v, value_type(b))) {
+				b = v;
+				r = integer(k);
+			}
+		});
+	return res;
+}
+
+}
+
+/*
+** Full reductions.
+*/
+
+template <class T, class U, class Func>
+CC_ALWAYS_INLINE
+auto reduce(const array_wrapper<T>& arr, const U& init, const Func& f)
+{
+	auto r = init;
+	for (const auto& x : arr.flat_view()) {
+		r = f(r, x);
+	}
+	return r;
+}
+
+template <class T, class Policy = serial, nd_enable_if((
+	!std::is_integral<Policy>::value))>
+CC_ALWAYS_INLINE
+auto sum(const array_wrapper<T>& arr, const Policy p = Policy{})
+{ return detail::reduce_full<detail::sum_op>(arr, p); }
+
+template <class T, class Policy = serial, nd_enable_if((
+	!std::is_integral<Policy>::value))>
+CC_ALWAYS_INLINE
+auto prod(const array_wrapper<T>& arr, const Policy p = Policy{})
+{ return detail::reduce_full<detail::prod_op>(arr, p); }
+
+template <class T, class Policy = serial, nd_enable_if((
+	!std::is_integral<Policy>::value))>
+CC_ALWAYS_INLINE
+auto min(const array_wrapper<T>& arr, const Policy p = Policy{})
+{ return detail::reduce_full<detail::min_op>(arr, p); }
+
+template <class T, class Policy = serial, nd_enable_if((
+	!std::is_integral<Policy>::value))>
+CC_ALWAYS_INLINE
+auto max(const array_wrapper<T>& arr, const Policy p = Policy{})
+{ return detail::reduce_full<detail::max_op>(arr, p); }
+
+template <class T>
+CC_ALWAYS_INLINE
+auto argmin(const array_wrapper<T>& arr)
+{ return detail::arg_reduce(arr, detail::less{}); }
+
+template <class T>
+CC_ALWAYS_INLINE
+auto argmax(const array_wrapper<T>& arr)
+{ return detail::arg_reduce(arr, detail::greater{}); }
+
+template <class T>
+CC_ALWAYS_INLINE
+bool any(const array_wrapper<T>& arr)
+{ return detail::logical_reduction<T>::any(arr); }
+
+template <class T>
+CC_ALWAYS_INLINE
+bool all(const array_wrapper<T>& arr)
+{ return detail::logical_reduction<T>::all(arr); }
+
+template <class T>
+CC_ALWAYS_INLINE
+auto count(const array_wrapper<T>& arr)
+{ return detail::logical_reduction<T>::count(arr); }
+
+/*
+** Axis reductions.
+*/
+
+template <class T, class U, class Func, class Axis, nd_enable_if((
+	std::is_integral<Axis>::value))>
+CC_ALWAYS_INLINE
+auto reduce(const array_wrapper<T>& arr, const U& init, const Func& f,
+	const Axis axis)
+{
+	return detail::reduce_axis<U>(arr, size_t(axis),
+		[&] (const auto& x) CC_ALWAYS_INLINE { return f(init, x); }, f);
+}
+
+#define nd_define_axis_reduction(name, op)                          \
+	template <class T, class Axis, nd_enable_if((               \
+		std::is_integral<Axis>::value))>                    \
+	CC_ALWAYS_INLINE                                            \
+	auto name(const array_wrapper<T>& arr, const Axis axis)     \
+	{ return detail::reduce_axis<detail::op>(arr, size_t(axis)); }
+
+nd_define_axis_reduction(sum, sum_op)
+nd_define_axis_reduction(prod, prod_op)
+nd_define_axis_reduction(min, min_op)
+nd_define_axis_reduction(max, max_op)
+nd_define_axis_reduction(any, or_op)
+nd_define_axis_reduction(all, and_op)
+
+#undef nd_define_axis_reduction
+
+template <class T, class Axis, nd_enable_if((std::is_integral<Axis>::value))>
+CC_ALWAYS_INLINE
+auto argmin(const array_wrapper<T>& arr, const Axis axis)
+{ return detail::arg_reduce_axis(arr, size_t(axis), detail::less{}); }
+
+template <class T, class Axis, nd_enable_if((std::is_integral<Axis>::value))>
+CC_ALWAYS_INLINE
+auto argmax(const array_wrapper<T>& arr, const Axis axis)
+{ return detail::arg_reduce_axis(arr, size_t(axis), detail::greater{}); }
+
+}
+
+#endif
@@ -8,6 +8,7 @@
 #ifndef ZF3E801BA_B9FD_4AF8_A6EB_F247C5F8E589
 #define ZF3E801BA_B9FD_4AF8_A6EB_F247C5F8E589
 
+#include <ndmath/array/boolean_storage.hpp>
 #include <ndmath/array/relational_operation_traits.hpp>
 
 namespace nd {
@@ -28,6 +29,49 @@ bool equal(const A& the, const B& first, const Func& time)
 	while (++go, ++to != the.end()); return true;
 }
 
+/*
+** Compares the underlying views of two arrays. If the underlying views consist
+** of words of packed booleans, the bits of the last word past the end of the
+** arrays are masked out, since lazy expressions (e.g. `fast_not`) need not
+** leave them clear.
+*/
+template <bool UsesPackedBooleans>
+struct underlying_equal_helper
+{
+	template <class T, class U, class Func>
+	CC_ALWAYS_INLINE
+	static bool
+	apply(const array_wrapper<T>& x, const array_wrapper<U>& y, const Func& f)
+	noexcept { return nd::detail::equal(x.underlying_view(), y.underlying_view(), f); }
+};
+
+template <>
+struct underlying_equal_helper<true>
+{
+	template <class T, class U, class Func>
+	CC_ALWAYS_INLINE
+	static bool
+	apply(const array_wrapper<T>& x, const array_wrapper<U>& y, const Func& f)
+	noexcept
+	{
+		using word_type = std::decay_t<decltype(
+			(*x.underlying_view().begin()).value())>;
+		using storage = boolean_storage<word_type>;
+
+		const auto v = x.underlying_view();
+		auto i = v.begin();
+		auto j = y.underlying_view().begin();
+
+		for (auto n = v.end() - i; n != 1; --n, ++i, ++j) {
+			if (!f(*i, *j)) return false;
+		}
+
+		const auto m = tail_mask<word_type>(size_t(x.size()));
+		return f(storage{word_type((*i).value() & m)},
+			storage{word_type((*j).value() & m)});
+	}
+};
+
 template <bool UnderlyingViewFeasible, bool FlatViewFeasible>
 struct relational_operation_impl;
 
@@ -38,7 +82,12 @@ struct relational_operation_impl<true, FlatViewFeasible>
 	CC_ALWAYS_INLINE
 	static bool
 	apply(const array_wrapper<T>& x, const array_wrapper<U>& y, const Func& f)
-	noexcept { return nd::detail::equal(x.underlying_view(), y.underlying_view(), f); }
+	noexcept
+	{
+		using helper = underlying_equal_helper<is_boolean_storage<
+			typename array_wrapper<T>::underlying_type>::value>;
+		return helper::apply(x, y, f);
+	}
 };
 
 template <>
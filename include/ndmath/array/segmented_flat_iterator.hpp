@@ -0,0 +1,272 @@
+/*
+** File Name: segmented_flat_iterator.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** The flat iterator used by arrays that do not provide a fast flat view.
+** Converting each offset to coordinates using `element_from_offset` costs a
+** division and a remainder per dimension, so instead the iterator keeps the
+** coordinates of the current element alongside the offset. Incrementing or
+** decrementing the iterator only changes the coordinate that varies fastest in
+** storage order, and carries into the slower coordinates at the boundaries of
+** the rows. Thus sequential traversals (e.g. by `std::copy` or the relational
+** operations) only pay for the access to the element itself.
+**
+** The iterator is still random access: `+=` and `-=` recompute the coordinates
+** from the new offset, and `operator[]` falls back to `element_from_offset`.
+** Comparisons use the offset alone.
+*/
+
+#ifndef ZAAAB23EE_A149_466D_B63E_1B8ECA4E80B5
+#define ZAAAB23EE_A149_466D_B63E_1B8ECA4E80B5
+
+namespace nd {
+namespace detail {
+
+/*
+** The coordinates past the last element are those of the last element, with
+** the slowest coordinate incremented once more. This is consistent with both
+** the increment below and `element_from_offset_helper` applied to the size of
+** the array.
+*/
+template <size_t CurDim>
+struct flat_increment_helper
+{
+	using next = flat_increment_helper<CurDim - 1>;
+
+	template <class Array, class Coords>
+	CC_ALWAYS_INLINE
+	static void apply(const Array& arr, Coords& cs) noexcept
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		using integer = std::decay_t<decltype(cs[0])>;
+
+		constexpr auto dim = unsigned(order_coord::value());
+		const auto start = integer(arr.extents().start(sc_coord<dim>));
+		const auto len = integer(arr.extents().length(sc_coord<dim>));
+
+		if (++cs[dim] != start + len) return;
+		cs[dim] = start;
+		next::apply(arr, cs);
+	}
+};
+
+template <>
+struct flat_increment_helper<0>
+{
+	template <class Array, class Coords>
+	CC_ALWAYS_INLINE
+	static void apply(const Array& arr, Coords& cs) noexcept
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<0>))>;
+		++cs[unsigned(order_coord::value())];
+	}
+};
+
+template <size_t CurDim>
+struct flat_decrement_helper
+{
+	using next = flat_decrement_helper<CurDim - 1>;
+
+	template <class Array, class Coords>
+	CC_ALWAYS_INLINE
+	static void apply(const Array& arr, Coords& cs) noexcept
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<CurDim>))>;
+		using integer = std::decay_t<decltype(cs[0])>;
+
+		constexpr auto dim = unsigned(order_coord::value());
+		const auto start = integer(arr.extents().start(sc_coord<dim>));
+		const auto len = integer(arr.extents().length(sc_coord<dim>));
+
+		if (cs[dim]-- != start) return;
+		cs[dim] = start + len - 1;
+		next::apply(arr, cs);
+	}
+};
+
+template <>
+struct flat_decrement_helper<0>
+{
+	template <class Array, class Coords>
+	CC_ALWAYS_INLINE
+	static void apply(const Array& arr, Coords& cs) noexcept
+	{
+		using order_coord = std::decay_t<decltype(
+			arr.storage_order().at_c(sc_coord<0>))>;
+		--cs[unsigned(order_coord::value())];
+	}
+};
+
+}
+
+template <class T>
+class segmented_flat_iterator final
+{
+	using traits    = array_traits_no_view<std::decay_t<T>>;
+	using size_type = typename traits::size_type;
+	using integer   = typename std::decay_t<
+		decltype(std::declval<T&>().extents())>::integer;
+
+	static constexpr auto dims = traits::dims;
+	using coords    = integer[dims];
+	using seq       = std::make_index_sequence<dims>;
+	using increment = detail::flat_increment_helper<dims - 1>;
+	using decrement = detail::flat_decrement_helper<dims - 1>;
+	using locate    = detail::element_from_offset_helper<dims - 1, size_type>;
+public:
+	using difference_type   = std::make_signed_t<size_type>;
+	using reference         = decltype(detail::at_coords(
+		std::declval<T&>(), std::declval<const coords&>(), seq{}));
+	using value_type        = std::decay_t<reference>;
+	using pointer           = value_type*;
+	using iterator_category = std::random_access_iterator_tag;
+private:
+	size_type m_pos{};
+	coords m_cs;
+	T* m_ref;
+public:
+	CC_ALWAYS_INLINE
+	explicit segmented_flat_iterator(T& src) noexcept : m_ref{&src}
+	{ locate::apply(m_pos, src, m_cs); }
+
+	CC_ALWAYS_INLINE
+	explicit segmented_flat_iterator(T& src, const size_type pos) noexcept :
+	m_pos{pos}, m_ref{&src}
+	{ locate::apply(m_pos, src, m_cs); }
+
+	CC_ALWAYS_INLINE
+	reference operator*() const
+	noexcept(traits::is_noexcept_accessible)
+	{ return detail::at_coords(*m_ref, m_cs, seq{}); }
+
+	CC_ALWAYS_INLINE
+	pointer operator->() const
+	noexcept(traits::is_noexcept_accessible)
+	{ return &**this; }
+
+	CC_ALWAYS_INLINE
+	reference operator[](const difference_type n) const
+	noexcept(traits::is_noexcept_accessible)
+	{ return element_from_offset{}(size_type(m_pos + n), *m_ref); }
+
+	CC_ALWAYS_INLINE
+	auto operator++(int) noexcept
+	{ auto t = *this; ++(*this); return t; }
+
+	CC_ALWAYS_INLINE
+	auto operator--(int) noexcept
+	{ auto t = *this; --(*this); return t; }
+
+	CC_ALWAYS_INLINE
+	auto& operator++() noexcept
+	{
+		++m_pos;
+		increment::apply(*m_ref, m_cs);
+		return *this;
+	}
+
+	CC_ALWAYS_INLINE
+	auto& operator--() noexcept
+	{
+		--m_pos;
+		decrement::apply(*m_ref, m_cs);
+		return *this;
+	}
+
+	CC_ALWAYS_INLINE
+	auto& operator+=(const difference_type n) noexcept
+	{
+		m_pos += n;
+		locate::apply(m_pos, *m_ref, m_cs);
+		return *this;
+	}
+
+	CC_ALWAYS_INLINE
+	auto& operator-=(const difference_type n) noexcept
+	{
+		m_pos -= n;
+		locate::apply(m_pos, *m_ref, m_cs);
+		return *this;
+	}
+
+	CC_ALWAYS_INLINE constexpr bool
+	operator==(const segmented_flat_iterator& rhs)
+	const noexcept { return m_pos == rhs.m_pos; }
+
+	CC_ALWAYS_INLINE constexpr bool
+	operator!=(const segmented_flat_iterator& rhs)
+	const noexcept { return m_pos != rhs.m_pos; }
+
+	CC_ALWAYS_INLINE constexpr bool
+	operator>=(const segmented_flat_iterator& rhs)
+	const noexcept { return m_pos >= rhs.m_pos; }
+
+	CC_ALWAYS_INLINE constexpr bool
+	operator<=(const segmented_flat_iterator& rhs)
+	const noexcept { return m_pos <= rhs.m_pos; }
+
+	CC_ALWAYS_INLINE constexpr bool
+	operator>(const segmented_flat_iterator& rhs)
+	const noexcept { return m_pos > rhs.m_pos; }
+
+	CC_ALWAYS_INLINE constexpr bool
+	operator<(const segmented_flat_iterator& rhs)
+	const noexcept { return m_pos < rhs.m_pos; }
+
+	CC_ALWAYS_INLINE constexpr auto
+	operator-(const segmented_flat_iterator& rhs)
+	const noexcept { return difference_type(m_pos - rhs.m_pos); }
+};
+
+template <class T>
+CC_ALWAYS_INLINE
+auto operator+(
+	const segmented_flat_iterator<T>& x,
+	const typename segmented_flat_iterator<T>::difference_type n
+) noexcept
+{
+	auto t = x;
+	t += n;
+	return t;
+}
+
+template <class T>
+CC_ALWAYS_INLINE
+auto operator+(
+	const typename segmented_flat_iterator<T>::difference_type n,
+	const segmented_flat_iterator<T>& x
+) noexcept
+{
+	auto t = x;
+	t += n;
+	return t;
+}
+
+template <class T>
+CC_ALWAYS_INLINE
+auto operator-(
+	const segmented_flat_iterator<T>& x,
+	const typename segmented_flat_iterator<T>::difference_type n
+) noexcept
+{
+	auto t = x;
+	t -= n;
+	return t;
+}
+
+template <class T, class SizeType>
+CC_ALWAYS_INLINE
+auto make_segmented_flat_view(T& t, const SizeType size) noexcept
+{
+	using iterator = segmented_flat_iterator<T>;
+	return boost::make_iterator_range(iterator{t}, iterator{t, size});
+}
+
+}
+
+#endif
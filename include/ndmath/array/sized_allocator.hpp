@@ -0,0 +1,90 @@
+/*
+** File Name: sized_allocator.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** The `size_type` of a dynamic `dense_storage` is taken from its allocator. By
+** default, this is `std::size_t`, so offsets into arrays with more than 2^32
+** elements do not wrap around. When the arrays are known to be small, using a
+** 32-bit size type reduces register pressure in tight loops and halves the size
+** of the offsets stored by the iterators. This adaptor allows one to opt into
+** a narrower size type without changing the underlying allocation strategy:
+**
+** 	using alloc = nd::sized_allocator<std::allocator<float>, unsigned>;
+** 	auto arr = nd::make_darray<float>(nd::extents(n, n), alloc{});
+*/
+
+#ifndef Z5F4C55E7_A93E_4582_84CC_3343007233A1
+#define Z5F4C55E7_A93E_4582_84CC_3343007233A1
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <ndmath/common.hpp>
+
+namespace nd {
+
+template <class Alloc, class SizeType>
+class sized_allocator final : public Alloc
+{
+	static_assert(
+		std::is_unsigned<SizeType>::value,
+		"Size type must be an unsigned integral type."
+	);
+
+	using traits = std::allocator_traits<Alloc>;
+public:
+	using size_type       = SizeType;
+	using difference_type = std::make_signed_t<SizeType>;
+
+	template <class U>
+	struct rebind
+	{
+		using other = sized_allocator<
+			typename traits::template rebind_alloc<U>,
+			SizeType
+		>;
+	};
+
+	CC_ALWAYS_INLINE constexpr
+	sized_allocator() noexcept(noexcept(Alloc{})) {}
+
+	CC_ALWAYS_INLINE constexpr
+	explicit sized_allocator(const Alloc& alloc)
+	noexcept : Alloc(alloc) {}
+
+	template <class Alloc_>
+	CC_ALWAYS_INLINE constexpr
+	sized_allocator(const sized_allocator<Alloc_, SizeType>& rhs)
+	noexcept : Alloc(static_cast<const Alloc_&>(rhs)) {}
+
+	CC_ALWAYS_INLINE
+	auto max_size() const noexcept
+	{
+		return size_type(std::min<typename traits::size_type>(
+			traits::max_size(*this),
+			std::numeric_limits<size_type>::max()
+		));
+	}
+};
+
+template <class Alloc1, class Alloc2, class SizeType>
+CC_ALWAYS_INLINE
+bool operator==(
+	const sized_allocator<Alloc1, SizeType>& lhs,
+	const sized_allocator<Alloc2, SizeType>& rhs
+) noexcept
+{ return static_cast<const Alloc1&>(lhs) == static_cast<const Alloc2&>(rhs); }
+
+template <class Alloc1, class Alloc2, class SizeType>
+CC_ALWAYS_INLINE
+bool operator!=(
+	const sized_allocator<Alloc1, SizeType>& lhs,
+	const sized_allocator<Alloc2, SizeType>& rhs
+) noexcept
+{ return !(lhs == rhs); }
+
+}
+
+#endif
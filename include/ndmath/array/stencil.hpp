@@ -0,0 +1,560 @@
+/*
+** File Name: stencil.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Stencil operations over arrays. A stencil is a list of offsets known at
+** compile time, built from `sc_offset` (the signed counterpart of `sc_index`):
+**
+** 	constexpr auto s = nd::make_stencil(
+** 		nd::sc_offset<-1, 0>, nd::sc_offset<0, -1>, nd::sc_offset<0, 0>,
+** 		nd::sc_offset<0, 1>, nd::sc_offset<1, 0>);
+**
+** 	nd::apply_stencil(dst, src, s, nd::clamp_boundary,
+** 		[] (auto n, auto w, auto c, auto e, auto s) {
+** 			return n + w + e + s - 4 * c;
+** 		});
+**
+** For each index `i` in the extents of `src`, `dst(i)` is assigned the result
+** of invoking the function with the elements of `src` at `i + o` for each
+** offset `o`, in the order in which the offsets are given. The destination must
+** have the same extents as the source, and must not refer to the same array.
+**
+** The extents are split into the interior, in which all neighbours are within
+** bounds, and at most two boxes per dimension along the edges. The interior is
+** evaluated without any bounds checks. If both arrays provide direct access to
+** their elements (dense or mapped arrays of types other than `bool`), then the
+** linear distance from each element to each neighbour is computed once, so that
+** the innermost loop reads the neighbours by adding constants to the offset of
+** the current element. The neighbours of the elements in the boxes along the
+** edges are resolved using a boundary policy:
+**
+** - `clamp_boundary`: the coordinate is clamped to the extents, so that the
+**   elements on the edges are repeated.
+** - `wrap_boundary`: the coordinate is taken modulo the length of the extents.
+** - `reflect_boundary`: the coordinate is mirrored about the edge, without
+**   repeating the element on the edge (e.g. -1 maps to 1).
+** - `constant_boundary(v)`: neighbours outside the extents have the value `v`.
+*/
+
+#ifndef ZC6C65D00_A09F_4450_A58C_D71254ACDE9F
+#define ZC6C65D00_A09F_4450_A58C_D71254ACDE9F
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <ndmath/array/dense_storage.hpp>
+#include <ndmath/range/for_each.hpp>
+
+namespace nd {
+
+template <int... Ts>
+static constexpr auto sc_offset = basic_sc_index<int, Ts...>;
+
+template <class... Offsets>
+struct stencil
+{
+	static_assert(
+		sizeof...(Offsets) != 0,
+		"Stencil must have at least one offset."
+	);
+
+	static_assert(
+		mpl::_v<mpl::and_c<Offsets::allows_static_access...>>,
+		"Stencil offsets must be known at compile time."
+	);
+
+	static_assert(
+		mpl::_v<mpl::and_c<(Offsets::dims() ==
+			std::tuple_element_t<0, std::tuple<Offsets...>>::dims())...>>,
+		"Stencil offsets must have the same number of dimensions."
+	);
+
+	CC_ALWAYS_INLINE constexpr
+	static auto dims() noexcept
+	{ return std::tuple_element_t<0, std::tuple<Offsets...>>::dims(); }
+
+	CC_ALWAYS_INLINE constexpr
+	static auto size() noexcept
+	{ return sizeof...(Offsets); }
+};
+
+template <class... Offsets>
+CC_ALWAYS_INLINE constexpr
+auto make_stencil(const Offsets&...) noexcept
+{ return stencil<Offsets...>{}; }
+
+/*
+** Boundary policies. Each one maps the coordinate `c` of a neighbour, relative
+** to the start of the extents, to a coordinate in `[0, n)`.
+*/
+
+struct clamp_boundary_t
+{
+	template <class Integer>
+	CC_ALWAYS_INLINE constexpr
+	static auto resolve(const Integer c, const Integer n) noexcept
+	{ return c < 0 ? Integer(0) : c >= n ? Integer(n - 1) : c; }
+};
+
+struct wrap_boundary_t
+{
+	template <class Integer>
+	CC_ALWAYS_INLINE constexpr
+	static auto resolve(const Integer c, const Integer n) noexcept
+	{ return Integer((c % n + n) % n); }
+};
+
+struct reflect_boundary_t
+{
+	template <class Integer>
+	CC_ALWAYS_INLINE constexpr
+	static auto resolve(const Integer c, const Integer n) noexcept
+	{
+		// The reflected coordinates repeat with period `2 * (n - 1)`.
+		const auto p = Integer(2 * (n - 1));
+		if (p == 0) return Integer(0);
+
+		const auto d = Integer((c % p + p) % p);
+		return d < n ? d : Integer(p - d);
+	}
+};
+
+/*
+** Neighbours outside the extents are not resolved to another element, so this
+** policy is handled separately by `detail::boundary_read`.
+*/
+template <class T>
+struct constant_boundary_t
+{
+	T value;
+};
+
+static constexpr auto clamp_boundary   = clamp_boundary_t{};
+static constexpr auto wrap_boundary    = wrap_boundary_t{};
+static constexpr auto reflect_boundary = reflect_boundary_t{};
+
+template <class T>
+CC_ALWAYS_INLINE constexpr
+auto constant_boundary(const T& value) noexcept
+{ return constant_boundary_t<T>{value}; }
+
+namespace detail {
+
+template <class Offset, size_t Coord>
+static constexpr auto stencil_offset = int(std::decay_t<decltype(
+	std::declval<const Offset&>().at_c(sc_coord<Coord>))>::value());
+
+/*
+** Whether the wrapped type of an array provides a pointer to its elements
+** through `dense_storage_access`, such that the element at offset `off` (as
+** computed by `coords_to_offset`) is at that offset from the pointer. This is
+** not the case for arrays of packed booleans.
+*/
+template <class T>
+struct provides_direct_access
+{
+	template <class U>
+	using access = dense_storage_access<typename U::external_type>;
+
+	template <class U>
+	CC_ALWAYS_INLINE constexpr
+	static auto check(U*) noexcept ->
+	decltype(access<U>::data(std::declval<const U&>()), bool{})
+	{
+		return std::is_convertible<
+			decltype(access<U>::data(std::declval<const U&>())),
+			const typename U::external_type*
+		>::value;
+	}
+
+	template <class U>
+	CC_ALWAYS_INLINE constexpr
+	static auto check(...) noexcept
+	{ return false; }
+
+	static constexpr auto value = check<T>(nullptr);
+};
+
+template <class T>
+CC_ALWAYS_INLINE
+auto direct_data(T& arr) noexcept
+{
+	using access = dense_storage_access<
+		typename std::decay_t<T>::external_type>;
+	return access::data(arr);
+}
+
+template <class Offset, size_t... Ts>
+CC_ALWAYS_INLINE constexpr
+auto stencil_coords(std::index_sequence<Ts...>) noexcept
+{ return std::array<int, sizeof...(Ts)>{{stencil_offset<Offset, Ts>...}}; }
+
+template <class Integer, class Range, size_t... Ts>
+CC_ALWAYS_INLINE
+auto extents_start(const Range& r, std::index_sequence<Ts...>) noexcept
+{ return std::array<Integer, sizeof...(Ts)>{{
+	Integer(r.start(sc_coord<Ts>))...}}; }
+
+template <class Integer, class Range, size_t... Ts>
+CC_ALWAYS_INLINE
+auto extents_length(const Range& r, std::index_sequence<Ts...>) noexcept
+{ return std::array<Integer, sizeof...(Ts)>{{
+	Integer(r.length(sc_coord<Ts>))...}}; }
+
+template <class Integer, size_t Dims, size_t... Ts>
+CC_ALWAYS_INLINE
+auto make_box(
+	const std::array<Integer, Dims>& a,
+	const std::array<Integer, Dims>& b,
+	std::index_sequence<Ts...>
+) noexcept { return make_range(nd::index<Integer>(a[Ts]...),
+	nd::index<Integer>(b[Ts]...)); }
+
+template <class Offset, class Strides, size_t... Ts>
+CC_ALWAYS_INLINE
+auto stencil_delta(const Strides& s, std::index_sequence<Ts...>) noexcept
+{
+	const std::ptrdiff_t ds[] = {std::ptrdiff_t(stencil_offset<Offset, Ts>) *
+		std::ptrdiff_t(s[Ts])...};
+
+	auto r = std::ptrdiff_t{0};
+	for (const auto& d : ds) { r += d; }
+	return r;
+}
+
+template <class Offset, class Integer, class Array, size_t... Ts, class... Us>
+CC_ALWAYS_INLINE
+decltype(auto) at_offset(
+	const Array& arr,
+	std::index_sequence<Ts...>,
+	const Us... us
+)
+{
+	using sint = std::make_signed_t<Integer>;
+	return arr(Integer(sint(us) + stencil_offset<Offset, Ts>)...);
+}
+
+/*
+** The coordinates `cs`, `s`, and `n` are the coordinates of the element
+** relative to the start of the extents, the start of the extents, and their
+** lengths, respectively.
+*/
+template <
+	class Offset,
+	class Integer,
+	class Policy,
+	class Array,
+	class Coords,
+	size_t... Ts
+>
+CC_ALWAYS_INLINE
+auto boundary_read(
+	const Policy& p,
+	const Array& arr,
+	const Coords& cs,
+	const Coords& s,
+	const Coords& n,
+	std::index_sequence<Ts...>
+)
+{
+	using value_type = typename Array::external_type;
+	using sint       = std::decay_t<decltype(cs[0])>;
+
+	return value_type(arr(Integer(s[Ts] + p.resolve(
+		sint(cs[Ts] + stencil_offset<Offset, Ts>), n[Ts]))...));
+}
+
+template <
+	class Offset,
+	class Integer,
+	class T,
+	class Array,
+	class Coords,
+	size_t... Ts
+>
+CC_ALWAYS_INLINE
+auto boundary_read(
+	const constant_boundary_t<T>& p,
+	const Array& arr,
+	const Coords& cs,
+	const Coords& s,
+	const Coords& n,
+	std::index_sequence<Ts...>
+)
+{
+	using value_type = typename Array::external_type;
+	using sint       = std::decay_t<decltype(cs[0])>;
+
+	const sint ts[] = {sint(cs[Ts] + stencil_offset<Offset, Ts>)...};
+	for (auto k = size_t{0}; k != sizeof...(Ts); ++k) {
+		if (ts[k] < 0 || ts[k] >= n[k]) {
+			return value_type(p.value);
+		}
+	}
+	return value_type(arr(Integer(s[Ts] + ts[Ts])...));
+}
+
+template <bool DirectAccess>
+struct stencil_interior_helper;
+
+template <>
+struct stencil_interior_helper<false>
+{
+	template <
+		class Integer,
+		class... Offsets,
+		class T,
+		class U,
+		class Range,
+		class Func
+	>
+	CC_ALWAYS_INLINE
+	static void apply(
+		array_wrapper<T>& dst,
+		const array_wrapper<U>& src,
+		stencil<Offsets...>,
+		const Range& r,
+		const Func& f
+	)
+	{
+		using seq = std::make_index_sequence<array_wrapper<U>::dims()>;
+
+		nd::for_each(r, [&] (const auto& i) CC_ALWAYS_INLINE {
+			expand_index([&] (const auto... ts) CC_ALWAYS_INLINE {
+				dst(ts...) = f(at_offset<Offsets, Integer>(
+					src, seq{}, ts...)...);
+			}, i);
+		});
+	}
+};
+
+/*
+** Visits the interior one row at a time along the coordinate that varies
+** fastest in the storage order of the source. The linear distances to the
+** neighbours are the same for all elements, so they are computed once from the
+** offset strides of the source.
+*/
+template <>
+struct stencil_interior_helper<true>
+{
+	template <
+		class Integer,
+		class... Offsets,
+		class T,
+		class U,
+		class Range,
+		class Func
+	>
+	CC_ALWAYS_INLINE
+	static void apply(
+		array_wrapper<T>& dst,
+		const array_wrapper<U>& src,
+		stencil<Offsets...>,
+		const Range& r,
+		const Func& f
+	)
+	{
+		apply_rows<Integer>(dst, src, stencil<Offsets...>{}, r, f,
+			std::index_sequence_for<Offsets...>{});
+	}
+private:
+	template <
+		class Integer,
+		class... Offsets,
+		class T,
+		class U,
+		class Range,
+		class Func,
+		size_t... Js
+	>
+	CC_ALWAYS_INLINE
+	static void apply_rows(
+		array_wrapper<T>& dst,
+		const array_wrapper<U>& src,
+		stencil<Offsets...>,
+		const Range& r,
+		const Func& f,
+		std::index_sequence<Js...>
+	)
+	{
+		constexpr auto dims = array_wrapper<U>::dims();
+		using seq = std::make_index_sequence<dims>;
+		using order_coord = std::decay_t<decltype(
+			src.storage_order().at_c(sc_coord<dims - 1>))>;
+		constexpr auto inner = unsigned(order_coord::value());
+
+		const auto ss = detail::offset_strides(src.wrapped(), 0);
+		const auto ts = detail::offset_strides(dst.wrapped(), 0);
+		const std::ptrdiff_t ds[] = {stencil_delta<Offsets>(ss, seq{})...};
+		const auto sstep = std::ptrdiff_t(ss[inner]);
+		const auto dstep = std::ptrdiff_t(ts[inner]);
+		const auto len = std::ptrdiff_t(r.length(sc_coord<inner>));
+
+		const auto sp = direct_data(src.wrapped());
+		const auto dp = direct_data(dst.wrapped());
+		const auto rows = restrict_range<inner>(r, r.start(sc_coord<inner>),
+			r.start(sc_coord<inner>));
+
+		nd::for_each(rows, [&] (const auto& i) CC_ALWAYS_INLINE {
+			const auto p = sp + std::ptrdiff_t(index_to_offset(src.wrapped(), i));
+			const auto q = dp + std::ptrdiff_t(index_to_offset(dst.wrapped(), i));
+
+			for (auto k = std::ptrdiff_t{0}; k != len; ++k) {
+				q[k * dstep] = f(p[k * sstep + ds[Js]]...);
+			}
+		});
+	}
+};
+
+template <class Integer, class... Offsets, class T, class U, class Range,
+	class Policy, class Func, size_t... Ts>
+CC_ALWAYS_INLINE
+void stencil_boundary(
+	array_wrapper<T>& dst,
+	const array_wrapper<U>& src,
+	stencil<Offsets...>,
+	const Range& r,
+	const Policy& p,
+	const Func& f,
+	std::index_sequence<Ts...>
+)
+{
+	using sint = std::make_signed_t<Integer>;
+	using seq  = std::index_sequence<Ts...>;
+
+	const auto s = extents_start<sint>(src.extents(), seq{});
+	const auto n = extents_length<sint>(src.extents(), seq{});
+
+	nd::for_each(r, [&] (const auto& i) CC_ALWAYS_INLINE {
+		const std::array<sint, sizeof...(Ts)> cs = {{
+			sint(i(sc_coord<Ts>)) - s[Ts]...}};
+		dst(i(sc_coord<Ts>)...) = f(boundary_read<Offsets, Integer>(
+			p, src, cs, s, n, seq{})...);
+	});
+}
+
+}
+
+template <
+	class T,
+	class U,
+	class... Offsets,
+	class Policy,
+	class Func
+>
+CC_ALWAYS_INLINE
+void apply_stencil(
+	array_wrapper<T>& dst,
+	const array_wrapper<U>& src,
+	const stencil<Offsets...> st,
+	const Policy& p,
+	const Func& f
+)
+{
+	using integer = typename std::decay_t<decltype(src.extents())>::integer;
+	using sint    = std::make_signed_t<integer>;
+	using seq     = std::make_index_sequence<array_wrapper<U>::dims()>;
+	using coords  = std::array<sint, array_wrapper<U>::dims()>;
+	using bounds  = std::array<integer, array_wrapper<U>::dims()>;
+	constexpr auto dims = array_wrapper<U>::dims();
+
+	using interior = detail::stencil_interior_helper<
+		detail::provides_direct_access<T>::value &&
+		detail::provides_direct_access<U>::value &&
+		std::is_same<
+			std::decay_t<decltype(dst.storage_order())>,
+			std::decay_t<decltype(src.storage_order())>
+		>::value
+	>;
+
+	static_assert(
+		stencil<Offsets...>::dims() == dims,
+		"Stencil and array have different numbers of dimensions."
+	);
+
+	nd_assert(
+		dst.extents() == src.extents(),
+		"mismatching extents.\n▶ $ ≠ $",
+		dst.extents(), src.extents()
+	);
+	nd_assert(
+		static_cast<const void*>(&dst) != static_cast<const void*>(&src),
+		"destination of stencil must differ from source."
+	);
+
+	/*
+	** Along each dimension `k`, the elements whose neighbours are all in
+	** bounds are those in `[lo[k], hi[k])`, relative to the start of the
+	** extents.
+	*/
+	const auto s = detail::extents_start<sint>(src.extents(), seq{});
+	const auto n = detail::extents_length<sint>(src.extents(), seq{});
+	const std::array<int, dims> os[] = {
+		detail::stencil_coords<Offsets>(seq{})...};
+
+	auto lo = coords{};
+	auto hi = coords{};
+	auto has_interior = true;
+
+	for (auto k = size_t{0}; k != dims; ++k) {
+		auto a = 0, b = 0;
+		for (const auto& o : os) {
+			a = std::min(a, o[k]);
+			b = std::max(b, o[k]);
+		}
+
+		lo[k] = sint(-a);
+		hi[k] = sint(n[k] - b);
+		has_interior = has_interior && lo[k] < hi[k];
+	}
+
+	auto b1 = bounds{};
+	auto b2 = bounds{};
+
+	if (has_interior) {
+		for (auto k = size_t{0}; k != dims; ++k) {
+			b1[k] = integer(s[k] + lo[k]);
+			b2[k] = integer(s[k] + hi[k] - 1);
+		}
+		interior::template apply<integer>(dst, src, st,
+			detail::make_box(b1, b2, seq{}), f);
+	}
+
+	/*
+	** The remaining elements are covered by disjoint boxes. The boxes
+	** along dimension `k` span the interior along the dimensions before
+	** `k`, and the full extents along the dimensions after it. If the
+	** interior is empty along `k`, then these boxes cover all of the
+	** remaining elements.
+	*/
+	for (auto k = size_t{0}; k != dims; ++k) {
+		for (auto j = size_t{0}; j != dims; ++j) {
+			b1[j] = integer(j < k ? s[j] + lo[j] : s[j]);
+			b2[j] = integer(j < k ? s[j] + hi[j] - 1 : s[j] + n[j] - 1);
+		}
+
+		const auto a = std::min(lo[k], n[k]);
+		const auto b = std::max(hi[k], lo[k]);
+
+		if (a > 0) {
+			b1[k] = integer(s[k]);
+			b2[k] = integer(s[k] + a - 1);
+			detail::stencil_boundary<integer>(dst, src, st,
+				detail::make_box(b1, b2, seq{}), p, f, seq{});
+		}
+		if (b < n[k]) {
+			b1[k] = integer(s[k] + b);
+			b2[k] = integer(s[k] + n[k] - 1);
+			detail::stencil_boundary<integer>(dst, src, st,
+				detail::make_box(b1, b2, seq{}), p, f, seq{});
+		}
+		if (lo[k] >= hi[k]) break;
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,421 @@
+/*
+** File Name: strided_view.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** A strided view refers to a regularly-spaced subset of the elements of another
+** array, without copying them. Strided views are created by invoking an array
+** with one selector per dimension:
+**
+** - An integer or a coordinate (e.g. `end`, `end - 1`) fixes the coordinate of
+**   the corresponding dimension. This dimension is dropped from the view.
+** - The token `_` selects all coordinates of the dimension.
+** - A 1D range (e.g. `cr<0, 4, 2>`) or `slice(a, b, s)` selects the coordinates
+**   `a, a + s, ..., b` of the dimension. The arguments to `slice` may be
+**   integers or coordinates, so that windows such as `slice(1, end - 1)` can be
+**   expressed independently of the extents of the array. If `b - a` is not a
+**   multiple of `s`, the last coordinate selected is the largest one less than
+**   `b`.
+**
+** For example, `m(_, 0)` is the first column of the matrix `m`, and
+** `m(cr<0, 4, 2>, slice(1, end - 1))` selects the even rows of `m`, without the
+** first and last columns.
+**
+** The extents of a strided view start at zero and have unit strides, so that
+** the view can be assigned to and from dense arrays with the same lengths. The
+** strided range over the coordinates of the parent that corresponds to the view
+** is given by `window()`.
+*/
+
+#ifndef ZF12FFCB2_48F8_49C3_A004_F722345BA769
+#define ZF12FFCB2_48F8_49C3_A004_F722345BA769
+
+#include <array>
+#include <ndmath/range/range.hpp>
+
+namespace nd {
+namespace detail {
+
+struct all_selector final {};
+
+template <class Start, class Finish, class Stride>
+struct slice_selector final
+{
+	Start start;
+	Finish finish;
+	Stride stride;
+};
+
+template <class Integer, class T, nd_enable_if((std::is_integral<T>::value))>
+CC_ALWAYS_INLINE constexpr
+auto resolve_coord(const T t, const Integer) noexcept
+{ return Integer(t); }
+
+template <class Integer, class Coord>
+CC_ALWAYS_INLINE constexpr
+auto resolve_coord(const coord_wrapper<Coord>& c, const Integer last) noexcept
+{ return Integer(c.value(last)); }
+
+/*
+** Each specialization defines whether the selected dimension is kept in the
+** view, and a function that computes the first coordinate, last coordinate, and
+** stride selected in the parent, given the first and last coordinates of the
+** parent along the same dimension.
+*/
+template <class T, class = void>
+struct selector_traits
+{
+	static constexpr auto is_selector = false;
+	static constexpr auto is_kept = false;
+};
+
+template <class T>
+struct selector_traits<T, std::enable_if_t<std::is_integral<T>::value>>
+{
+	static constexpr auto is_selector = true;
+	static constexpr auto is_kept = false;
+
+	template <class Integer>
+	CC_ALWAYS_INLINE
+	static void apply(const T& t, const Integer, const Integer,
+		Integer& a, Integer& b, Integer& s) noexcept
+	{ a = b = Integer(t); s = 1; }
+};
+
+template <class Coord>
+struct selector_traits<coord_wrapper<Coord>>
+{
+	static constexpr auto is_selector = true;
+	static constexpr auto is_kept = false;
+
+	template <class Integer>
+	CC_ALWAYS_INLINE
+	static void apply(const coord_wrapper<Coord>& c, const Integer,
+		const Integer last, Integer& a, Integer& b, Integer& s) noexcept
+	{ a = b = resolve_coord(c, last); s = 1; }
+};
+
+template <>
+struct selector_traits<all_selector>
+{
+	static constexpr auto is_selector = true;
+	static constexpr auto is_kept = true;
+
+	template <class Integer>
+	CC_ALWAYS_INLINE
+	static void apply(const all_selector&, const Integer first,
+		const Integer last, Integer& a, Integer& b, Integer& s) noexcept
+	{ a = first; b = last; s = 1; }
+};
+
+template <class Start, class Finish, class Stride>
+struct selector_traits<slice_selector<Start, Finish, Stride>>
+{
+	static constexpr auto is_selector = true;
+	static constexpr auto is_kept = true;
+
+	template <class Integer>
+	CC_ALWAYS_INLINE
+	static void apply(const slice_selector<Start, Finish, Stride>& x,
+		const Integer, const Integer last, Integer& a, Integer& b,
+		Integer& s) noexcept
+	{
+		a = resolve_coord(x.start, last);
+		b = resolve_coord(x.finish, last);
+		s = resolve_coord(x.stride, last);
+	}
+};
+
+template <class Start, class Finish, class Stride, class Attribs>
+struct selector_traits<range<Start, Finish, Stride, Attribs>>
+{
+	static constexpr auto is_selector = Start::dims() == 1;
+	static constexpr auto is_kept = true;
+
+	template <class Integer>
+	CC_ALWAYS_INLINE
+	static void apply(const range<Start, Finish, Stride, Attribs>& r,
+		const Integer, const Integer, Integer& a, Integer& b,
+		Integer& s) noexcept
+	{
+		a = Integer(r.start(sc_coord<0>));
+		b = Integer(r.finish(sc_coord<0>));
+		s = Integer(r.stride(sc_coord<0>));
+	}
+};
+
+/*
+** Used by `array_wrapper::operator()` to determine whether its arguments should
+** be used to create a strided view. At least one of the selectors must keep its
+** dimension, so that invoking an array with coordinates still accesses a single
+** element.
+*/
+template <class... Ts>
+struct is_slice_helper
+{
+	static constexpr auto value =
+	mpl::_v<mpl::and_c<selector_traits<Ts>::is_selector...>> &&
+	!mpl::_v<mpl::and_c<!selector_traits<Ts>::is_kept...>>;
+};
+
+template <>
+struct is_slice_helper<> : std::false_type {};
+
+template <bool... Kept>
+CC_ALWAYS_INLINE constexpr
+auto slice_kept(const size_t p) noexcept
+{
+	constexpr bool kept[] = {Kept...};
+	return kept[p];
+}
+
+/*
+** Returns the number of dimensions of the parent before `p` that are kept in
+** the view. This is the dimension of the view corresponding to dimension `p` of
+** the parent, if the latter is kept.
+*/
+template <bool... Kept>
+CC_ALWAYS_INLINE constexpr
+auto slice_rank(const size_t p) noexcept
+{
+	auto r = size_t{0};
+	for (auto i = size_t{0}; i != p; ++i) {
+		r += slice_kept<Kept...>(i);
+	}
+	return r;
+}
+
+/*
+** Returns the dimension of the parent corresponding to dimension `k` of the
+** view.
+*/
+template <bool... Kept>
+CC_ALWAYS_INLINE constexpr
+auto slice_dim(const size_t k) noexcept
+{
+	auto p = size_t{0};
+	for (auto n = size_t{0}; ; ++p) {
+		if (!slice_kept<Kept...>(p)) continue;
+		if (n == k) break;
+		++n;
+	}
+	return p;
+}
+
+template <class Order, size_t... Ps>
+CC_ALWAYS_INLINE constexpr
+auto order_value(const size_t j, std::index_sequence<Ps...>) noexcept
+{
+	constexpr unsigned order[] = {unsigned(std::decay_t<decltype(
+		std::declval<Order>().at_c(sc_coord<Ps>))>::value())...};
+	return order[j];
+}
+
+/*
+** The storage order of the view is the storage order of the parent, restricted
+** to the dimensions that are kept, and renumbered accordingly.
+*/
+template <class Order, bool... Kept>
+CC_ALWAYS_INLINE constexpr
+auto slice_order(const size_t k) noexcept
+{
+	using seq = std::make_index_sequence<sizeof...(Kept)>;
+
+	for (auto j = size_t{0}, n = size_t{0}; j != sizeof...(Kept); ++j) {
+		const auto p = order_value<Order>(j, seq{});
+		if (!slice_kept<Kept...>(p)) continue;
+		if (n == k) return unsigned(slice_rank<Kept...>(p));
+		++n;
+	}
+	return 0u;
+}
+
+}
+
+namespace tokens {
+
+static constexpr auto _ = detail::all_selector{};
+
+}
+
+template <class Start, class Finish, class Stride = unsigned>
+CC_ALWAYS_INLINE constexpr
+auto slice(const Start& a, const Finish& b, const Stride& s = 1) noexcept
+{ return detail::slice_selector<Start, Finish, Stride>{a, b, s}; }
+
+template <class Array, bool... Kept>
+class strided_view final
+{
+	static_assert(
+		std::is_lvalue_reference<Array>::value,
+		"Strided views can only refer to lvalues."
+	);
+
+	using parent_type  = std::decay_t<Array>;
+	using parent_order = std::decay_t<decltype(
+		std::declval<parent_type>().storage_order())>;
+
+	static constexpr auto parent_dims = sizeof...(Kept);
+	static constexpr auto view_dims = detail::slice_rank<Kept...>(parent_dims);
+
+	using parent_seq = std::make_index_sequence<parent_dims>;
+	using view_seq   = std::make_index_sequence<view_dims>;
+public:
+	using external_type = typename parent_type::external_type;
+	using size_type     = typename parent_type::size_type;
+	using integer       = typename std::decay_t<decltype(
+		std::declval<parent_type>().extents())>::integer;
+
+	static constexpr auto is_lazy = false;
+private:
+	using coords = std::array<integer, parent_dims>;
+
+	Array m_ref;
+	coords m_start;
+	coords m_finish;
+	coords m_strides;
+public:
+	CC_ALWAYS_INLINE
+	explicit strided_view(Array ref, const coords& start,
+		const coords& finish, const coords& strides) noexcept :
+	m_ref(ref), m_start(start), m_finish(finish), m_strides(strides) {}
+
+	CC_ALWAYS_INLINE
+	auto extents() const noexcept
+	{ return extents_helper(view_seq{}); }
+
+	CC_ALWAYS_INLINE constexpr
+	static auto storage_order() noexcept
+	{ return order_helper(view_seq{}); }
+
+	CC_ALWAYS_INLINE
+	auto window() const noexcept
+	{ return window_helper(parent_seq{}); }
+
+	template <class... Us>
+	CC_ALWAYS_INLINE
+	decltype(auto) at(const Us... us) noexcept
+	{
+		const integer cs[] = {integer(us)...};
+		return at_helper(cs, parent_seq{});
+	}
+
+	template <class... Us>
+	CC_ALWAYS_INLINE
+	decltype(auto) at(const Us... us) const noexcept
+	{
+		const integer cs[] = {integer(us)...};
+		return at_helper(cs, parent_seq{});
+	}
+private:
+	template <size_t P>
+	CC_ALWAYS_INLINE
+	auto length() const noexcept
+	{ return (m_finish[P] - m_start[P]) / m_strides[P] + 1; }
+
+	template <size_t... Ks>
+	CC_ALWAYS_INLINE
+	auto extents_helper(std::index_sequence<Ks...>) const noexcept
+	{ return nd::extents(length<detail::slice_dim<Kept...>(Ks)>()...); }
+
+	template <size_t... Ks>
+	CC_ALWAYS_INLINE constexpr
+	static auto order_helper(std::index_sequence<Ks...>) noexcept
+	{
+		return basic_sc_index<unsigned,
+			detail::slice_order<parent_order, Kept...>(Ks)...>;
+	}
+
+	template <size_t... Ps>
+	CC_ALWAYS_INLINE
+	auto window_helper(std::index_sequence<Ps...>) const noexcept
+	{
+		return make_range(
+			index<integer>(m_start[Ps]...),
+			index<integer>(m_finish[Ps]...),
+			index<integer>(m_strides[Ps]...)
+		);
+	}
+
+	/*
+	** Maps the coordinates of the view to those of the parent.
+	*/
+	template <size_t P>
+	CC_ALWAYS_INLINE
+	auto parent_coord(const integer* cs) const noexcept
+	{
+		constexpr auto k = detail::slice_rank<Kept...>(P);
+		return detail::slice_kept<Kept...>(P) ?
+			integer(m_start[P] + m_strides[P] * cs[k]) : m_start[P];
+	}
+
+	template <size_t... Ps>
+	CC_ALWAYS_INLINE
+	decltype(auto) at_helper(const integer* cs, std::index_sequence<Ps...>)
+	const noexcept
+	{ return m_ref(parent_coord<Ps>(cs)...); }
+};
+
+namespace detail {
+
+template <class Array, size_t... Ps, class... Ts>
+CC_ALWAYS_INLINE
+auto make_strided_view(Array& arr, std::index_sequence<Ps...>,
+	const Ts&... ts) noexcept
+{
+	using view    = strided_view<Array&, selector_traits<Ts>::is_kept...>;
+	using integer = typename view::integer;
+	using coords  = std::array<integer, sizeof...(Ts)>;
+	using expander = int[];
+
+	const auto e = arr.extents();
+	const auto first = coords{{integer(e.start(sc_coord<Ps>))...}};
+	const auto last = coords{{integer(e.finish(sc_coord<Ps>))...}};
+	auto a = coords{};
+	auto b = coords{};
+	auto s = coords{};
+
+	(void)expander{0, (selector_traits<Ts>::apply(ts, first[Ps], last[Ps],
+		a[Ps], b[Ps], s[Ps]), 0)...};
+
+	for (auto p = size_t{0}; p != sizeof...(Ts); ++p) {
+		nd_assert(
+			a[p] >= first[p] && b[p] <= last[p] &&
+			a[p] <= b[p] && s[p] > 0,
+			"invalid selector for dimension $.\n▶ Selected [$, $] "
+			"with stride $ from [$, $]",
+			p, a[p], b[p], s[p], first[p], last[p]
+		);
+		b[p] = a[p] + (b[p] - a[p]) / s[p] * s[p];
+	}
+	return array_wrapper<view>{view{arr, a, b, s}};
+}
+
+}
+
+template <class T, class... Ts, nd_enable_if((
+	sizeof...(Ts) == array_wrapper<T>::dims() &&
+	detail::is_slice_helper<Ts...>::value
+))>
+CC_ALWAYS_INLINE
+auto make_strided_view(array_wrapper<T>& arr, const Ts&... ts) noexcept
+{
+	return detail::make_strided_view(arr,
+		std::index_sequence_for<Ts...>{}, ts...);
+}
+
+template <class T, class... Ts, nd_enable_if((
+	sizeof...(Ts) == array_wrapper<T>::dims() &&
+	detail::is_slice_helper<Ts...>::value
+))>
+CC_ALWAYS_INLINE
+auto make_strided_view(const array_wrapper<T>& arr, const Ts&... ts) noexcept
+{
+	return detail::make_strided_view(arr,
+		std::index_sequence_for<Ts...>{}, ts...);
+}
+
+}
+
+#endif
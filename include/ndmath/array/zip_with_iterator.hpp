@@ -61,7 +61,7 @@ public:
 	using iterator_category = std::random_access_iterator_tag;
 private:
 	tuple<Ts...> m_iters;
-	const Func& m_func;
+	Func m_func;
 public:
 	CC_ALWAYS_INLINE constexpr
 	explicit zip_with_iterator(Ts&&... ts, const Func& func)
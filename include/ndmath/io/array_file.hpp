@@ -0,0 +1,382 @@
+/*
+** File Name: array_file.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Reads and writes arrays in a compact binary format. The header records the
+** element type, the byte order, and the number of dimensions, extents, and
+** storage order of the array. It is followed by the contents of the underlying
+** view of the array, so that arrays of booleans remain bit-packed. This is the
+** same format used by `mapped_storage`, so a file written by `save_array` can
+** be mapped using `open_mapped`, and vice versa.
+**
+** - `save_array(path, arr, opts)` writes `arr` in its own storage order. If
+**   `arr` does not store its elements contiguously (e.g. a lazy expression, or
+**   an array with padded rows), it is first evaluated into a temporary dense
+**   array.
+** - `load_array<T, Dims>(path, opts, order)` reads the file into a new dynamic
+**   array. The element type, number of dimensions, and storage order recorded
+**   in the file must match those requested.
+**
+** Arrays too large to hold in memory at once can be written or read
+** incrementally using the streaming classes returned by
+** `make_array_writer<T>(path, extents, opts, order)` and
+** `make_array_reader<T, Dims>(path, opts, order)`. Each call to `write` or
+** `read` transfers the underlying view of an array (or a range of underlying
+** elements) after the elements that have already been transferred. For
+** instance, a large three-dimensional array can be written one slice of the
+** slowest dimension at a time. Slices of boolean arrays are concatenated one
+** word at a time, so every slice but the last must have a multiple of the word
+** size elements.
+**
+** I/O is performed using large sequential transfers, optionally bypassing the
+** page cache (see `binary_stream.hpp`).
+*/
+
+#ifndef Z74E68E62_DE7E_4241_9500_D8093190083E
+#define Z74E68E62_DE7E_4241_9500_D8093190083E
+
+#include <ndmath/io/binary_stream.hpp>
+
+namespace nd {
+namespace detail {
+
+/*
+** Checks that the storage order of an array with `M` dimensions agrees with the
+** last `M` entries of the storage order of an array with `N` dimensions, once
+** the latter are renumbered. This is the case when the former array is a slice
+** of the slowest-varying dimensions of the latter.
+*/
+template <class Order, class SliceOrder, size_t N, size_t M>
+CC_ALWAYS_INLINE constexpr
+auto is_slice_order() noexcept
+{
+	using seq       = std::make_index_sequence<N>;
+	using slice_seq = std::make_index_sequence<M>;
+
+	if (M > N) return false;
+	for (auto k = size_t{0}; k != M; ++k) {
+		const auto p = order_value<Order>(N - M + k, seq{});
+		auto rank = unsigned{0};
+		for (auto j = N - M; j != N; ++j) {
+			if (order_value<Order>(j, seq{}) < p) ++rank;
+		}
+		if (order_value<SliceOrder>(k, slice_seq{}) != rank) return false;
+	}
+	return true;
+}
+
+/*
+** Indicates whether the underlying view of `Array` can be transferred directly
+** to or from a file for an array with element type `T` and the given storage
+** order. The array may have fewer dimensions than the file, as long as it is a
+** slice of the slowest-varying dimensions.
+*/
+template <
+	class Array,
+	class T,
+	class StorageOrder,
+	bool ProvidesUnderlyingView = Array::provides_underlying_view
+>
+struct is_raw_transferable
+{ static constexpr auto value = false; };
+
+template <class Array, class T, class StorageOrder>
+struct is_raw_transferable<Array, T, StorageOrder, true>
+{
+	using order = std::decay_t<decltype(
+		std::declval<const Array&>().storage_order())>;
+
+	static constexpr auto value =
+	std::is_pointer<typename Array::const_underlying_iterator>::value &&
+	std::is_same<typename Array::external_type, T>::value             &&
+	std::is_same<typename Array::underlying_type,
+		underlying_type<T>>::value                                    &&
+	is_slice_order<StorageOrder, order, StorageOrder::dims(),
+		order::dims()>();
+};
+
+template <class Range>
+CC_ALWAYS_INLINE
+auto raw_size(const Range& r) noexcept
+{ return size_t(r.end() - r.begin()); }
+
+}
+
+template <class T, size_t Dims, class StorageOrder>
+class array_writer final
+{
+	using helper = detail::dense_storage_access<T>;
+public:
+	using underlying_type = typename helper::underlying_type;
+private:
+	detail::output_file m_file;
+	size_t m_size;
+	size_t m_written{0};
+public:
+	template <class Extents>
+	CC_ALWAYS_INLINE
+	explicit array_writer(
+		const std::string& path,
+		const Extents& e,
+		const io_options& opts
+	) : m_file{path, opts},
+	m_size{helper::underlying_size(detail::extents_size<size_t>(e))}
+	{
+		static_assert(
+			Extents::dims() == Dims,
+			"Extents have the wrong number of dimensions."
+		);
+
+		char buf[detail::mapped_data_offset(Dims)];
+		detail::write_mapped_header<T, StorageOrder>(buf, e);
+		m_file.write(buf, sizeof(buf));
+	}
+
+	/*
+	** The number of underlying elements that remain to be written.
+	*/
+	CC_ALWAYS_INLINE
+	auto remaining() const noexcept
+	{ return m_size - m_written; }
+
+	CC_ALWAYS_INLINE
+	void write(const underlying_type* p, const size_t n)
+	{
+		nd_assert(n <= remaining(), "write exceeds size of array.\n"
+			"▶ Size of write: $; remaining underlying elements: $",
+			n, remaining());
+
+		m_file.write(p, sizeof(underlying_type) * n);
+		m_written += n;
+	}
+
+	template <class U>
+	CC_ALWAYS_INLINE
+	void write(const array_wrapper<U>& arr)
+	{
+		static_assert(
+			detail::is_raw_transferable<array_wrapper<U>, T,
+				StorageOrder>::value,
+			"Array must store its elements contiguously, and have the "
+			"same element type and storage order as the file, or as "
+			"a slice of the slowest-varying dimensions of the file."
+		);
+
+		const auto v = arr.underlying_view();
+		if (v.begin() != v.end()) {
+			write(&*v.begin(), detail::raw_size(v));
+		}
+	}
+
+	/*
+	** Throws `std::runtime_error` if fewer elements were written than are
+	** recorded in the header.
+	*/
+	CC_ALWAYS_INLINE
+	void close()
+	{
+		m_file.finish();
+		if (remaining() != 0) {
+			throw std::runtime_error{"array file closed before all "
+				"elements were written"};
+		}
+	}
+};
+
+template <class T, size_t Dims, class StorageOrder>
+class array_reader final
+{
+	using helper = detail::dense_storage_access<T>;
+public:
+	using underlying_type = typename helper::underlying_type;
+	using extents_type    = detail::mapped_extents<Dims>;
+private:
+	detail::input_file m_file;
+	extents_type m_extents;
+	size_t m_size;
+	size_t m_read{0};
+public:
+	CC_ALWAYS_INLINE
+	explicit array_reader(const std::string& path, const io_options& opts) :
+	m_file{path, opts}, m_extents{read_header(m_file)},
+	m_size{helper::underlying_size(detail::extents_size<size_t>(m_extents))}
+	{}
+
+	CC_ALWAYS_INLINE
+	auto& extents() const noexcept
+	{ return m_extents; }
+
+	CC_ALWAYS_INLINE constexpr
+	static auto storage_order() noexcept
+	{ return StorageOrder{}; }
+
+	/*
+	** The number of underlying elements that remain to be read.
+	*/
+	CC_ALWAYS_INLINE
+	auto remaining() const noexcept
+	{ return m_size - m_read; }
+
+	CC_ALWAYS_INLINE
+	void read(underlying_type* p, const size_t n)
+	{
+		nd_assert(n <= remaining(), "read exceeds size of array.\n"
+			"▶ Size of read: $; remaining underlying elements: $",
+			n, remaining());
+
+		m_file.read(p, sizeof(underlying_type) * n);
+		m_read += n;
+	}
+
+	template <class U>
+	CC_ALWAYS_INLINE
+	void read(array_wrapper<U>& arr)
+	{
+		static_assert(
+			detail::is_raw_transferable<array_wrapper<U>, T,
+				StorageOrder>::value,
+			"Array must store its elements contiguously, and have the "
+			"same element type and storage order as the file, or as "
+			"a slice of the slowest-varying dimensions of the file."
+		);
+
+		const auto v = arr.underlying_view();
+		if (v.begin() != v.end()) {
+			read(&*v.begin(), detail::raw_size(v));
+		}
+	}
+private:
+	CC_ALWAYS_INLINE
+	static auto read_header(detail::input_file& f)
+	{
+		char buf[detail::mapped_data_offset(Dims)];
+		f.read(buf, sizeof(buf));
+		return detail::read_mapped_header<T, StorageOrder, Dims>(buf,
+			f.path());
+	}
+};
+
+template <
+	class T,
+	class Extents,
+	class StorageOrder = std::decay_t<decltype(default_storage_order<Extents::dims()>)>,
+	nd_enable_if((
+		mpl::is_specialization_of<range, Extents>::value &&
+		mpl::is_specialization_of<index_wrapper, StorageOrder>::value
+	))
+>
+CC_ALWAYS_INLINE
+auto make_array_writer(
+	const std::string& path,
+	const Extents& e,
+	const io_options& opts = io_options{},
+	StorageOrder = default_storage_order<Extents::dims()>
+)
+{
+	using writer_type = array_writer<T, Extents::dims(), StorageOrder>;
+	return writer_type{path, e, opts};
+}
+
+template <
+	class T,
+	size_t Dims,
+	class StorageOrder = std::decay_t<decltype(default_storage_order<Dims>)>,
+	nd_enable_if((
+		mpl::is_specialization_of<index_wrapper, StorageOrder>::value
+	))
+>
+CC_ALWAYS_INLINE
+auto make_array_reader(
+	const std::string& path,
+	const io_options& opts = io_options{},
+	StorageOrder = default_storage_order<Dims>
+)
+{
+	using reader_type = array_reader<T, Dims, StorageOrder>;
+	return reader_type{path, opts};
+}
+
+namespace detail {
+
+template <bool IsRawTransferable>
+struct save_array_helper
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(const std::string& path, const array_wrapper<T>& arr,
+		const io_options& opts)
+	{
+		using external_type = typename array_wrapper<T>::external_type;
+		using alloc = aligned_allocator<underlying_type<external_type>>;
+
+		auto tmp = make_darray<external_type>(arr.extents(), alloc{},
+			arr.storage_order());
+		tmp = arr;
+		save_array_helper<true>::apply(path, tmp, opts);
+	}
+};
+
+template <>
+struct save_array_helper<true>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(const std::string& path, const array_wrapper<T>& arr,
+		const io_options& opts)
+	{
+		using external_type = typename array_wrapper<T>::external_type;
+
+		auto w = make_array_writer<external_type>(path, arr.extents(), opts,
+			arr.storage_order());
+		w.write(arr);
+		w.close();
+	}
+};
+
+}
+
+template <class T>
+CC_ALWAYS_INLINE
+void save_array(
+	const std::string& path,
+	const array_wrapper<T>& arr,
+	const io_options& opts = io_options{}
+)
+{
+	using array_type    = array_wrapper<T>;
+	using external_type = typename array_type::external_type;
+	using storage_order = std::decay_t<decltype(arr.storage_order())>;
+	using helper = detail::save_array_helper<detail::is_raw_transferable<
+		array_type, external_type, storage_order>::value>;
+
+	helper::apply(path, arr, opts);
+}
+
+template <
+	class T,
+	size_t Dims,
+	class StorageOrder = std::decay_t<decltype(default_storage_order<Dims>)>,
+	nd_enable_if((
+		mpl::is_specialization_of<index_wrapper, StorageOrder>::value
+	))
+>
+CC_ALWAYS_INLINE
+auto load_array(
+	const std::string& path,
+	const io_options& opts = io_options{},
+	StorageOrder order = default_storage_order<Dims>
+)
+{
+	using alloc = aligned_allocator<underlying_type<T>>;
+
+	auto r = make_array_reader<T, Dims>(path, opts, order);
+	auto arr = make_darray<T>(r.extents(), alloc{}, order);
+	r.read(arr);
+	return arr;
+}
+
+}
+
+#endif
@@ -0,0 +1,285 @@
+/*
+** File Name: binary_stream.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Buffered sequential access to files, used by the array file formats. Data is
+** moved between the buffer and the file in chunks of `io_options::chunk_size`
+** bytes, so that each system call transfers a large amount of data. Requests
+** at least as large as a chunk bypass the buffer when it is empty.
+**
+** If `io_options::direct` is set, the file is opened with `O_DIRECT` to bypass
+** the page cache. This avoids evicting useful pages when streaming arrays much
+** larger than memory. Every transfer then starts at a multiple of the chunk
+** size and is made from a buffer aligned to `io_block_size`. The final partial
+** chunk is padded, and the file is truncated to its actual length afterwards.
+** If the platform or file system does not support `O_DIRECT`, the option is
+** silently ignored.
+*/
+
+#ifndef Z852C45A4_53B8_4E4B_A80F_EAC7858DD82B
+#define Z852C45A4_53B8_4E4B_A80F_EAC7858DD82B
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ndmath/array/aligned_allocator.hpp>
+#include <ndmath/array/mapped_storage.hpp>
+
+namespace nd {
+
+/*
+** The alignment of the buffers, and the granularity of transfers when
+** `O_DIRECT` is used. This is the logical block size of most devices.
+*/
+static constexpr auto io_block_size = size_t{4096};
+
+struct io_options
+{
+	/*
+	** Rounded up to a multiple of `io_block_size`.
+	*/
+	size_t chunk_size{size_t{4} << 20};
+	bool direct{false};
+};
+
+namespace detail {
+
+using io_buffer = std::vector<char, aligned_allocator<char, io_block_size>>;
+
+CC_ALWAYS_INLINE
+auto io_chunk_size(const io_options& opts) noexcept
+{
+	const auto n = std::max(opts.chunk_size, io_block_size);
+	return (n + io_block_size - 1) / io_block_size * io_block_size;
+}
+
+/*
+** Opens the file using `O_DIRECT` if `direct` is set, falling back to ordinary
+** I/O if this is not supported. On return, `direct` indicates whether
+** `O_DIRECT` is in effect.
+*/
+inline auto open_file(const std::string& path, const int flags, bool& direct)
+{
+	#ifdef O_DIRECT
+		if (direct) {
+			const auto fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+			if (fd != -1) {
+				return file_descriptor{fd};
+			}
+			if (errno != EINVAL) {
+				throw_system_error("failed to open \"" + path + "\"");
+			}
+		}
+	#endif
+
+	direct = false;
+	return file_descriptor{path, flags};
+}
+
+class output_file final
+{
+	std::string m_path;
+	bool m_direct;
+	file_descriptor m_fd;
+	io_buffer m_buf;
+	size_t m_used{0};
+	size_t m_size{0};
+	bool m_finished{false};
+public:
+	CC_ALWAYS_INLINE
+	explicit output_file(const std::string& path, const io_options& opts) :
+	m_path{path}, m_direct{opts.direct},
+	m_fd{open_file(path, O_WRONLY | O_CREAT | O_TRUNC, m_direct)},
+	m_buf(io_chunk_size(opts)) {}
+
+	CC_ALWAYS_INLINE
+	output_file(output_file&& rhs) noexcept :
+	m_path{std::move(rhs.m_path)}, m_direct{rhs.m_direct},
+	m_fd{std::move(rhs.m_fd)}, m_buf{std::move(rhs.m_buf)},
+	m_used{rhs.m_used}, m_size{rhs.m_size}, m_finished{rhs.m_finished}
+	{ rhs.m_finished = true; }
+
+	/*
+	** Exceptions cannot be reported here, so `finish` should be called
+	** explicitly.
+	*/
+	CC_ALWAYS_INLINE
+	~output_file()
+	{
+		if (m_finished) return;
+		try { finish(); }
+		catch (...) {}
+	}
+
+	CC_ALWAYS_INLINE
+	auto size() const noexcept
+	{ return m_size; }
+
+	CC_ALWAYS_INLINE
+	void write(const void* src, size_t n)
+	{
+		auto p = static_cast<const char*>(src);
+		const auto chunk = m_buf.size();
+		m_size += n;
+
+		while (n != 0) {
+			if (m_used == 0 && !m_direct && n >= chunk) {
+				const auto m = n / chunk * chunk;
+				write_all(p, m);
+				p += m;
+				n -= m;
+				continue;
+			}
+
+			const auto k = std::min(n, chunk - m_used);
+			std::memcpy(m_buf.data() + m_used, p, k);
+			m_used += k;
+			p += k;
+			n -= k;
+
+			if (m_used == chunk) {
+				write_all(m_buf.data(), chunk);
+				m_used = 0;
+			}
+		}
+	}
+
+	/*
+	** Writes the contents of the buffer to the file. No further writes may
+	** be made afterwards.
+	*/
+	CC_ALWAYS_INLINE
+	void finish()
+	{
+		m_finished = true;
+		if (m_used == 0) return;
+
+		if (!m_direct) {
+			write_all(m_buf.data(), m_used);
+			return;
+		}
+
+		const auto n = (m_used + io_block_size - 1) / io_block_size *
+			io_block_size;
+		std::fill(m_buf.data() + m_used, m_buf.data() + n, 0);
+		write_all(m_buf.data(), n);
+
+		if (::ftruncate(m_fd.get(), off_t(m_size)) == -1) {
+			throw_system_error("failed to truncate \"" + m_path + "\"");
+		}
+	}
+private:
+	CC_ALWAYS_INLINE
+	void write_all(const char* p, size_t n)
+	{
+		while (n != 0) {
+			const auto r = ::write(m_fd.get(), p, n);
+			if (r == -1) {
+				if (errno == EINTR) continue;
+				throw_system_error("failed to write to \"" + m_path + "\"");
+			}
+			p += r;
+			n -= size_t(r);
+		}
+	}
+};
+
+class input_file final
+{
+	std::string m_path;
+	bool m_direct;
+	file_descriptor m_fd;
+	io_buffer m_buf;
+	size_t m_pos{0};
+	size_t m_end{0};
+public:
+	CC_ALWAYS_INLINE
+	explicit input_file(const std::string& path, const io_options& opts) :
+	m_path{path}, m_direct{opts.direct},
+	m_fd{open_file(path, O_RDONLY, m_direct)},
+	m_buf(io_chunk_size(opts))
+	{
+		#ifdef POSIX_FADV_SEQUENTIAL
+			if (!m_direct) {
+				::posix_fadvise(m_fd.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+			}
+		#endif
+	}
+
+	input_file(input_file&&) = default;
+
+	CC_ALWAYS_INLINE
+	auto& path() const noexcept
+	{ return m_path; }
+
+	/*
+	** Throws `std::runtime_error` if the end of the file is reached before
+	** `n` bytes have been read.
+	*/
+	CC_ALWAYS_INLINE
+	void read(void* dst, size_t n)
+	{
+		auto p = static_cast<char*>(dst);
+		const auto chunk = m_buf.size();
+
+		while (n != 0) {
+			if (m_pos == m_end) {
+				if (!m_direct && n >= chunk) {
+					const auto m = n / chunk * chunk;
+					if (read_some(p, m) != m) { throw_eof(); }
+					p += m;
+					n -= m;
+					continue;
+				}
+
+				m_pos = 0;
+				m_end = read_some(m_buf.data(), chunk);
+				if (m_end == 0) { throw_eof(); }
+			}
+
+			const auto k = std::min(n, m_end - m_pos);
+			std::memcpy(p, m_buf.data() + m_pos, k);
+			m_pos += k;
+			p += k;
+			n -= k;
+		}
+	}
+private:
+	/*
+	** Reads until `n` bytes have been read or the end of the file is
+	** reached. When `O_DIRECT` is in effect, a short read can only occur at
+	** the end of the file, and retrying it from an unaligned offset would
+	** fail.
+	*/
+	CC_ALWAYS_INLINE
+	size_t read_some(char* p, const size_t n)
+	{
+		auto k = size_t{0};
+		while (k != n) {
+			const auto r = ::read(m_fd.get(), p + k, n - k);
+			if (r == -1) {
+				if (errno == EINTR) continue;
+				throw_system_error("failed to read from \"" + m_path + "\"");
+			}
+			if (r == 0) break;
+			k += size_t(r);
+			if (m_direct) break;
+		}
+		return k;
+	}
+
+	[[noreturn]] CC_ALWAYS_INLINE
+	void throw_eof() const
+	{ throw std::runtime_error{"unexpected end of \"" + m_path + "\""}; }
+};
+
+}}
+
+#endif
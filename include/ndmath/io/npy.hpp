@@ -0,0 +1,441 @@
+/*
+** File Name: npy.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Reads and writes arrays of arithmetic types in the NumPy `.npy` format, so
+** that they can be exchanged with `numpy.load` and `numpy.save`.
+**
+** - `save_npy(path, arr, opts)`: if `arr` is contiguous and its storage order is
+**   row-major or column-major, its elements are written directly from its
+**   underlying view (with `fortran_order` set accordingly). Otherwise, `arr` is
+**   first evaluated into a temporary row-major array.
+** - `load_npy<T, Dims>(path, opts, order)`: the type descriptor in the file must
+**   match `T` exactly, since no conversion is performed. If the storage order of
+**   the file agrees with `order`, the elements are read directly into the
+**   result. Otherwise, the file is read into a temporary array that is then
+**   assigned to the result, which transposes the elements using a blocked copy.
+**
+** NumPy stores each boolean in a separate byte, so arrays of booleans are packed
+** and unpacked one element at a time. Version 1.0 of the format is written, and
+** versions 1.0 through 3.0 can be read.
+*/
+
+#ifndef ZCA4F5B9B_20F9_4ABB_ADD6_E722E821EFE8
+#define ZCA4F5B9B_20F9_4ABB_ADD6_E722E821EFE8
+
+#include <cstdlib>
+#include <vector>
+#include <ndmath/io/array_file.hpp>
+
+namespace nd {
+namespace detail {
+
+static constexpr char npy_magic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+
+/*
+** The header is padded so that the elements start at a multiple of this
+** number of bytes, as required by the format.
+*/
+static constexpr auto npy_alignment = size_t{64};
+
+enum class npy_layout
+{
+	row_major,
+	column_major,
+	other
+};
+
+template <class T>
+inline auto npy_descr()
+{
+	static_assert(
+		std::is_arithmetic<T>::value,
+		"Only arrays of arithmetic types can be stored in the NPY format."
+	);
+
+	const auto kind =
+		std::is_same<T, bool>::value     ? 'b' :
+		std::is_floating_point<T>::value ? 'f' :
+		std::is_signed<T>::value         ? 'i' : 'u';
+	const auto byte_order =
+		sizeof(T) == 1                               ? '|' :
+		__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__    ? '<' : '>';
+	return std::string{byte_order, kind} + std::to_string(sizeof(T));
+}
+
+template <class Order, size_t... Ks>
+CC_ALWAYS_INLINE constexpr
+auto layout_of(std::index_sequence<Ks...> seq) noexcept
+{
+	constexpr auto n = sizeof...(Ks);
+	auto row = true;
+	auto col = true;
+
+	for (auto k = size_t{0}; k != n; ++k) {
+		const auto v = order_value<Order>(k, seq);
+		row = row && v == k;
+		col = col && v == n - 1 - k;
+	}
+	return row ? npy_layout::row_major : col ? npy_layout::column_major :
+		npy_layout::other;
+}
+
+template <size_t... Ks>
+CC_ALWAYS_INLINE constexpr
+auto column_major_order(std::index_sequence<Ks...>) noexcept
+{ return basic_sc_index<unsigned, unsigned(sizeof...(Ks) - 1 - Ks)...>; }
+
+template <size_t Dims>
+using row_major_type = std::decay_t<decltype(default_storage_order<Dims>)>;
+
+template <size_t Dims>
+using column_major_type = std::decay_t<decltype(
+	column_major_order(std::make_index_sequence<Dims>{}))>;
+
+template <class T, class Extents, size_t... Ks>
+auto npy_header(const Extents& e, const bool fortran,
+	std::index_sequence<Ks...>)
+{
+	constexpr auto dims = sizeof...(Ks);
+	const size_t lens[] = {size_t(e.length(sc_coord<Ks>))...};
+
+	auto shape = std::string{"("};
+	for (auto k = size_t{0}; k != dims; ++k) {
+		shape += std::to_string(lens[k]);
+		shape += dims == 1 ? "," : k + 1 != dims ? ", " : "";
+	}
+	shape += ")";
+
+	auto dict = "{'descr': '" + npy_descr<T>() + "', 'fortran_order': " +
+		(fortran ? "True" : "False") + ", 'shape': " + shape + ", }";
+
+	// Magic string, version, and header length.
+	constexpr auto prefix = size_t{10};
+	const auto total = (prefix + dict.size() + 1 + npy_alignment - 1) /
+		npy_alignment * npy_alignment;
+	dict.append(total - prefix - dict.size() - 1, ' ');
+	dict += '\n';
+
+	const auto len = dict.size();
+	auto h = std::string(npy_magic, sizeof(npy_magic));
+	h += {'\x01', '\x00', char(len & 0xFF), char(len >> 8)};
+	return h + dict;
+}
+
+struct npy_header_info
+{
+	std::string descr;
+	bool fortran;
+	std::vector<size_t> shape;
+};
+
+[[noreturn]] inline
+void throw_npy_error(const std::string& path, const std::string& what)
+{ throw std::runtime_error{"\"" + path + "\": " + what}; }
+
+/*
+** Returns the position of the value associated with `key` in the dictionary
+** literal `s`.
+*/
+inline auto npy_value(const std::string& s, const std::string& key,
+	const std::string& path)
+{
+	auto i = s.find("'" + key + "'");
+	if (i == std::string::npos) {
+		i = s.find("\"" + key + "\"");
+	}
+	if (i == std::string::npos) {
+		throw_npy_error(path, "missing key \"" + key + "\" in header");
+	}
+
+	i = s.find(':', i + key.size() + 2);
+	if (i == std::string::npos) {
+		throw_npy_error(path, "malformed header");
+	}
+	return s.find_first_not_of(' ', i + 1);
+}
+
+inline auto parse_npy_header(const std::string& s, const std::string& path)
+{
+	auto info = npy_header_info{};
+
+	auto i = npy_value(s, "descr", path);
+	if (i == std::string::npos || (s[i] != '\'' && s[i] != '"')) {
+		throw_npy_error(path, "unsupported type descriptor");
+	}
+	const auto j = s.find(s[i], i + 1);
+	if (j == std::string::npos) {
+		throw_npy_error(path, "malformed header");
+	}
+	info.descr = s.substr(i + 1, j - i - 1);
+
+	i = npy_value(s, "fortran_order", path);
+	if (i == std::string::npos) {
+		throw_npy_error(path, "malformed header");
+	}
+	if (s.compare(i, 4, "True") == 0) {
+		info.fortran = true;
+	}
+	else if (s.compare(i, 5, "False") == 0) {
+		info.fortran = false;
+	}
+	else {
+		throw_npy_error(path, "malformed header");
+	}
+
+	i = npy_value(s, "shape", path);
+	if (i == std::string::npos || s[i] != '(') {
+		throw_npy_error(path, "malformed header");
+	}
+	for (++i;;) {
+		i = s.find_first_not_of(", ", i);
+		if (i == std::string::npos) {
+			throw_npy_error(path, "malformed header");
+		}
+		if (s[i] == ')') break;
+
+		char* end;
+		info.shape.push_back(size_t(std::strtoull(s.c_str() + i, &end, 10)));
+		if (end == s.c_str() + i) {
+			throw_npy_error(path, "malformed header");
+		}
+		i = size_t(end - s.c_str());
+	}
+	return info;
+}
+
+inline auto read_npy_header(input_file& f)
+{
+	char magic[8];
+	f.read(magic, sizeof(magic));
+	if (std::memcmp(magic, npy_magic, sizeof(npy_magic)) != 0) {
+		throw_npy_error(f.path(), "not an NPY file");
+	}
+
+	const auto major = int(static_cast<unsigned char>(magic[6]));
+	unsigned char b[4] = {};
+	if (major == 1) {
+		f.read(b, 2);
+	}
+	else if (major == 2 || major == 3) {
+		f.read(b, 4);
+	}
+	else {
+		throw_npy_error(f.path(), "unsupported version " +
+			std::to_string(major));
+	}
+
+	const auto len = size_t(b[0]) | size_t(b[1]) << 8 | size_t(b[2]) << 16 |
+		size_t(b[3]) << 24;
+	auto s = std::string(len, '\0');
+	f.read(&s[0], len);
+	return parse_npy_header(s, f.path());
+}
+
+template <size_t... Ks>
+CC_ALWAYS_INLINE
+auto npy_extents(const std::vector<size_t>& shape, std::index_sequence<Ks...>)
+noexcept
+{ return nd::extents(unsigned(shape[Ks])...); }
+
+/*
+** Transfers the elements between the file and the array, in the storage order
+** of the array.
+*/
+template <bool IsBoolean>
+struct npy_payload
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void write(output_file& f, const array_wrapper<T>& arr)
+	{
+		using type = typename array_wrapper<T>::underlying_type;
+		const auto v = arr.underlying_view();
+		if (v.begin() != v.end()) {
+			f.write(&*v.begin(), sizeof(type) * raw_size(v));
+		}
+	}
+
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void read(input_file& f, array_wrapper<T>& arr)
+	{
+		using type = typename array_wrapper<T>::underlying_type;
+		const auto v = arr.underlying_view();
+		if (v.begin() != v.end()) {
+			f.read(&*v.begin(), sizeof(type) * raw_size(v));
+		}
+	}
+};
+
+template <>
+struct npy_payload<true>
+{
+	static constexpr auto buffer_size = size_t{4096};
+
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void write(output_file& f, const array_wrapper<T>& arr)
+	{
+		char buf[buffer_size];
+		auto n = size_t{0};
+
+		for (const auto& x : arr.flat_view()) {
+			buf[n++] = bool(x);
+			if (n == buffer_size) {
+				f.write(buf, n);
+				n = 0;
+			}
+		}
+		f.write(buf, n);
+	}
+
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void read(input_file& f, array_wrapper<T>& arr)
+	{
+		char buf[buffer_size];
+		auto v = arr.flat_view();
+		auto it = v.begin();
+		auto rem = size_t(v.end() - v.begin());
+
+		while (rem != 0) {
+			const auto n = std::min(rem, buffer_size);
+			f.read(buf, n);
+			for (auto i = size_t{0}; i != n; ++i, ++it) {
+				*it = buf[i] != 0;
+			}
+			rem -= n;
+		}
+	}
+};
+
+template <bool IsRawTransferable>
+struct save_npy_helper
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(const std::string& path, const array_wrapper<T>& arr,
+		const io_options& opts)
+	{
+		using external_type = typename array_wrapper<T>::external_type;
+		using alloc = aligned_allocator<underlying_type<external_type>>;
+		using order = row_major_type<array_wrapper<T>::dims()>;
+
+		auto tmp = make_darray<external_type>(arr.extents(), alloc{},
+			order{});
+		tmp = arr;
+		save_npy_helper<true>::apply(path, tmp, opts);
+	}
+};
+
+template <>
+struct save_npy_helper<true>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(const std::string& path, const array_wrapper<T>& arr,
+		const io_options& opts)
+	{
+		using array_type    = array_wrapper<T>;
+		using external_type = typename array_type::external_type;
+		using storage_order = std::decay_t<decltype(arr.storage_order())>;
+		using seq           = std::make_index_sequence<array_type::dims()>;
+		using payload = npy_payload<std::is_same<external_type, bool>::value>;
+
+		constexpr auto fortran =
+			layout_of<storage_order>(seq{}) == npy_layout::column_major;
+		const auto h = npy_header<external_type>(arr.extents(), fortran,
+			seq{});
+
+		auto f = output_file{path, opts};
+		f.write(h.data(), h.size());
+		payload::write(f, arr);
+		f.finish();
+	}
+};
+
+}
+
+template <class T>
+CC_ALWAYS_INLINE
+void save_npy(
+	const std::string& path,
+	const array_wrapper<T>& arr,
+	const io_options& opts = io_options{}
+)
+{
+	using array_type    = array_wrapper<T>;
+	using external_type = typename array_type::external_type;
+	using storage_order = std::decay_t<decltype(arr.storage_order())>;
+	using seq           = std::make_index_sequence<array_type::dims()>;
+
+	constexpr auto feasible =
+		detail::is_raw_transferable<array_type, external_type,
+			storage_order>::value &&
+		detail::layout_of<storage_order>(seq{}) != detail::npy_layout::other;
+
+	detail::save_npy_helper<feasible>::apply(path, arr, opts);
+}
+
+template <
+	class T,
+	size_t Dims,
+	class StorageOrder = std::decay_t<decltype(default_storage_order<Dims>)>,
+	nd_enable_if((
+		mpl::is_specialization_of<index_wrapper, StorageOrder>::value
+	))
+>
+auto load_npy(
+	const std::string& path,
+	const io_options& opts = io_options{},
+	StorageOrder order = default_storage_order<Dims>
+)
+{
+	using seq     = std::make_index_sequence<Dims>;
+	using alloc   = aligned_allocator<underlying_type<T>>;
+	using payload = detail::npy_payload<std::is_same<T, bool>::value>;
+
+	auto f = detail::input_file{path, opts};
+	const auto h = detail::read_npy_header(f);
+
+	if (h.descr != detail::npy_descr<T>()) {
+		detail::throw_npy_error(path, "type descriptor \"" + h.descr +
+			"\" does not match \"" + detail::npy_descr<T>() + "\"");
+	}
+	if (h.shape.size() != Dims) {
+		detail::throw_npy_error(path, "array has " +
+			std::to_string(h.shape.size()) + " dimensions instead of " +
+			std::to_string(Dims));
+	}
+
+	const auto e = detail::npy_extents(h.shape, seq{});
+	auto arr = make_darray<T>(e, alloc{}, order);
+
+	constexpr auto layout = detail::layout_of<StorageOrder>(seq{});
+	const auto file_layout = h.fortran ? detail::npy_layout::column_major :
+		detail::npy_layout::row_major;
+
+	if (Dims == 1 || layout == file_layout) {
+		payload::read(f, arr);
+	}
+	else if (h.fortran) {
+		using order_type = detail::column_major_type<Dims>;
+		auto tmp = make_darray<T>(e, alloc{}, order_type{});
+		payload::read(f, tmp);
+		arr = tmp;
+	}
+	else {
+		using order_type = detail::row_major_type<Dims>;
+		auto tmp = make_darray<T>(e, alloc{}, order_type{});
+		payload::read(f, tmp);
+		arr = tmp;
+	}
+	return arr;
+}
+
+}
+
+#endif
@@ -13,6 +13,17 @@
 namespace nd {
 namespace detail {
 
+/*
+** Used in place of `std::ratio`, whose numerator cannot represent words whose
+** most significant bit is set.
+*/
+template <class Integer, Integer Value>
+struct packed_word
+{
+	static constexpr auto num = Value;
+	static constexpr auto den = Integer{1};
+};
+
 template <class Integer, class List>
 struct pack_bools_helper
 {
@@ -50,7 +61,7 @@ struct pack_bools_helper
 		>
 	>;
 
-	using type = std::ratio<result::value, 1>;
+	using type = packed_word<Integer, result::value>;
 };
 
 }
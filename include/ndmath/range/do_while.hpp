@@ -8,6 +8,8 @@
 #ifndef Z69A569F7_1502_431F_8D01_F893B3221436
 #define Z69A569F7_1502_431F_8D01_F893B3221436
 
+#include <algorithm>
+#include <ndmath/range/range.hpp>
 #include <ndmath/range/loop_optimization.hpp>
 
 namespace nd {
@@ -511,12 +513,29 @@ struct evaluate_loop_helper
 	}
 };
 
+template <size_t Dim, size_t Dims, class Attribs, bool Noexcept>
+struct block_loop_helper;
+
 template <size_t Dim, size_t Dims, class Attribs, bool Noexcept>
 struct evaluator
 {
 	using next = evaluator<Dim + 1, Dims, Attribs, Noexcept>;
 
-	template <class Range, class Func, class... Args>
+	static constexpr auto is_blocked = Dim == 0 &&
+	has_blocked_loop(static_cast<Attribs*>(nullptr));
+
+	template <class Range, class Func, nd_enable_if(is_blocked)>
+	CC_ALWAYS_INLINE
+	static auto apply(const Range& r, const Func& f)
+	noexcept(Noexcept)
+	{
+		using helper = block_loop_helper<0, Dims, Attribs, Noexcept>;
+		return helper::apply(r, f);
+	}
+
+	template <class Range, class Func, class... Args, nd_enable_if(
+		!is_blocked
+	)>
 	CC_ALWAYS_INLINE
 	static auto apply(const Range& r, const Func& f, const Args&... args)
 	noexcept(Noexcept)
@@ -537,7 +556,73 @@ struct evaluator<Dims, Dims, Attribs, Noexcept>
 	template <class Range, class Func, class... Args>
 	CC_ALWAYS_INLINE
 	static auto apply(const Range&, const Func& f, const Args&... args)
-	noexcept(Noexcept) { return f(c_index(args...)); }
+	noexcept(Noexcept) { return f(make_loop_index<Attribs>(args...)); }
+};
+
+/*
+** See `for_each.hpp`. The traversal stops at the first block in which the
+** function returns false.
+*/
+template <size_t Dim, size_t Dims, class Attribs, bool Noexcept>
+struct block_loop_helper
+{
+	using attrib = mpl::at_c<Dim, Attribs>;
+	using dir_h  = direction_helper<typename attrib::dir>;
+	using next   = block_loop_helper<
+		Dim + 1, Dims,
+		set_loop_block_policy<Dim, unblocked, Attribs>,
+		Noexcept
+	>;
+
+	static constexpr auto coord = attrib::coord;
+	static constexpr auto block = attrib::block_policy::factor;
+
+	template <class Range, class Func, nd_enable_if(block == 0)>
+	CC_ALWAYS_INLINE
+	static auto apply(const Range& r, const Func& f)
+	noexcept(Noexcept) { return next::apply(r, f); }
+
+	template <class Range, class Func, nd_enable_if(block != 0)>
+	CC_ALWAYS_INLINE
+	static auto apply(const Range& r, const Func& f)
+	noexcept(Noexcept)
+	{
+		using integer = typename Range::integer;
+		static constexpr auto n = sc_coord<coord>;
+
+		const auto size  = integer(block);
+		const auto step  = integer(size * r.stride(n));
+		const auto iters = integer(r.length(n) / r.stride(n));
+		const auto count = integer((iters + size - 1) / size);
+
+		for (
+			auto i = dir_h::start(integer{0}, integer(count - 1));
+			i != dir_h::finish(integer{0}, integer(count - 1), count);
+			dir_h::step(i, integer{1})
+		)
+		{
+			const auto first = integer(r.start(n) + i * step);
+			const auto last  = std::min(
+				integer(first + step - r.stride(n)),
+				integer(r.finish(n))
+			);
+			if (!next::apply(restrict_range<coord>(r, first, last), f)) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+template <size_t Dims, class Attribs, bool Noexcept>
+struct block_loop_helper<Dims, Dims, Attribs, Noexcept>
+{
+	using nest = evaluator<0, Dims, Attribs, Noexcept>;
+
+	template <class Range, class Func>
+	CC_ALWAYS_INLINE
+	static auto apply(const Range& r, const Func& f)
+	noexcept(Noexcept) { return nest::apply(r, f); }
 };
 
 }}}
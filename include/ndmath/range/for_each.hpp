@@ -8,7 +8,20 @@
 #ifndef Z84AD1502_83F3_4952_8D89_597D97AD842A
 #define Z84AD1502_83F3_4952_8D89_597D97AD842A
 
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <ndmath/range/range.hpp>
 #include <ndmath/range/loop_optimization.hpp>
+#include <ndmath/utility/thread_pool.hpp>
+
+/*
+** Ranges with fewer elements than this are always evaluated serially, even if
+** one of the loops is parallelized.
+*/
+#ifndef nd_parallel_threshold
+	#define nd_parallel_threshold 32768
+#endif
 
 namespace nd {
 namespace detail {
@@ -392,8 +405,8 @@ private:
 	static void validate(const Range& r) noexcept
 	{
 		nd_assert(
-			(!unroll_rem &&
-			(r.length(n) / (r.stride(n) * tile_fac)) % unroll_fac != 0),
+			(unroll_rem ||
+			(r.length(n) / (r.stride(n) * tile_fac)) % unroll_fac == 0),
 			"unrolling requires remainder loop, but remainder option "
 			"is set to false.\n▶ Number of tiles is $; unroll factor "
 			"is $; but $1 % $2 != 0",
@@ -401,12 +414,12 @@ private:
 		);
 
 		nd_assert(
-			(!tile_rem && r.length(n) % (r.stride(n) * tile_fac) != 0),
+			(tile_rem || r.length(n) % (r.stride(n) * tile_fac) == 0),
 			"tiling requires remainder loop, but remainder option "
 			"is set to false.\n▶ Length of range is $ - $ + $ = $; "
 			"length of tile is $ * $ = $; but $4 % $7 != 0",
 			r.finish(n), r.start(n), r.stride(n), r.length(n),
-			r.stride(n), tile_fac, r.stride(n) * r.tile_fac
+			r.stride(n), tile_fac, r.stride(n) * tile_fac
 		);
 	}
 };
@@ -503,12 +516,69 @@ struct evaluate_loop_helper
 	}
 };
 
+template <size_t Dim, size_t Dims, class Attribs, bool Noexcept>
+struct parallel_loop_helper;
+
+template <size_t Dim, size_t Dims, class Attribs, bool Noexcept>
+struct block_loop_helper;
+
+template <size_t Dims, class Attribs, bool Noexcept>
+struct wavefront_helper;
+
+/*
+** The wavefront and the block loops are generated before the loop nest is
+** evaluated. If the outermost loop is parallel, then each of its chunks is
+** blocked separately.
+*/
 template <size_t Dim, size_t Dims, class Attribs, bool Noexcept>
 struct evaluator
 {
 	using next = evaluator<Dim + 1, Dims, Attribs, Noexcept>;
+	using parallel_policy = typename mpl::at_c<Dim, Attribs>::parallel_policy;
 
-	template <class Range, class Func, class... Args>
+	static constexpr auto is_wavefront = Dim == 0 &&
+	wavefront_loop_count(static_cast<Attribs*>(nullptr)) != 0;
+
+	static constexpr auto is_serial = !is_wavefront &&
+	std::is_same<parallel_policy, serial>::value;
+
+	static constexpr auto is_blocked = Dim == 0 &&
+	has_blocked_loop(static_cast<Attribs*>(nullptr));
+
+	template <class Range, class Func, nd_enable_if(is_wavefront)>
+	CC_ALWAYS_INLINE
+	static void apply(const Range& r, const Func& f)
+	noexcept(Noexcept)
+	{
+		using helper = wavefront_helper<Dims, Attribs, Noexcept>;
+		helper::apply(r, f);
+	}
+
+	template <class Range, class Func, class... Args, nd_enable_if(
+		!is_wavefront && !is_serial
+	)>
+	CC_ALWAYS_INLINE
+	static void apply(const Range& r, const Func& f, const Args&... args)
+	noexcept(Noexcept)
+	{
+		using helper = parallel_loop_helper<Dim, Dims, Attribs, Noexcept>;
+		helper::apply(r, f, args...);
+	}
+
+	template <class Range, class Func, nd_enable_if(
+		is_serial && is_blocked
+	)>
+	CC_ALWAYS_INLINE
+	static void apply(const Range& r, const Func& f)
+	noexcept(Noexcept)
+	{
+		using helper = block_loop_helper<0, Dims, Attribs, Noexcept>;
+		helper::apply(r, f);
+	}
+
+	template <class Range, class Func, class... Args, nd_enable_if(
+		is_serial && !is_blocked
+	)>
 	CC_ALWAYS_INLINE
 	static void apply(const Range& r, const Func& f, const Args&... args)
 	noexcept(Noexcept)
@@ -529,7 +599,337 @@ struct evaluator<Dims, Dims, Attribs, Noexcept>
 	template <class Range, class Func, class... Args>
 	CC_ALWAYS_INLINE
 	static void apply(const Range&, const Func& f, const Args&... args)
-	noexcept(Noexcept) { f(c_index(args...)); }
+	noexcept(Noexcept) { f(make_loop_index<Attribs>(args...)); }
+};
+
+/*
+** Splits the loop `Dim` into chunks whose lengths are multiples of the tile
+** size times the unroll factor, so that the tile and unroll policies can be
+** applied within each chunk without introducing extra remainder loops. The
+** chunks are evaluated by the thread pool using the same attributes, except
+** that the loop is marked as serial.
+*/
+template <size_t Dim, size_t Dims, class Attribs, bool Noexcept>
+struct parallel_loop_helper
+{
+	using attrib          = mpl::at_c<Dim, Attribs>;
+	using serial_attribs  = set_loop_parallel_policy<Dim, serial, Attribs>;
+	using chunk_evaluator = evaluator<Dim, Dims, serial_attribs, Noexcept>;
+
+	static_assert(
+		attrib::unroll_policy::factor != full_unroll,
+		"Full unrolling cannot be combined with parallelization."
+	);
+
+	static constexpr auto coord = attrib::coord;
+	static constexpr auto grain = attrib::parallel_policy::grain;
+	static constexpr auto block =
+	attrib::unroll_policy::factor * attrib::tile_policy::factor;
+
+	template <class Range, class Func, class... Args>
+	CC_ALWAYS_INLINE
+	static void apply(const Range& r, const Func& f, const Args&... args)
+	noexcept(Noexcept)
+	{
+		using integer = typename Range::integer;
+		static constexpr auto n = sc_coord<coord>;
+
+		auto& pool = thread_pool::instance();
+		const auto threads = pool.concurrency();
+		const auto iters = size_t(r.length(n) / r.stride(n));
+
+		if (
+			in_parallel_region() || threads == 1 ||
+			size_t(r.size()) < nd_parallel_threshold ||
+			iters < 2 * block
+		) {
+			chunk_evaluator::apply(r, f, args...);
+			return;
+		}
+
+		/*
+		** Use a few chunks per thread, so that the threads that finish
+		** early can steal work from the others.
+		*/
+		auto len = std::max(size_t{grain}, (iters + 4 * threads - 1) / (4 * threads));
+		len = (len + block - 1) / block * block;
+		const auto chunks = (iters + len - 1) / len;
+
+		pool.run(chunks, [&] (const size_t i) {
+			const auto first = integer(i * len);
+			const auto last  = integer(std::min(iters, (i + 1) * len) - 1);
+
+			chunk_evaluator::apply(
+				restrict_range<coord>(r,
+					r.start(n) + first * r.stride(n),
+					r.start(n) + last * r.stride(n)),
+				f, args...
+			);
+		});
+	}
+};
+
+/*
+** Generates the loop over the blocks of each blocked loop, from the outermost
+** loop inward, and evaluates the loop nest over each multidimensional block.
+** Along each blocked coordinate, the range is restricted to the current block,
+** and the block policy of the loop is cleared.
+*/
+template <size_t Dim, size_t Dims, class Attribs, bool Noexcept>
+struct block_loop_helper
+{
+	using attrib = mpl::at_c<Dim, Attribs>;
+	using dir_h  = direction_helper<typename attrib::dir>;
+	using next   = block_loop_helper<
+		Dim + 1, Dims,
+		set_loop_block_policy<Dim, unblocked, Attribs>,
+		Noexcept
+	>;
+
+	static constexpr auto coord = attrib::coord;
+	static constexpr auto block = attrib::block_policy::factor;
+
+	template <class Range, class Func, nd_enable_if(block == 0)>
+	CC_ALWAYS_INLINE
+	static void apply(const Range& r, const Func& f)
+	noexcept(Noexcept) { next::apply(r, f); }
+
+	template <class Range, class Func, nd_enable_if(block != 0)>
+	CC_ALWAYS_INLINE
+	static void apply(const Range& r, const Func& f)
+	noexcept(Noexcept)
+	{
+		using integer = typename Range::integer;
+		static constexpr auto n = sc_coord<coord>;
+
+		const auto size  = integer(block);
+		const auto step  = integer(size * r.stride(n));
+		const auto iters = integer(r.length(n) / r.stride(n));
+		const auto count = integer((iters + size - 1) / size);
+
+		for (
+			auto i = dir_h::start(integer{0}, integer(count - 1));
+			i != dir_h::finish(integer{0}, integer(count - 1), count);
+			dir_h::step(i, integer{1})
+		)
+		{
+			const auto first = integer(r.start(n) + i * step);
+			const auto last  = std::min(
+				integer(first + step - r.stride(n)),
+				integer(r.finish(n))
+			);
+			next::apply(restrict_range<coord>(r, first, last), f);
+		}
+	}
+};
+
+template <size_t Dims, class Attribs, bool Noexcept>
+struct block_loop_helper<Dims, Dims, Attribs, Noexcept>
+{
+	using nest = evaluator<0, Dims, Attribs, Noexcept>;
+
+	template <class Range, class Func>
+	CC_ALWAYS_INLINE
+	static void apply(const Range& r, const Func& f)
+	noexcept(Noexcept) { nest::apply(r, f); }
+};
+
+/*
+** Restricts the range to a point or block of the wavefront along each
+** wavefront loop, and clears the wavefront and block policies of these loops.
+** `K` is the position of the loop among the wavefront loops.
+*/
+template <size_t Dim, size_t Dims, size_t K, class Attribs, bool Noexcept>
+struct wavefront_unit_helper
+{
+	using attrib = mpl::at_c<Dim, Attribs>;
+
+	static constexpr auto coord  = attrib::coord;
+	static constexpr auto weight = attrib::wavefront_policy::weight;
+	static constexpr auto block  = attrib::block_policy::factor == 0 ?
+		size_t{1} : attrib::block_policy::factor;
+	static constexpr auto is_forward =
+	std::is_same<typename attrib::dir, forward>::value;
+
+	static_assert(
+		weight == 0 ||
+		std::is_same<typename attrib::parallel_policy, serial>::value,
+		"Wavefront loops cannot be parallelized; the points of each "
+		"hyperplane are already evaluated in parallel."
+	);
+
+	using next = wavefront_unit_helper<
+		Dim + 1, Dims, K + (weight != 0 ? 1 : 0),
+		std::conditional_t<weight == 0, Attribs,
+			set_loop_block_policy<Dim, unblocked,
+			set_loop_wavefront_policy<Dim, no_wavefront, Attribs>>>,
+		Noexcept
+	>;
+
+	/*
+	** Stores the number of points or blocks along each wavefront loop, and
+	** the weight of the loop.
+	*/
+	template <class Range, class Sizes, nd_enable_if(weight == 0)>
+	CC_ALWAYS_INLINE
+	static void sizes(const Range& r, Sizes& counts, Sizes& weights)
+	noexcept { next::sizes(r, counts, weights); }
+
+	template <class Range, class Sizes, nd_enable_if(weight != 0)>
+	CC_ALWAYS_INLINE
+	static void sizes(const Range& r, Sizes& counts, Sizes& weights)
+	noexcept
+	{
+		using integer = typename Range::integer;
+		static constexpr auto n = sc_coord<coord>;
+
+		const auto iters = integer(r.length(n) / r.stride(n));
+		counts[K]  = integer((iters + integer(block) - 1) / integer(block));
+		weights[K] = integer(weight);
+		next::sizes(r, counts, weights);
+	}
+
+	template <class Range, class Sizes, class Func, nd_enable_if(
+		weight == 0
+	)>
+	CC_ALWAYS_INLINE
+	static void apply(
+		const Range& r,
+		const Sizes& counts,
+		const Sizes& unit,
+		const Func& f
+	) noexcept(Noexcept) { next::apply(r, counts, unit, f); }
+
+	template <class Range, class Sizes, class Func, nd_enable_if(
+		weight != 0
+	)>
+	CC_ALWAYS_INLINE
+	static void apply(
+		const Range& r,
+		const Sizes& counts,
+		const Sizes& unit,
+		const Func& f
+	) noexcept(Noexcept)
+	{
+		using integer = typename Range::integer;
+		static constexpr auto n = sc_coord<coord>;
+
+		const auto i     = is_forward ? unit[K] : counts[K] - 1 - unit[K];
+		const auto step  = integer(integer(block) * r.stride(n));
+		const auto first = integer(r.start(n) + i * step);
+		const auto last  = std::min(
+			integer(first + step - r.stride(n)),
+			integer(r.finish(n))
+		);
+		next::apply(restrict_range<coord>(r, first, last), counts,
+			unit, f);
+	}
+};
+
+template <size_t Dims, size_t K, class Attribs, bool Noexcept>
+struct wavefront_unit_helper<Dims, Dims, K, Attribs, Noexcept>
+{
+	using nest = evaluator<0, Dims, Attribs, Noexcept>;
+
+	template <class Range, class Sizes>
+	CC_ALWAYS_INLINE
+	static void sizes(const Range&, Sizes&, Sizes&) noexcept {}
+
+	template <class Range, class Sizes, class Func>
+	CC_ALWAYS_INLINE
+	static void apply(const Range& r, const Sizes&, const Sizes&, const Func& f)
+	noexcept(Noexcept) { nest::apply(r, f); }
+};
+
+/*
+** Visits the hyperplanes of the wavefront in order. The points or blocks of
+** each hyperplane are listed, and evaluated in parallel if the hyperplane is
+** expected to contain at least `nd_parallel_threshold` elements.
+*/
+template <size_t Dims, class Attribs, bool Noexcept>
+struct wavefront_helper
+{
+	using unit_helper = wavefront_unit_helper<0, Dims, 0, Attribs, Noexcept>;
+
+	static constexpr auto loops =
+	wavefront_loop_count(static_cast<Attribs*>(nullptr));
+
+	template <class Range, class Func>
+	static void apply(const Range& r, const Func& f)
+	noexcept(Noexcept)
+	{
+		using integer = typename Range::integer;
+		using sizes   = std::array<integer, loops>;
+
+		auto counts  = sizes{};
+		auto weights = sizes{};
+		unit_helper::sizes(r, counts, weights);
+
+		auto units = size_t{1};
+		auto last  = integer{0};
+		for (auto k = size_t{0}; k != loops; ++k) {
+			units *= size_t(counts[k]);
+			last  += weights[k] * (counts[k] - 1);
+		}
+
+		auto& pool = thread_pool::instance();
+		const auto unit_size = size_t(r.size()) / units;
+		const auto serial = in_parallel_region() ||
+			pool.concurrency() == 1;
+
+		auto plane = std::vector<sizes>{};
+		auto unit  = sizes{};
+
+		for (auto h = integer{0}; h != integer(last + 1); ++h) {
+			plane.clear();
+			list(size_t{0}, h, counts, weights, unit, plane);
+
+			const auto elems = plane.size() * unit_size;
+			if (serial || elems < nd_parallel_threshold) {
+				for (const auto& u : plane) {
+					unit_helper::apply(r, counts, u, f);
+				}
+				continue;
+			}
+
+			pool.run(plane.size(), [&] (const size_t i) {
+				unit_helper::apply(r, counts, plane[i], f);
+			});
+		}
+	}
+private:
+	/*
+	** Lists the units `u` such that `sum_k weights[k] * u[k] == h`. The
+	** coordinates of `u` before `k` are already fixed.
+	*/
+	template <class Sizes, class Integer>
+	static void list(
+		const size_t k,
+		const Integer h,
+		const Sizes& counts,
+		const Sizes& weights,
+		Sizes& unit,
+		std::vector<Sizes>& plane
+	)
+	{
+		if (k + 1 == loops) {
+			if (h % weights[k] == 0 && h / weights[k] < counts[k]) {
+				unit[k] = h / weights[k];
+				plane.push_back(unit);
+			}
+			return;
+		}
+
+		for (
+			auto i = Integer{0};
+			i != counts[k] && i * weights[k] <= h;
+			++i
+		) {
+			unit[k] = i;
+			list(k + 1, Integer(h - i * weights[k]), counts,
+				weights, unit, plane);
+		}
+	}
 };
 
 }}}
@@ -6,7 +6,8 @@
 **
 ** A loop nest is associated with a sequence of loops, and each loop is
 ** described by a loop attribute. Each attribute is associated with a direction,
-** unroll policy, and tile policy.
+** unroll policy, tile policy, parallel policy, block policy, and wavefront
+** policy.
 */
 
 #ifndef ZF3EF39F0_BFDC_412B_9107_0706F4B3BE3D
@@ -46,16 +47,88 @@ struct tile_policy
 	static constexpr auto has_rem = HasRem;
 };
 
+/*
+** A loop with the `parallel` policy is split into chunks of at least `Grain`
+** iterations, which are evaluated by the threads of `thread_pool::instance()`.
+** A grain of zero lets the chunk size be chosen based on the number of threads.
+** The unroll and tile policies of the loop are applied within each chunk.
+*/
+struct serial {};
+
+template <size_t Grain = 0>
+struct parallel
+{ static constexpr auto grain = Grain; };
+
+/*
+** The tile policy strip-mines a loop in place, so tiling several loops does not
+** change the order in which the elements are visited. A loop with the
+** `block_policy<N>` policy is instead split into blocks of `N` iterations, and
+** the loop over the blocks is hoisted outside of the loop nest. If several
+** loops are blocked, then their block loops are nested in the same order as the
+** loops themselves, so that the loop nest is evaluated one multidimensional
+** block at a time (e.g. a 32 x 32 block of a matrix). The last block along each
+** coordinate holds the remaining iterations. The unroll and tile policies are
+** applied within each block, so `N` should be a multiple of the tile size times
+** the unroll factor. A factor of zero disables blocking.
+*/
+template <size_t N>
+struct block_policy
+{ static constexpr auto factor = N; };
+
+using unblocked = block_policy<0>;
+
+/*
+** The loops with a `wavefront_policy<W>` are skewed into a wavefront: if the
+** loop over coordinate `k` has weight `w_k`, then the points of the loop nest
+** are visited in order of the hyperplanes `sum_k w_k * n_k = h` for increasing
+** `h`, where `n_k` counts the iterations of the loop from its first one. Since
+** every point that precedes a given point along any of the loops lies on an
+** earlier hyperplane, an update that only reads the points before it (e.g. an
+** in-place Gauss-Seidel sweep) can evaluate the points of each hyperplane in
+** parallel. They are evaluated by the threads of `thread_pool::instance()`.
+** The wavefront is only used by `for_each`; `do_while` visits the points in the
+** usual order.
+**
+** If a wavefront loop is also blocked, then the wavefront is formed by the
+** blocks along that coordinate instead of the points, and the points of each
+** block are visited in the usual order. The loops without a wavefront policy
+** are evaluated in full for each point or block of the wavefront. A weight of
+** zero disables the wavefront.
+**
+** For an iterative stencil, time can be made one of the coordinates of the
+** range. A point also reads the neighbors ahead of it on the previous time
+** step, so the time loop is given a weight of two. To tile the iterations in
+** time as well as space, the spatial coordinates are instead skewed by the time
+** step, i.e. the index `(t, i)` is mapped to the point `(t, i - t)`, and the
+** loops are blocked with a weight of one.
+*/
+template <size_t Weight>
+struct wavefront_policy
+{ static constexpr auto weight = Weight; };
+
+using no_wavefront = wavefront_policy<0>;
+
 /*
 ** Definition of loop attribute.
 */
-template <size_t Coord, class Dir, class UnrollPolicy, class TilingPolicy>
+template <
+	size_t Coord,
+	class Dir,
+	class UnrollPolicy,
+	class TilingPolicy,
+	class ParallelPolicy = serial,
+	class BlockPolicy = unblocked,
+	class WavefrontPolicy = no_wavefront
+>
 struct attrib
 {
 	static constexpr auto coord = Coord;
-	using dir           = Dir;
-	using unroll_policy = UnrollPolicy;
-	using tile_policy   = TilingPolicy;
+	using dir             = Dir;
+	using unroll_policy   = UnrollPolicy;
+	using tile_policy     = TilingPolicy;
+	using parallel_policy = ParallelPolicy;
+	using block_policy    = BlockPolicy;
+	using wavefront_policy = WavefrontPolicy;
 };
 
 namespace detail {
@@ -108,7 +181,10 @@ using set_coord = attrib<
 	Coord::type::value,
 	typename Attrib::dir,
 	typename Attrib::unroll_policy,
-	typename Attrib::tile_policy
+	typename Attrib::tile_policy,
+	typename Attrib::parallel_policy,
+	typename Attrib::block_policy,
+	typename Attrib::wavefront_policy
 >;
 
 template <class Dir, class Attrib>
@@ -116,7 +192,10 @@ using set_dir = attrib<
 	Attrib::coord,
 	Dir,
 	typename Attrib::unroll_policy,
-	typename Attrib::tile_policy
+	typename Attrib::tile_policy,
+	typename Attrib::parallel_policy,
+	typename Attrib::block_policy,
+	typename Attrib::wavefront_policy
 >;
 
 template <class Policy, class Attrib>
@@ -124,7 +203,10 @@ using set_unroll_policy = attrib<
 	Attrib::coord,
 	typename Attrib::dir,
 	Policy,
-	typename Attrib::tile_policy
+	typename Attrib::tile_policy,
+	typename Attrib::parallel_policy,
+	typename Attrib::block_policy,
+	typename Attrib::wavefront_policy
 >;
 
 template <class Policy, class Attrib>
@@ -132,6 +214,42 @@ using set_tile_policy = attrib<
 	Attrib::coord,
 	typename Attrib::dir,
 	typename Attrib::unroll_policy,
+	Policy,
+	typename Attrib::parallel_policy,
+	typename Attrib::block_policy,
+	typename Attrib::wavefront_policy
+>;
+
+template <class Policy, class Attrib>
+using set_parallel_policy = attrib<
+	Attrib::coord,
+	typename Attrib::dir,
+	typename Attrib::unroll_policy,
+	typename Attrib::tile_policy,
+	Policy,
+	typename Attrib::block_policy,
+	typename Attrib::wavefront_policy
+>;
+
+template <class Policy, class Attrib>
+using set_block_policy = attrib<
+	Attrib::coord,
+	typename Attrib::dir,
+	typename Attrib::unroll_policy,
+	typename Attrib::tile_policy,
+	typename Attrib::parallel_policy,
+	Policy,
+	typename Attrib::wavefront_policy
+>;
+
+template <class Policy, class Attrib>
+using set_wavefront_policy = attrib<
+	Attrib::coord,
+	typename Attrib::dir,
+	typename Attrib::unroll_policy,
+	typename Attrib::tile_policy,
+	typename Attrib::parallel_policy,
+	typename Attrib::block_policy,
 	Policy
 >;
 
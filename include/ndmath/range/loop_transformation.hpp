@@ -10,6 +10,7 @@
 #ifndef Z4591CB1E_C8EE_424D_BDBB_B0625A28BB62
 #define Z4591CB1E_C8EE_424D_BDBB_B0625A28BB62
 
+#include <tuple>
 #include <ndmath/range/loop_attribute.hpp>
 
 namespace nd {
@@ -72,6 +73,78 @@ mpl::fold<
 	mpl::reverse_args<mpl::quote_trait<detail::apply_trans>>
 >;
 
+namespace detail {
+
+/*
+** Returns the position of the loop that iterates over coordinate `c`. The
+** attribute list is passed by pointer, since `mpl::list` need not be a
+** complete type.
+*/
+template <class... Ts>
+CC_ALWAYS_INLINE constexpr
+auto loop_of_coord(const size_t c, mpl::list<Ts...>*) noexcept
+{
+	const size_t coords[] = {Ts::coord...};
+	auto i = size_t{0};
+	while (coords[i] != c) { ++i; }
+	return i;
+}
+
+template <class... Ts>
+CC_ALWAYS_INLINE constexpr
+auto has_blocked_loop(mpl::list<Ts...>*) noexcept
+{
+	const bool blocked[] = {(Ts::block_policy::factor != 0)...};
+	for (const auto b : blocked) {
+		if (b) { return true; }
+	}
+	return false;
+}
+
+/*
+** Returns the number of loops that are part of the wavefront.
+*/
+template <class... Ts>
+CC_ALWAYS_INLINE constexpr
+auto wavefront_loop_count(mpl::list<Ts...>*) noexcept
+{
+	const size_t weights[] = {Ts::wavefront_policy::weight...};
+	auto count = size_t{0};
+	for (const auto w : weights) {
+		if (w != 0) { ++count; }
+	}
+	return count;
+}
+
+template <class Attribs, size_t... Coords, class... Args>
+CC_ALWAYS_INLINE constexpr
+auto make_loop_index_helper(
+	std::index_sequence<Coords...>,
+	const Args&... args
+) noexcept
+{
+	const auto t = std::tie(args...);
+	return c_index(std::get<
+		loop_of_coord(Coords, static_cast<Attribs*>(nullptr))
+	>(t)...);
+}
+
+/*
+** The loop evaluators collect the counters of a loop nest in the order in
+** which the loops are nested. If the loops have been permuted, this differs
+** from the order of the coordinates, so the counters are rearranged before
+** they are passed to the function.
+*/
+template <class Attribs, class... Args>
+CC_ALWAYS_INLINE constexpr
+auto make_loop_index(const Args&... args) noexcept
+{
+	using seq = std::index_sequence_for<Args...>;
+	return make_loop_index_helper<Attribs>(seq{}, args...);
+}
+
+}
+
 template <size_t Loop, class Policy, class Attribs>
 using set_loop_unroll_policy =
 mpl::set_at_c<
@@ -88,6 +161,30 @@ mpl::set_at_c<
 	Attribs
 >;
 
+template <size_t Loop, class Policy, class Attribs>
+using set_loop_parallel_policy =
+mpl::set_at_c<
+	Loop,
+	set_parallel_policy<Policy, mpl::at_c<Loop, Attribs>>,
+	Attribs
+>;
+
+template <size_t Loop, class Policy, class Attribs>
+using set_loop_block_policy =
+mpl::set_at_c<
+	Loop,
+	set_block_policy<Policy, mpl::at_c<Loop, Attribs>>,
+	Attribs
+>;
+
+template <size_t Loop, class Policy, class Attribs>
+using set_loop_wavefront_policy =
+mpl::set_at_c<
+	Loop,
+	set_wavefront_policy<Policy, mpl::at_c<Loop, Attribs>>,
+	Attribs
+>;
+
 }
 
 #endif
@@ -20,7 +20,7 @@
 #include <ndmath/range/loop_attribute.hpp>
 #include <ndmath/range/loop_transformation.hpp>
 #include <ndmath/range/traversal.hpp>
-//#include <ndmath/range/range_iterator.hpp>
+#include <ndmath/range/range_iterator.hpp>
 
 namespace nd {
 
@@ -77,10 +77,9 @@ public:
 
 	using self           = range<Start, Finish, Stride, Attribs>;
 	using integer        = typename Start::integer;
-	/*
+	using attribs        = Attribs;
 	using iterator       = range_iterator<self>;
 	using const_iterator = iterator;
-	*/
 
 	static constexpr auto allows_static_access =
 	Start::allows_static_access  &&
@@ -239,20 +238,66 @@ public:
 		return new_range{m_start, m_finish, m_strides};
 	}
 
+	/*
+	** Evaluates the given loop in parallel, using chunks of at least `Grain`
+	** iterations. See `loop_attribute.hpp`.
+	*/
+	template <size_t Loop, size_t Grain = 0>
+	CC_ALWAYS_INLINE constexpr
+	auto parallelize() const noexcept
+	{
+		using policy = parallel<Grain>;
+		using attribs = set_loop_parallel_policy<Loop, policy, Attribs>;
+		using new_range = range<Start, Finish, Stride, attribs>;
+		return new_range{m_start, m_finish, m_strides};
+	}
+
+	/*
+	** Splits the given loop into blocks of `N` iterations, and hoists the
+	** loop over the blocks outside of the loop nest. See
+	** `loop_attribute.hpp`.
+	*/
+	template <size_t Loop, size_t N>
+	CC_ALWAYS_INLINE constexpr
+	auto block() const noexcept
+	{
+		using policy = block_policy<N>;
+		using attribs = set_loop_block_policy<Loop, policy, Attribs>;
+		using new_range = range<Start, Finish, Stride, attribs>;
+		return new_range{m_start, m_finish, m_strides};
+	}
+
+	/*
+	** Adds the given loop to the wavefront with the given weight. See
+	** `loop_attribute.hpp`.
+	*/
+	template <size_t Loop, size_t Weight = 1>
+	CC_ALWAYS_INLINE constexpr
+	auto wavefront() const noexcept
+	{
+		using policy = wavefront_policy<Weight>;
+		using attribs = set_loop_wavefront_policy<Loop, policy, Attribs>;
+		using new_range = range<Start, Finish, Stride, attribs>;
+		return new_range{m_start, m_finish, m_strides};
+	}
+
 	template <class Func>
 	CC_ALWAYS_INLINE void
 	operator()(const Func& f) const
 	nd_deduce_noexcept(for_each(*this, f))
 
 	/*
-	CC_ALWAYS_INLINE constexpr
+	** See `range_iterator.hpp`. In performance-sensitive code, prefer
+	** `operator()`, or iterate over `segments(*this)`.
+	*/
+
+	CC_ALWAYS_INLINE
 	auto begin() const noexcept
 	{ return iterator{*this}; }
 
-	CC_ALWAYS_INLINE constexpr
+	CC_ALWAYS_INLINE
 	auto end() const noexcept
-	{ return iterator{*this}; }
-	*/
+	{ return iterator{*this, range_end}; }
 };
 
 template <
@@ -284,19 +329,15 @@ auto operator!=(
 	const range<Start2, Finish2, Stride2, Attribs2>& rhs
 ) noexcept { return !(lhs == rhs); }
 
-/*
-** TODO: uncomment once implemented.
-**
-** template <class Start, class Finish, class Stride, class Attribs>
-** CC_ALWAYS_INLINE constexpr
-** auto begin(const range<Start, Finish, Stride, Attribs>& r)
-** noexcept { return r.begin(); }
-** 
-** template <class Start, class Finish, class Stride, class Attribs>
-** CC_ALWAYS_INLINE constexpr
-** auto end(const range<Start, Finish, Stride, Attribs>& r)
-** noexcept { return r.end(); }
-*/
+template <class Start, class Finish, class Stride, class Attribs>
+CC_ALWAYS_INLINE
+auto begin(const range<Start, Finish, Stride, Attribs>& r)
+noexcept { return r.begin(); }
+
+template <class Start, class Finish, class Stride, class Attribs>
+CC_ALWAYS_INLINE
+auto end(const range<Start, Finish, Stride, Attribs>& r)
+noexcept { return r.end(); }
 
 template <
 	class Char, class Traits, class Start,
@@ -379,6 +420,69 @@ auto make_range(const Finish& e) noexcept
 	return make_range(basic_sc_index_n<integer, dims, 0>, e);
 }
 
+namespace detail {
+
+template <bool Replace>
+struct replace_coord_helper;
+
+template <>
+struct replace_coord_helper<true>
+{
+	template <class Coord, class Integer>
+	CC_ALWAYS_INLINE constexpr
+	static auto apply(const Coord&, const Integer x) noexcept
+	{ return x; }
+};
+
+template <>
+struct replace_coord_helper<false>
+{
+	template <class Coord, class Integer>
+	CC_ALWAYS_INLINE constexpr
+	static auto apply(const Coord& c, Integer) noexcept
+	{ return c; }
+};
+
+template <size_t K, class Index, class Integer, size_t... Ts>
+CC_ALWAYS_INLINE constexpr
+auto replace_coord(
+	const Index& i,
+	const Integer x,
+	std::index_sequence<Ts...>
+) noexcept
+{
+	return c_index<Integer>(
+		replace_coord_helper<Ts == K>::apply(i.at_c(sc_coord<Ts>), x)...
+	);
+}
+
+}
+
+/*
+** Returns a copy of `r` whose bounds along coordinate `K` are replaced by `a`
+** and `b`. The bounds along the other coordinates and the loop attributes are
+** preserved, so that the loop optimizations can still exploit extents that are
+** known at compile time. This is used to split a loop into chunks.
+*/
+template <size_t K, class Start, class Finish, class Stride, class Attribs>
+CC_ALWAYS_INLINE constexpr
+auto restrict_range(
+	const range<Start, Finish, Stride, Attribs>& r,
+	const typename Start::integer a,
+	const typename Start::integer b
+) noexcept
+{
+	using seq = std::make_index_sequence<Start::dims()>;
+	using start  = decltype(detail::replace_coord<K>(r.start(), a, seq{}));
+	using finish = decltype(detail::replace_coord<K>(r.finish(), b, seq{}));
+
+	return range<start, finish, Stride, Attribs>{
+		detail::replace_coord<K>(r.start(), a, seq{}),
+		detail::replace_coord<K>(r.finish(), b, seq{}),
+		r.strides()
+	};
+}
+
 template <class Integer, Integer... Ts>
 static constexpr auto basic_sc_range =
 make_range(nd::basic_sc_index<Integer, Ts...>);
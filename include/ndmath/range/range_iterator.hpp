@@ -4,244 +4,535 @@
 ** Date:      01/10/2015
 ** Contact:   _@adityaramesh.com
 **
-** Don't use `range_iterator` if you want the fastest code possible (read note
-** 2). Use `range.operator()` or `for_each` instead.
+** Iterators over the indices of a range, so that ranges can be used with
+** range-for and with the standard algorithms. The loops are traversed in the
+** order and directions given by the attributes of the range (see `permute` and
+** `reverse`), but the other policies (e.g. `tile` and `block`) are ignored;
+** use `range.operator()` or `for_each` to apply them.
 **
-** Note 1: comparing two `range_iterator`s does *not* really check whether they
-** are equal. The comparison operation only checks whether the first index of
-** the LHS is equal to the first extent of the RHS. This decision is motivated
-** by the range-for's requirement that `begin` and `end` return the same type.
-** Since the comparison operation is performed at each iteration, it must be
-** very efficient if we are to compete with the performance of real for loops.
-** Instead of doing an honest comparison, I use this cheat to improve
-** performance. For this reason, `range_iterator`s are *not* safe to use in
-** general algorithms.
+** There are two ways to iterate over a range:
 **
-** Note 2: Using the `range_iterator` tends to generate slightly worse code than
-** nested for loops. Clang-3.5 creates a label for each for loop in a nest and
-** uses a series of inc/dec, cmp, and jne instructions to perform the
-** iterations. When `range_iterator` is used, clang-3.5 is unable to recognize
-** that the if statements in `increment_helper` are structured in the same way.
-** Instead of directly using jne, clang-3.5 uses cmp, followed by cmov/movzb to
-** eliminate the branch in the if statement. Unfortunately, this results in
-** slightly slower code (on average, about 2--3% slower when comparing
-** equivalent loops that have empty `asm` statements in their bodies to prevent
-** optimizations). If you want the best code possible or wish to perform
-** specific loop optimizations, do not use `range_iterator`.
+** - `range_iterator` visits each index in turn. Incrementing the iterator
+**   advances the innermost loop, and carries into the enclosing loops when the
+**   innermost loop reaches its end. Two iterators are equal if their positions
+**   are equal; the counters are compared from the innermost loop outward, so
+**   the comparison usually fails after checking one counter.
+** - `segments(r)` is a view over the segments of `r`. Each segment consists of
+**   the indices visited by the innermost loop for a fixed value of the
+**   counters of the enclosing loops, and is itself a range of indices:
+**
+**	for (const auto& s : nd::segments(r)) {
+**		for (const auto& i : s) { ... }
+**	}
+**
+** Note: the segmented form is the one to use in performance-sensitive code.
+** With `range_iterator`, the carry logic lives in the body of the innermost
+** loop, and clang-3.5 was observed to compile the chain of conditionals in the
+** increment into cmov/movzb sequences rather than branches, which made loops
+** over `range_iterator` about 2--3% slower than the equivalent nested loops.
+** The increment of a segment iterator only touches the innermost counter, and
+** the comparison only checks that counter, so each level of the segmented
+** loop is an ordinary counted loop. This is verified by `rake asm_check`,
+** which compares the assembly of `source/test/range_iterator_asm.cpp` against
+** nested loops, and measured by `source/test/range_perf_test.cpp`.
 */
 
 #ifndef ZFD9FC7F1_55E8_4F94_B4E3_AF47F504AABB
 #define ZFD9FC7F1_55E8_4F94_B4E3_AF47F504AABB
 
-#include <boost/range/algorithm.hpp>
-#include <ccbase/mpl.hpp>
+#include <cstddef>
+#include <iterator>
+#include <ndmath/range/loop_transformation.hpp>
 
 namespace nd {
-
 namespace detail {
 
-template <size_t CurDim>
+/*
+** The first value taken by the counter of the given loop, the last value, and
+** the value after the last, taking the direction of the loop into account.
+*/
+template <size_t Loop, class Attribs>
+struct loop_bounds
+{
+	using attrib = mpl::at_c<Loop, Attribs>;
+	static constexpr auto coord = attrib::coord;
+	static constexpr auto is_forward =
+	std::is_same<typename attrib::dir, forward>::value;
+
+	template <class Range>
+	CC_ALWAYS_INLINE constexpr
+	static auto first(const Range& r) noexcept
+	{
+		return is_forward ? r.start(sc_coord<coord>) :
+			r.finish(sc_coord<coord>);
+	}
+
+	template <class Range>
+	CC_ALWAYS_INLINE constexpr
+	static auto last(const Range& r) noexcept
+	{
+		return is_forward ? r.finish(sc_coord<coord>) :
+			r.start(sc_coord<coord>);
+	}
+
+	template <class Range>
+	CC_ALWAYS_INLINE constexpr
+	static auto past(const Range& r) noexcept
+	{
+		return is_forward ?
+			r.finish(sc_coord<coord>) + r.stride(sc_coord<coord>) :
+			r.start(sc_coord<coord>) - r.stride(sc_coord<coord>);
+	}
+
+	template <class Integer, class Range>
+	CC_ALWAYS_INLINE
+	static void next(Integer& x, const Range& r) noexcept
+	{
+		if (is_forward) x += r.stride(sc_coord<coord>);
+		else x -= r.stride(sc_coord<coord>);
+	}
+
+	template <class Integer, class Range>
+	CC_ALWAYS_INLINE
+	static void prev(Integer& x, const Range& r) noexcept
+	{
+		if (is_forward) x -= r.stride(sc_coord<coord>);
+		else x += r.stride(sc_coord<coord>);
+	}
+};
+
+/*
+** Advances the counter of loop `Loop`, carrying into the enclosing loops. The
+** counter of the outermost loop is left at its value after the last, which
+** marks the end of the range.
+*/
+template <size_t Loop, class Attribs>
 struct increment_helper
 {
-	using next = increment_helper<CurDim - 1>;
+	using bounds = loop_bounds<Loop, Attribs>;
+	using next   = increment_helper<Loop - 1, Attribs>;
 
 	template <class Index, class Range>
-	CC_ALWAYS_INLINE static void
-	apply(Index& i, const Range& r) noexcept
+	CC_ALWAYS_INLINE
+	static void apply(Index& i, const Range& r) noexcept
 	{
-		i(CurDim) += r.stride(CurDim);
-		if (i(CurDim) == r.extent(CurDim)) {
-			i(CurDim) = r.base(CurDim);
+		auto& x = i(sc_coord<bounds::coord>);
+		bounds::next(x, r);
+		if (x == bounds::past(r)) {
+			x = bounds::first(r);
 			next::apply(i, r);
 		}
 	}
 };
 
-template <>
-struct increment_helper<0>
+template <class Attribs>
+struct increment_helper<0, Attribs>
 {
+	using bounds = loop_bounds<0, Attribs>;
+
 	template <class Index, class Range>
-	CC_ALWAYS_INLINE static void
-	apply(Index& i, const Range& r)
-	noexcept { i(0) += r.stride(0); }
+	CC_ALWAYS_INLINE
+	static void apply(Index& i, const Range& r) noexcept
+	{ bounds::next(i(sc_coord<bounds::coord>), r); }
 };
 
-template <size_t CurDim>
+template <size_t Loop, class Attribs>
 struct decrement_helper
 {
-	using next = decrement_helper<CurDim - 1>;
+	using bounds = loop_bounds<Loop, Attribs>;
+	using next   = decrement_helper<Loop - 1, Attribs>;
 
 	template <class Index, class Range>
-	CC_ALWAYS_INLINE static void
-	apply(Index& i, const Range& r)
-	noexcept
+	CC_ALWAYS_INLINE
+	static void apply(Index& i, const Range& r) noexcept
 	{
-		if (i(CurDim) == r.base(CurDim)) {
-			i(CurDim) = r.extent(CurDim);
-			return next::apply(i, r);
+		auto& x = i(sc_coord<bounds::coord>);
+		if (x == bounds::first(r)) {
+			x = bounds::last(r);
+			next::apply(i, r);
+		}
+		else {
+			bounds::prev(x, r);
 		}
-		i(CurDim) -= r.stride(CurDim);
 	}
 };
 
-template <>
-struct decrement_helper<0>
+template <class Attribs>
+struct decrement_helper<0, Attribs>
 {
+	using bounds = loop_bounds<0, Attribs>;
+
 	template <class Index, class Range>
-	CC_ALWAYS_INLINE static void
-	apply(Index& i, const Range& r)
-	noexcept { i(0) -= r.stride(0); }
+	CC_ALWAYS_INLINE
+	static void apply(Index& i, const Range& r) noexcept
+	{ bounds::prev(i(sc_coord<bounds::coord>), r); }
 };
 
+// Compares the counters of loops `Loop` through zero, innermost first.
+template <size_t Loop, class Attribs>
+struct position_equal_helper
+{
+	static constexpr auto c = sc_coord<mpl::at_c<Loop, Attribs>::coord>;
+	using next = position_equal_helper<Loop - 1, Attribs>;
+
+	template <class Index>
+	CC_ALWAYS_INLINE constexpr
+	static auto apply(const Index& i, const Index& j) noexcept
+	{ return i(c) == j(c) && next::apply(i, j); }
+};
+
+template <class Attribs>
+struct position_equal_helper<0, Attribs>
+{
+	static constexpr auto c = sc_coord<mpl::at_c<0, Attribs>::coord>;
+
+	template <class Index>
+	CC_ALWAYS_INLINE constexpr
+	static auto apply(const Index& i, const Index& j) noexcept
+	{ return i(c) == j(c); }
+};
+
+template <class Range, size_t... Coords>
+CC_ALWAYS_INLINE constexpr
+auto first_position(const Range& r, std::index_sequence<Coords...>) noexcept
+{
+	using attribs = typename Range::attribs;
+	using integer = typename Range::integer;
+	return nd::index<integer>(loop_bounds<
+		loop_of_coord(Coords, static_cast<attribs*>(nullptr)), attribs
+	>::first(r)...);
+}
+
+template <class Range>
+CC_ALWAYS_INLINE constexpr
+auto first_position(const Range& r) noexcept
+{ return first_position(r, std::make_index_sequence<Range::dims()>{}); }
+
+/*
+** The position after the last: the counter of the outermost loop is at its
+** value after the last, and the others are at their first values.
+*/
+template <class Range>
+CC_ALWAYS_INLINE
+auto end_position(const Range& r) noexcept
+{
+	using bounds = loop_bounds<0, typename Range::attribs>;
+	auto i = first_position(r);
+	i(sc_coord<bounds::coord>) = bounds::past(r);
+	return i;
+}
+
 }
 
+struct range_end_t {};
+static constexpr auto range_end = range_end_t{};
+
 template <class Range>
-class range_iterator
+class range_iterator final
 {
 	static constexpr auto dims = Range::dims();
-	using integer              = typename Range::integer;
-	using position_type        = index_wrapper<index<integer, dims>>;
-	using increment_helper     = detail::increment_helper<dims - 1>;
-	using decrement_helper     = detail::decrement_helper<dims - 1>;
+	using attribs          = typename Range::attribs;
+	using position_type    = decltype(detail::first_position(std::declval<Range>()));
+	using increment_helper = detail::increment_helper<dims - 1, attribs>;
+	using decrement_helper = detail::decrement_helper<dims - 1, attribs>;
+	using equal_helper     = detail::position_equal_helper<dims - 1, attribs>;
 
 	position_type m_pos;
-	const Range& m_range;
+	const Range* m_range;
 public:
-	using difference_type   = void;
-	using value_type        = const position_type&;
-	using pointer           = void;
-	using reference         = void;
+	using difference_type   = std::ptrdiff_t;
+	using value_type        = position_type;
+	using pointer           = const position_type*;
+	using reference         = const position_type&;
 	using iterator_category = std::bidirectional_iterator_tag;
 
-	CC_ALWAYS_INLINE constexpr
-	explicit range_iterator(const Range& r)
-	noexcept : m_pos{r.bases()}, m_range{r} {}
-
 	CC_ALWAYS_INLINE
-	range_iterator(const range_iterator&) = default;
+	explicit range_iterator(const Range& r) noexcept :
+	m_pos{detail::first_position(r)}, m_range{&r} {}
 
 	CC_ALWAYS_INLINE
-	range_iterator(range_iterator&&) = default;
-
-	CC_ALWAYS_INLINE auto&
-	operator=(const range_iterator& rhs) noexcept
-	{ m_pos = rhs.m_pos; return *this; }
-
-	CC_ALWAYS_INLINE auto&
-	operator=(range_iterator&& rhs) noexcept
-	{ m_pos = rhs.m_pos; return *this; }
-
-	/*
-	** Accessors.
-	*/
+	explicit range_iterator(const Range& r, range_end_t) noexcept :
+	m_pos{detail::end_position(r)}, m_range{&r} {}
 
-	CC_ALWAYS_INLINE const auto&
-	operator*() const noexcept
+	CC_ALWAYS_INLINE
+	reference operator*() const noexcept
 	{ return m_pos; }
 
-	CC_ALWAYS_INLINE const auto*
-	operator->() const noexcept
+	CC_ALWAYS_INLINE
+	pointer operator->() const noexcept
 	{ return &m_pos; }
 
-	CC_ALWAYS_INLINE auto
-	operator++(int) noexcept
+	CC_ALWAYS_INLINE
+	auto& operator++() noexcept
+	{
+		increment_helper::apply(m_pos, *m_range);
+		return *this;
+	}
+
+	CC_ALWAYS_INLINE
+	auto& operator--() noexcept
+	{
+		decrement_helper::apply(m_pos, *m_range);
+		return *this;
+	}
+
+	CC_ALWAYS_INLINE
+	auto operator++(int) noexcept
 	{ auto t = *this; ++(*this); return t; }
 
-	CC_ALWAYS_INLINE auto
-	operator--(int) noexcept
+	CC_ALWAYS_INLINE
+	auto operator--(int) noexcept
 	{ auto t = *this; --(*this); return t; }
 
-	CC_ALWAYS_INLINE auto&
-	operator++() noexcept
+	CC_ALWAYS_INLINE
+	auto operator==(const range_iterator& rhs) const noexcept
+	{ return equal_helper::apply(m_pos, rhs.m_pos); }
+
+	CC_ALWAYS_INLINE
+	auto operator!=(const range_iterator& rhs) const noexcept
+	{ return !(*this == rhs); }
+};
+
+/*
+** An iterator over the indices of a single segment. Only the counter of the
+** innermost loop changes, so only that counter is compared.
+*/
+template <class Range>
+class segment_iterator final
+{
+	static constexpr auto dims = Range::dims();
+	using bounds        = detail::loop_bounds<dims - 1, typename Range::attribs>;
+	using position_type = decltype(detail::first_position(std::declval<Range>()));
+
+	static constexpr auto c = sc_coord<bounds::coord>;
+
+	position_type m_pos;
+	const Range* m_range;
+public:
+	using difference_type   = std::ptrdiff_t;
+	using value_type        = position_type;
+	using pointer           = const position_type*;
+	using reference         = const position_type&;
+	using iterator_category = std::bidirectional_iterator_tag;
+
+	CC_ALWAYS_INLINE
+	explicit segment_iterator(const position_type& pos, const Range& r)
+	noexcept : m_pos{pos}, m_range{&r} {}
+
+	CC_ALWAYS_INLINE
+	reference operator*() const noexcept
+	{ return m_pos; }
+
+	CC_ALWAYS_INLINE
+	pointer operator->() const noexcept
+	{ return &m_pos; }
+
+	CC_ALWAYS_INLINE
+	auto& operator++() noexcept
 	{
-		increment_helper::apply(m_pos, m_range);
+		bounds::next(m_pos(c), *m_range);
 		return *this;
 	}
 
-	CC_ALWAYS_INLINE auto&
-	operator--() noexcept
+	CC_ALWAYS_INLINE
+	auto& operator--() noexcept
 	{
-		decrement_helper::apply(m_pos, m_range);
+		bounds::prev(m_pos(c), *m_range);
 		return *this;
 	}
 
-	template <class Range_>
-	CC_ALWAYS_INLINE bool
-	operator==(const range_iterator<Range_>& rhs)
-	noexcept
+	CC_ALWAYS_INLINE
+	auto operator++(int) noexcept
+	{ auto t = *this; ++(*this); return t; }
+
+	CC_ALWAYS_INLINE
+	auto operator--(int) noexcept
+	{ auto t = *this; --(*this); return t; }
+
+	CC_ALWAYS_INLINE
+	auto operator==(const segment_iterator& rhs) const noexcept
+	{ return m_pos(c) == rhs.m_pos(c); }
+
+	CC_ALWAYS_INLINE
+	auto operator!=(const segment_iterator& rhs) const noexcept
+	{ return !(*this == rhs); }
+};
+
+/*
+** The indices visited by the innermost loop of a range for a fixed value of
+** the counters of the enclosing loops. `front()` is the first index of the
+** segment.
+*/
+template <class Range>
+class range_segment final
+{
+	static constexpr auto dims = Range::dims();
+	using bounds        = detail::loop_bounds<dims - 1, typename Range::attribs>;
+	using position_type = decltype(detail::first_position(std::declval<Range>()));
+
+	position_type m_first;
+	const Range* m_range;
+public:
+	using iterator       = segment_iterator<Range>;
+	using const_iterator = iterator;
+
+	CC_ALWAYS_INLINE
+	explicit range_segment(const position_type& first, const Range& r)
+	noexcept : m_first{first}, m_range{&r} {}
+
+	CC_ALWAYS_INLINE
+	const auto& front() const noexcept
+	{ return m_first; }
+
+	CC_ALWAYS_INLINE
+	auto size() const noexcept
 	{
-		return m_pos.first() == rhs.m_range.extents().first();
+		return m_range->length(sc_coord<bounds::coord>) /
+			m_range->stride(sc_coord<bounds::coord>);
 	}
 
-	template <class Range_>
-	CC_ALWAYS_INLINE bool
-	operator!=(const range_iterator<Range_>& rhs)
-	noexcept { return !(*this == rhs); }
+	CC_ALWAYS_INLINE
+	auto begin() const noexcept
+	{ return iterator{m_first, *m_range}; }
+
+	CC_ALWAYS_INLINE
+	auto end() const noexcept
+	{
+		auto i = m_first;
+		i(sc_coord<bounds::coord>) = bounds::past(*m_range);
+		return iterator{i, *m_range};
+	}
+};
+
+namespace detail {
+
+template <class Range, bool HasOuterLoops = (Range::dims() > 1)>
+struct segment_step
+{
+	template <class Index>
+	CC_ALWAYS_INLINE
+	static void increment(Index& i, const Range& r) noexcept
+	{ increment_helper<Range::dims() - 2, typename Range::attribs>::apply(i, r); }
+
+	template <class Index>
+	CC_ALWAYS_INLINE
+	static void decrement(Index& i, const Range& r) noexcept
+	{ decrement_helper<Range::dims() - 2, typename Range::attribs>::apply(i, r); }
 };
 
 template <class Range>
-CC_ALWAYS_INLINE constexpr
-auto make_range_iterator(const Range& r)
-noexcept { return range_iterator<Range>{r}; }
+struct segment_step<Range, false>
+{
+	template <class Index>
+	CC_ALWAYS_INLINE
+	static void increment(Index&, const Range&) noexcept {}
 
-/*
-** XXX: The approach below does not work, because the range for loop requires
-** that `begin` and `end` return the same type of iterator.
-**
-** When comparing two iterators for equality, we would normally have to check
-** each index one by one. But when we know that the iterator being compared
-** against is the end iterator, we only need to compare the first index against
-** the first extent. So it makes sense to define a separate type just for the
-** end iterator. Note that this type is not actually an iterator.
-*/
+	template <class Index>
+	CC_ALWAYS_INLINE
+	static void decrement(Index&, const Range&) noexcept {}
+};
+
+}
 
 /*
+** An iterator over the segments of a range. The iterator keeps the ordinal of
+** the current segment, so that comparisons only check one integer.
+*/
 template <class Range>
-class range_end_iterator
+class range_segment_iterator final
 {
-	const Range& m_range;
+	using step          = detail::segment_step<Range>;
+	using position_type = decltype(detail::first_position(std::declval<Range>()));
+
+	position_type m_pos;
+	size_t m_n;
+	const Range* m_range;
 public:
-	CC_ALWAYS_INLINE constexpr
-	explicit range_end_iterator(const Range& range)
-	noexcept : m_range{range} {}
+	using difference_type   = std::ptrdiff_t;
+	using value_type        = range_segment<Range>;
+	using pointer           = void;
+	using reference         = value_type;
+	using iterator_category = std::bidirectional_iterator_tag;
 
-	CC_ALWAYS_INLINE constexpr
-	const auto& operator*() const noexcept
-	{ return m_range.extents(); }
+	CC_ALWAYS_INLINE
+	explicit range_segment_iterator(const Range& r, const size_t n) noexcept
+	: m_pos{detail::first_position(r)}, m_n{n}, m_range{&r} {}
 
-	CC_ALWAYS_INLINE constexpr
-	const auto* operator->() const noexcept
-	{ return &m_range.extents(); }
+	CC_ALWAYS_INLINE
+	auto operator*() const noexcept
+	{ return value_type{m_pos, *m_range}; }
+
+	CC_ALWAYS_INLINE
+	auto& operator++() noexcept
+	{
+		step::increment(m_pos, *m_range);
+		++m_n;
+		return *this;
+	}
+
+	CC_ALWAYS_INLINE
+	auto& operator--() noexcept
+	{
+		step::decrement(m_pos, *m_range);
+		--m_n;
+		return *this;
+	}
+
+	CC_ALWAYS_INLINE
+	auto operator++(int) noexcept
+	{ auto t = *this; ++(*this); return t; }
+
+	CC_ALWAYS_INLINE
+	auto operator--(int) noexcept
+	{ auto t = *this; --(*this); return t; }
+
+	CC_ALWAYS_INLINE
+	auto operator==(const range_segment_iterator& rhs) const noexcept
+	{ return m_n == rhs.m_n; }
+
+	CC_ALWAYS_INLINE
+	auto operator!=(const range_segment_iterator& rhs) const noexcept
+	{ return !(*this == rhs); }
 };
 
+/*
+** The range is stored by value, so that `segments` can be applied to a
+** temporary in the header of a range-for loop.
+*/
 template <class Range>
-CC_ALWAYS_INLINE bool
-operator==(
-	const range_iterator<Range>& lhs,
-	const range_end_iterator<Range> rhs
-) noexcept { return lhs->first() == rhs->first(); }
+class range_segments final
+{
+	using bounds = detail::loop_bounds<Range::dims() - 1, typename Range::attribs>;
 
-template <class Range>
-CC_ALWAYS_INLINE bool
-operator==(
-	const range_end_iterator<Range>& lhs,
-	const range_iterator<Range>& rhs
-) noexcept { return lhs->first() == rhs->first(); }
+	Range m_range;
+public:
+	using iterator       = range_segment_iterator<Range>;
+	using const_iterator = iterator;
 
-template <class Range>
-CC_ALWAYS_INLINE bool
-operator!=(
-	const range_iterator<Range>& lhs,
-	const range_end_iterator<Range>& rhs
-) noexcept { return !(lhs == rhs); }
+	CC_ALWAYS_INLINE constexpr
+	explicit range_segments(const Range& r) noexcept : m_range{r} {}
+
+	CC_ALWAYS_INLINE
+	auto size() const noexcept
+	{
+		return size_t(m_range.size() /
+			(m_range.length(sc_coord<bounds::coord>) /
+			m_range.stride(sc_coord<bounds::coord>)));
+	}
+
+	CC_ALWAYS_INLINE
+	auto begin() const noexcept
+	{ return iterator{m_range, 0}; }
+
+	CC_ALWAYS_INLINE
+	auto end() const noexcept
+	{ return iterator{m_range, size()}; }
+};
 
 template <class Range>
-CC_ALWAYS_INLINE bool
-operator!=(
-	const range_end_iterator<Range>& lhs,
-	const range_iterator<Range>& rhs
-) noexcept { return !(lhs == rhs); }
-*/
+CC_ALWAYS_INLINE constexpr
+auto segments(const Range& r) noexcept
+{ return range_segments<Range>{r}; }
 
 }
 
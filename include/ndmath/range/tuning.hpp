@@ -0,0 +1,83 @@
+/*
+** File Name: tuning.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Applies loop optimization parameters chosen by the autotuner in
+** `source/tune` to a loop nest. Each kernel is identified by a tag type in the
+** namespace `nd::kernels`:
+**
+**	nd_declare_kernel(axpy_2d)
+**	...
+**	nd::tune<nd::kernels::axpy_2d>(r)(f);
+**
+** `tune` applies the chain of range transformations (e.g. `unroll`, `tile`,
+** and `permute`) recorded for the kernel using `nd_define_tuning`. If none were
+** recorded, the range is returned unchanged. The autotuner writes a header of
+** such definitions for each kernel and CPU model it has measured; the header is
+** included by defining `nd_tuned_header` to its path, and the CPU model whose
+** parameters are used is selected by `nd_tuning_target` (by default, the model
+** on which the header was generated).
+**
+** While a kernel is being tuned, each variant is compiled with
+** `nd_tune_variant` defined to the chain of transformations to evaluate. It is
+** applied to every call to `tune` in the translation unit, so each kernel
+** source file should contain a single kernel.
+*/
+
+#ifndef ZBDB6D66E_7800_4BBF_8ED2_80CCF45A4D2C
+#define ZBDB6D66E_7800_4BBF_8ED2_80CCF45A4D2C
+
+#include <ndmath/range.hpp>
+
+#define nd_declare_kernel(name) \
+	namespace nd { namespace kernels { struct name; }}
+
+/*
+** The transformations are member function calls applied to a range of
+** dependent type, so each must be preceded by `.template`, e.g.
+** `.template unroll<1, nd::contiguous<4>>().template tile<0, 16>()`.
+*/
+#define nd_define_tuning(name, ...)                            \
+	nd_declare_kernel(name)                                \
+	namespace nd {                                         \
+	template <>                                            \
+	struct tuning<kernels::name>                           \
+	{                                                      \
+		template <class Range>                         \
+		CC_ALWAYS_INLINE constexpr                     \
+		static auto apply(const Range& r) noexcept     \
+		{ return r __VA_ARGS__; }                      \
+	};                                                     \
+	}
+
+namespace nd {
+
+template <class Kernel>
+struct tuning
+{
+	template <class Range>
+	CC_ALWAYS_INLINE constexpr
+	static auto apply(const Range& r) noexcept
+	{ return r; }
+};
+
+template <class Kernel, class Range>
+CC_ALWAYS_INLINE constexpr
+auto tune(const Range& r) noexcept
+{
+	#ifdef nd_tune_variant
+		return r nd_tune_variant;
+	#else
+		return tuning<Kernel>::apply(r);
+	#endif
+}
+
+}
+
+#ifdef nd_tuned_header
+	#include nd_tuned_header
+#endif
+
+#endif
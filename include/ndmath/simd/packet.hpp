@@ -0,0 +1,295 @@
+/*
+** File Name: packet.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** A packet is a short, fixed-size vector of arithmetic values that fits in a
+** single SIMD register. The width of the register is selected at compile time
+** based on the instruction sets enabled by the compiler flags (e.g.
+** `-march=native`):
+**
+** - AVX-512: 64 bytes.
+** - AVX/AVX2: 32 bytes.
+** - SSE2 or NEON: 16 bytes.
+** - Otherwise, each packet consists of a single scalar.
+**
+** The width can be overridden by defining `nd_simd_width` to the desired
+** number of bytes (zero selects the scalar fallback).
+**
+** Packets are implemented using the vector extensions supported by GCC and
+** clang, so the arithmetic and bitwise operators are lowered to the
+** corresponding vector instructions. An operator is only defined for a packet
+** if it is supported by the underlying vector type, so the function objects in
+** `utility/operations.hpp` can be applied to packets whenever this makes sense.
+*/
+
+#ifndef Z643A2E38_D1A1_4D93_B3DA_DA1BEDA40D5D
+#define Z643A2E38_D1A1_4D93_B3DA_DA1BEDA40D5D
+
+#include <cstring>
+#include <ndmath/common.hpp>
+
+#ifndef nd_simd_width
+	#if defined(__AVX512F__)
+		#define nd_simd_width 64
+	#elif defined(__AVX__)
+		#define nd_simd_width 32
+	#elif defined(__SSE2__) || defined(__ARM_NEON)
+		#define nd_simd_width 16
+	#else
+		#define nd_simd_width 0
+	#endif
+#endif
+
+#if nd_simd_width == 64
+	#include <immintrin.h>
+#endif
+
+namespace nd {
+
+static constexpr auto simd_width = size_t{nd_simd_width};
+
+namespace detail {
+
+template <class T>
+static constexpr auto packet_lanes =
+simd_width >= 2 * sizeof(T) ? simd_width / sizeof(T) : size_t{1};
+
+template <class T>
+static constexpr auto is_packable =
+std::is_arithmetic<T>::value && !std::is_same<T, bool>::value;
+
+template <class T, size_t Bytes>
+struct vector_type_helper
+{ typedef T type __attribute__((vector_size(Bytes))); };
+
+template <class T, size_t Lanes>
+struct masked_io;
+
+}
+
+template <class T, size_t Lanes = detail::packet_lanes<T>>
+class packet final
+{
+	static_assert(
+		detail::is_packable<T>,
+		"Packets can only contain arithmetic types other than bool."
+	);
+public:
+	using value_type  = T;
+	using vector_type = typename detail::vector_type_helper<
+		T, Lanes * sizeof(T)>::type;
+
+	static constexpr auto lanes = Lanes;
+private:
+	vector_type m_data;
+public:
+	/*
+	** Like the built-in arithmetic types, packets are left uninitialized
+	** by the default constructor.
+	*/
+	CC_ALWAYS_INLINE
+	explicit packet() noexcept {}
+
+	CC_ALWAYS_INLINE constexpr
+	explicit packet(const vector_type& v)
+	noexcept : m_data(v) {}
+
+	CC_ALWAYS_INLINE
+	static auto broadcast(const T x) noexcept
+	{ return packet{vector_type{} + x}; }
+
+	CC_ALWAYS_INLINE
+	static auto load(const T* p) noexcept
+	{
+		auto v = vector_type{};
+		std::memcpy(&v, p, sizeof(v));
+		return packet{v};
+	}
+
+	CC_ALWAYS_INLINE
+	static auto load_aligned(const T* p) noexcept
+	{ return packet{*reinterpret_cast<const vector_type*>(p)}; }
+
+	/*
+	** Loads the first `n < lanes` elements starting at `p`. The remaining
+	** lanes are filled with copies of the first element, so that operations
+	** that may fault on certain values (e.g. integer division) are safe to
+	** apply to the inactive lanes.
+	*/
+	CC_ALWAYS_INLINE
+	static auto load_partial(const T* p, const size_t n) noexcept
+	{ return detail::masked_io<T, Lanes>::load(p, n); }
+
+	CC_ALWAYS_INLINE
+	void store(T* p) const noexcept
+	{ std::memcpy(p, &m_data, sizeof(m_data)); }
+
+	CC_ALWAYS_INLINE
+	void store_aligned(T* p) const noexcept
+	{ *reinterpret_cast<vector_type*>(p) = m_data; }
+
+	/*
+	** Stores the first `n < lanes` elements of the packet to `p`, without
+	** touching the memory past `p + n`.
+	*/
+	CC_ALWAYS_INLINE
+	void store_partial(T* p, const size_t n) const noexcept
+	{ detail::masked_io<T, Lanes>::store(*this, p, n); }
+
+	CC_ALWAYS_INLINE
+	auto& data() noexcept
+	{ return m_data; }
+
+	CC_ALWAYS_INLINE constexpr
+	const auto& data() const noexcept
+	{ return m_data; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto operator[](const size_t n) const noexcept
+	{ return T(m_data[n]); }
+};
+
+template <class T>
+struct is_packet : std::false_type {};
+
+template <class T, size_t Lanes>
+struct is_packet<packet<T, Lanes>> : std::true_type {};
+
+namespace detail {
+
+template <class T, size_t Lanes>
+struct masked_io
+{
+	CC_ALWAYS_INLINE
+	static auto load(const T* p, const size_t n) noexcept
+	{
+		T buf[Lanes];
+		for (auto i = size_t{0}; i != Lanes; ++i) {
+			buf[i] = i < n ? p[i] : p[0];
+		}
+		return packet<T, Lanes>::load(buf);
+	}
+
+	CC_ALWAYS_INLINE
+	static void store(const packet<T, Lanes>& x, T* p, const size_t n)
+	noexcept
+	{
+		T buf[Lanes];
+		x.store(buf);
+		std::memcpy(p, buf, n * sizeof(T));
+	}
+};
+
+#if nd_simd_width == 64
+
+/*
+** AVX-512 supports masked loads and stores directly, so we use them for the
+** floating-point types instead of going through a buffer on the stack.
+*/
+
+template <>
+struct masked_io<float, 16>
+{
+	using packet_type = packet<float, 16>;
+	using vector_type = packet_type::vector_type;
+
+	CC_ALWAYS_INLINE
+	static auto load(const float* p, const size_t n) noexcept
+	{
+		const auto m = __mmask16((1u << n) - 1);
+		return packet_type{vector_type(
+			_mm512_mask_loadu_ps(_mm512_set1_ps(p[0]), m, p))};
+	}
+
+	CC_ALWAYS_INLINE
+	static void store(const packet_type& x, float* p, const size_t n)
+	noexcept
+	{
+		const auto m = __mmask16((1u << n) - 1);
+		_mm512_mask_storeu_ps(p, m, __m512(x.data()));
+	}
+};
+
+template <>
+struct masked_io<double, 8>
+{
+	using packet_type = packet<double, 8>;
+	using vector_type = packet_type::vector_type;
+
+	CC_ALWAYS_INLINE
+	static auto load(const double* p, const size_t n) noexcept
+	{
+		const auto m = __mmask8((1u << n) - 1);
+		return packet_type{vector_type(
+			_mm512_mask_loadu_pd(_mm512_set1_pd(p[0]), m, p))};
+	}
+
+	CC_ALWAYS_INLINE
+	static void store(const packet_type& x, double* p, const size_t n)
+	noexcept
+	{
+		const auto m = __mmask8((1u << n) - 1);
+		_mm512_mask_storeu_pd(p, m, __m512d(x.data()));
+	}
+};
+
+#endif
+
+}
+
+#define nd_define_packet_unary_op(symbol)                           \
+	template <class T, size_t Lanes, class Vector =             \
+		typename packet<T, Lanes>::vector_type, class =     \
+		decltype(symbol std::declval<Vector>())>            \
+	CC_ALWAYS_INLINE                                            \
+	auto operator symbol (const packet<T, Lanes>& x) noexcept   \
+	{ return packet<T, Lanes>{symbol x.data()}; }
+
+nd_define_packet_unary_op(+)
+nd_define_packet_unary_op(-)
+nd_define_packet_unary_op(~)
+
+#undef nd_define_packet_unary_op
+
+#define nd_define_packet_binary_op(symbol)                                  \
+	template <class T, size_t Lanes, class Vector =                     \
+		typename packet<T, Lanes>::vector_type, class = decltype(   \
+		std::declval<Vector>() symbol std::declval<Vector>())>      \
+	CC_ALWAYS_INLINE                                                    \
+	auto operator symbol (                                              \
+		const packet<T, Lanes>& x,                                  \
+		const packet<T, Lanes>& y                                   \
+	) noexcept                                                          \
+	{ return packet<T, Lanes>{x.data() symbol y.data()}; }              \
+	                                                                    \
+	template <class T, size_t Lanes, class Vector =                     \
+		typename packet<T, Lanes>::vector_type, class = decltype(   \
+		std::declval<Vector>() symbol std::declval<Vector>())>      \
+	CC_ALWAYS_INLINE                                                    \
+	auto& operator symbol ## = (                                        \
+		packet<T, Lanes>& x,                                        \
+		const packet<T, Lanes>& y                                   \
+	) noexcept                                                          \
+	{ x.data() = x.data() symbol y.data(); return x; }
+
+// Arithmetic operations.
+nd_define_packet_binary_op(+)
+nd_define_packet_binary_op(-)
+nd_define_packet_binary_op(*)
+nd_define_packet_binary_op(/)
+nd_define_packet_binary_op(%)
+
+// Bitwise operations.
+nd_define_packet_binary_op(&)
+nd_define_packet_binary_op(|)
+nd_define_packet_binary_op(^)
+nd_define_packet_binary_op(<<)
+nd_define_packet_binary_op(>>)
+
+#undef nd_define_packet_binary_op
+
+}
+
+#endif
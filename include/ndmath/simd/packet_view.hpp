@@ -0,0 +1,173 @@
+/*
+** File Name: packet_view.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** A packet view allows the elements of an array to be accessed one packet at a
+** time, in the order determined by the storage order of the array. Offsets are
+** measured in elements, and should be multiples of the number of lanes in the
+** packet type. The last packet of an array whose size is not a multiple of the
+** number of lanes is accessed using the overloads of `load` and `store` that
+** take the number of elements remaining.
+**
+** If `Aligned` is true, then the data is assumed to be aligned to the size of a
+** packet, so that full packets are accessed using aligned loads and stores.
+**
+** Any type that provides `load` and `store` with these signatures can act as a
+** packet view; `elemwise_view` uses this to compose the packet views of its
+** arguments.
+*/
+
+#ifndef ZB4581003_9D0A_4EE5_BF54_3B2873CE8615
+#define ZB4581003_9D0A_4EE5_BF54_3B2873CE8615
+
+#include <ndmath/simd/packet.hpp>
+#include <ndmath/utility/fusion.hpp>
+
+namespace nd {
+namespace detail {
+
+/*
+** Whether data aligned to `Align` bytes is also aligned to the size of a
+** packet of `T`.
+*/
+template <class T, size_t Align>
+static constexpr auto is_packet_aligned =
+Align != 0 && Align % sizeof(packet<std::remove_const_t<T>>) == 0;
+
+}
+
+template <class T, class SizeType, bool Aligned = false>
+class packet_view final
+{
+public:
+	using value_type  = std::remove_const_t<T>;
+	using size_type   = SizeType;
+	using packet_type = packet<value_type>;
+	static constexpr auto lanes = packet_type::lanes;
+private:
+	T* m_data;
+	size_type m_size;
+public:
+	CC_ALWAYS_INLINE constexpr
+	explicit packet_view(T* data, const size_type size)
+	noexcept : m_data{data}, m_size{size} {}
+
+	CC_ALWAYS_INLINE constexpr
+	auto data() const noexcept
+	{ return m_data; }
+
+	CC_ALWAYS_INLINE constexpr
+	auto size() const noexcept
+	{ return m_size; }
+
+	CC_ALWAYS_INLINE
+	auto load(const size_type off) const noexcept
+	{
+		return Aligned ? packet_type::load_aligned(m_data + off) :
+			packet_type::load(m_data + off);
+	}
+
+	CC_ALWAYS_INLINE
+	auto load(const size_type off, const size_type n) const noexcept
+	{ return packet_type::load_partial(m_data + off, n); }
+
+	template <nd_enable_if((!std::is_const<T>::value))>
+	CC_ALWAYS_INLINE
+	void store(const size_type off, const packet_type& x) const noexcept
+	{
+		if (Aligned) { x.store_aligned(m_data + off); }
+		else         { x.store(m_data + off); }
+	}
+
+	template <nd_enable_if((!std::is_const<T>::value))>
+	CC_ALWAYS_INLINE
+	void store(const size_type off, const packet_type& x, const size_type n)
+	const noexcept { x.store_partial(m_data + off, n); }
+};
+
+template <bool Aligned = false, class T, class SizeType>
+CC_ALWAYS_INLINE constexpr
+auto make_packet_view(T* data, const SizeType size) noexcept
+{ return packet_view<T, SizeType, Aligned>{data, size}; }
+
+/*
+** Applies a function elementwise to the packets loaded from a set of packet
+** views. This is what `elemwise_view` returns from `packet_view()`.
+*/
+template <class Func, class... Views>
+class elemwise_packet_view final
+{
+public:
+	using size_type   = std::common_type_t<typename Views::size_type...>;
+	using packet_type = std::decay_t<std::result_of_t<
+		Func(typename Views::packet_type...)>>;
+	using value_type  = typename packet_type::value_type;
+	static constexpr auto lanes = packet_type::lanes;
+private:
+	tuple<Views...> m_views;
+	Func m_func;
+public:
+	CC_ALWAYS_INLINE constexpr
+	explicit elemwise_packet_view(const Func& f, const Views&... views)
+	noexcept : m_views{views...}, m_func(f) {}
+
+	CC_ALWAYS_INLINE constexpr
+	auto size() const noexcept
+	{ return size_type(get<0>(m_views).size()); }
+
+	CC_ALWAYS_INLINE
+	auto load(const size_type off) const noexcept
+	{
+		return expand(m_views,
+			[&] (const auto&... vs) CC_ALWAYS_INLINE noexcept {
+				return m_func(vs.load(off)...);
+			});
+	}
+
+	CC_ALWAYS_INLINE
+	auto load(const size_type off, const size_type n) const noexcept
+	{
+		return expand(m_views,
+			[&] (const auto&... vs) CC_ALWAYS_INLINE noexcept {
+				return m_func(vs.load(off, n)...);
+			});
+	}
+};
+
+template <class Func, class... Views>
+CC_ALWAYS_INLINE constexpr
+auto make_elemwise_packet_view(const Func& f, const Views&... views) noexcept
+{ return elemwise_packet_view<Func, Views...>{f, views...}; }
+
+namespace detail {
+
+/*
+** Copies the contents of the packet view `src` into the packet view `dst`. The
+** tail that does not fill an entire packet is handled using masked loads and
+** stores.
+*/
+template <class Dst, class Src>
+CC_ALWAYS_INLINE
+void packet_copy(const Dst& dst, const Src& src) noexcept
+{
+	using size_type = typename Dst::size_type;
+	constexpr auto lanes = size_type(Dst::lanes);
+
+	const auto n = dst.size();
+	auto i = size_type{0};
+
+	if (n >= lanes) {
+		for (; i <= n - lanes; i += lanes) {
+			dst.store(i, src.load(i));
+		}
+	}
+	if (i != n) {
+		dst.store(i, src.load(i, size_type(n - i)), size_type(n - i));
+	}
+}
+
+}}
+
+#endif
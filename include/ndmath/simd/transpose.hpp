@@ -0,0 +1,167 @@
+/*
+** File Name: transpose.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Transposes a square block of `lanes` packets in registers, so that the `j`th
+** lane of the `i`th packet is exchanged with the `i`th lane of the `j`th
+** packet. The 4x4 and 8x8 blocks of 4-byte elements, and the 2x2 and 4x4 blocks
+** of 8-byte elements, are transposed using unpack and shuffle instructions when
+** SSE or AVX is enabled. Other blocks go through a buffer on the stack.
+*/
+
+#ifndef ZED796A8D_426A_4924_8662_AB1EC94C6EEA
+#define ZED796A8D_426A_4924_8662_AB1EC94C6EEA
+
+#include <utility>
+#include <ndmath/simd/packet.hpp>
+
+#if (nd_simd_width == 16 || nd_simd_width == 32) && defined(__SSE2__)
+	#include <immintrin.h>
+#endif
+
+namespace nd {
+namespace detail {
+
+template <size_t Size, size_t Lanes>
+struct packet_transpose_kernel
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(packet<T, Lanes> (&p)[Lanes]) noexcept
+	{
+		T buf[Lanes][Lanes];
+		for (auto i = size_t{0}; i != Lanes; ++i) {
+			p[i].store(buf[i]);
+		}
+		for (auto i = size_t{1}; i != Lanes; ++i) {
+			for (auto j = size_t{0}; j != i; ++j) {
+				std::swap(buf[i][j], buf[j][i]);
+			}
+		}
+		for (auto i = size_t{0}; i != Lanes; ++i) {
+			p[i] = packet<T, Lanes>::load(buf[i]);
+		}
+	}
+};
+
+#if nd_simd_width == 16 && defined(__SSE2__)
+
+template <>
+struct packet_transpose_kernel<4, 4>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(packet<T, 4> (&p)[4]) noexcept
+	{
+		using vector = typename packet<T, 4>::vector_type;
+
+		auto a = (__m128)p[0].data();
+		auto b = (__m128)p[1].data();
+		auto c = (__m128)p[2].data();
+		auto d = (__m128)p[3].data();
+		_MM_TRANSPOSE4_PS(a, b, c, d);
+
+		p[0] = packet<T, 4>{(vector)a};
+		p[1] = packet<T, 4>{(vector)b};
+		p[2] = packet<T, 4>{(vector)c};
+		p[3] = packet<T, 4>{(vector)d};
+	}
+};
+
+template <>
+struct packet_transpose_kernel<8, 2>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(packet<T, 2> (&p)[2]) noexcept
+	{
+		using vector = typename packet<T, 2>::vector_type;
+
+		const auto a = (__m128d)p[0].data();
+		const auto b = (__m128d)p[1].data();
+		p[0] = packet<T, 2>{(vector)_mm_unpacklo_pd(a, b)};
+		p[1] = packet<T, 2>{(vector)_mm_unpackhi_pd(a, b)};
+	}
+};
+
+#elif nd_simd_width == 32 && defined(__AVX__)
+
+template <>
+struct packet_transpose_kernel<4, 8>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(packet<T, 8> (&p)[8]) noexcept
+	{
+		using vector = typename packet<T, 8>::vector_type;
+
+		__m256 r[8];
+		__m256 t[8];
+		for (auto i = 0; i != 8; ++i) {
+			r[i] = (__m256)p[i].data();
+		}
+
+		// Interleave pairs of rows.
+		for (auto i = 0; i != 8; i += 2) {
+			t[i]     = _mm256_unpacklo_ps(r[i], r[i + 1]);
+			t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+		}
+
+		// Combine the pairs into groups of four within each 128-bit lane.
+		for (auto i = 0; i != 8; i += 4) {
+			r[i]     = _mm256_shuffle_ps(t[i],     t[i + 2], 0x44);
+			r[i + 1] = _mm256_shuffle_ps(t[i],     t[i + 2], 0xEE);
+			r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+			r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0xEE);
+		}
+
+		// Exchange the 128-bit lanes of the top and bottom halves.
+		for (auto i = 0; i != 4; ++i) {
+			p[i]     = packet<T, 8>{(vector)
+				_mm256_permute2f128_ps(r[i], r[i + 4], 0x20)};
+			p[i + 4] = packet<T, 8>{(vector)
+				_mm256_permute2f128_ps(r[i], r[i + 4], 0x31)};
+		}
+	}
+};
+
+template <>
+struct packet_transpose_kernel<8, 4>
+{
+	template <class T>
+	CC_ALWAYS_INLINE
+	static void apply(packet<T, 4> (&p)[4]) noexcept
+	{
+		using vector = typename packet<T, 4>::vector_type;
+
+		const auto a = (__m256d)p[0].data();
+		const auto b = (__m256d)p[1].data();
+		const auto c = (__m256d)p[2].data();
+		const auto d = (__m256d)p[3].data();
+
+		const auto t0 = _mm256_unpacklo_pd(a, b);
+		const auto t1 = _mm256_unpackhi_pd(a, b);
+		const auto t2 = _mm256_unpacklo_pd(c, d);
+		const auto t3 = _mm256_unpackhi_pd(c, d);
+
+		p[0] = packet<T, 4>{(vector)_mm256_permute2f128_pd(t0, t2, 0x20)};
+		p[1] = packet<T, 4>{(vector)_mm256_permute2f128_pd(t1, t3, 0x20)};
+		p[2] = packet<T, 4>{(vector)_mm256_permute2f128_pd(t0, t2, 0x31)};
+		p[3] = packet<T, 4>{(vector)_mm256_permute2f128_pd(t1, t3, 0x31)};
+	}
+};
+
+#endif
+
+}
+
+template <class T, size_t Lanes>
+CC_ALWAYS_INLINE
+void transpose_packets(packet<T, Lanes> (&p)[Lanes]) noexcept
+{ detail::packet_transpose_kernel<sizeof(T), Lanes>::apply(p); }
+
+}
+
+#endif
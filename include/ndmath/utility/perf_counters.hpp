@@ -0,0 +1,343 @@
+/*
+** File Name: perf_counters.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Optional instrumentation using the hardware performance counters of the
+** calling thread. Any statement, such as a loop nest evaluated by `for_each` or
+** `do_while`, or an assignment, can be wrapped as follows:
+**
+**	nd::instrument("tiled axpy", [&] { r(f); });
+**
+** Equivalently, a `perf_scope` counts the events that occur during its
+** lifetime. The counts are aggregated by label over all calls and threads, and
+** can be obtained using `perf_results`, or printed using `print_perf_report`.
+** The following events are counted: cycles, instructions, L1 data cache read
+** misses, last-level cache misses, and branch misses. Events that the CPU or
+** kernel does not support are reported as zero.
+**
+** The counters are read using `perf_event_open`, which is only available on
+** Linux, and only if permitted by `/proc/sys/kernel/perf_event_paranoid`. If
+** the counters cannot be opened, only the number of calls and the wall-clock
+** time are recorded. The instrumentation is compiled out unless
+** `nd_enable_perf_counters` is defined; otherwise, `instrument` reduces to a
+** call to the function, and `perf_results` is always empty.
+*/
+
+#ifndef ZAC7DB08C_33D4_4366_ACBC_F562540FB2EB
+#define ZAC7DB08C_33D4_4366_ACBC_F562540FB2EB
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <ndmath/common.hpp>
+
+#ifdef nd_enable_perf_counters
+	#ifndef __linux__
+		#error "Performance counters are only supported on Linux."
+	#endif
+
+	#include <cstring>
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+namespace nd {
+
+enum class perf_event : unsigned
+{
+	cycles,
+	instructions,
+	l1d_misses,
+	llc_misses,
+	branch_misses
+};
+
+static constexpr auto perf_event_count = size_t{5};
+
+struct perf_totals
+{
+	size_t calls{0};
+	double nanoseconds{0};
+	std::array<std::uint64_t, perf_event_count> events{};
+
+	// False if the counters could not be opened for some call.
+	bool counted{true};
+
+	CC_ALWAYS_INLINE
+	auto operator[](const perf_event e) const noexcept
+	{ return events[unsigned(e)]; }
+};
+
+#ifdef nd_enable_perf_counters
+
+namespace detail {
+
+/*
+** The counters of the calling thread, opened on first use as a single group
+** so that they are scheduled together. If the kernel multiplexes the group,
+** the counts are scaled by the fraction of the time for which it was running.
+*/
+class perf_group final
+{
+	// An enumerator, so that passing it by reference does not odr-use it.
+	enum : int { none = -1 };
+
+	// Position of each event in the values read from the group.
+	std::array<int, perf_event_count> m_slot;
+	std::array<int, perf_event_count> m_fds;
+	int m_leader{none};
+	size_t m_size{0};
+public:
+	struct sample
+	{
+		std::array<std::uint64_t, perf_event_count> values{};
+		std::uint64_t enabled{0};
+		std::uint64_t running{0};
+	};
+
+	perf_group() noexcept
+	{
+		m_slot.fill(none);
+		m_fds.fill(none);
+
+		for (auto i = size_t{0}; i != perf_event_count; ++i) {
+			auto attr = ::perf_event_attr{};
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size           = sizeof(attr);
+			attr.disabled       = m_leader == none;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv     = 1;
+			attr.read_format    = PERF_FORMAT_GROUP |
+				PERF_FORMAT_TOTAL_TIME_ENABLED |
+				PERF_FORMAT_TOTAL_TIME_RUNNING;
+			configure(attr, perf_event(i));
+
+			const auto fd = int(::syscall(__NR_perf_event_open,
+				&attr, 0, -1, m_leader, 0));
+			if (fd < 0) continue;
+
+			if (m_leader == none) m_leader = fd;
+			m_fds[i] = fd;
+			m_slot[i] = int(m_size++);
+		}
+
+		if (m_leader != none) {
+			::ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			::ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		}
+	}
+
+	perf_group(const perf_group&) = delete;
+	perf_group& operator=(const perf_group&) = delete;
+
+	~perf_group()
+	{
+		for (const auto fd : m_fds) {
+			if (fd != none) ::close(fd);
+		}
+	}
+
+	CC_ALWAYS_INLINE
+	auto valid() const noexcept
+	{ return m_leader != none; }
+
+	auto read(sample& s) const noexcept
+	{
+		// Layout: number of events, time enabled, time running,
+		// followed by the value of each event.
+		std::uint64_t buf[3 + perf_event_count];
+		const auto bytes = sizeof(std::uint64_t) * (3 + m_size);
+
+		if (!valid() || ::read(m_leader, buf, bytes) != ssize_t(bytes)) {
+			return false;
+		}
+
+		s.enabled = buf[1];
+		s.running = buf[2];
+		for (auto i = size_t{0}; i != perf_event_count; ++i) {
+			s.values[i] = m_slot[i] == none ? 0 : buf[3 + m_slot[i]];
+		}
+		return true;
+	}
+
+	static perf_group& local()
+	{
+		static thread_local perf_group g;
+		return g;
+	}
+private:
+	static void configure(::perf_event_attr& attr, const perf_event e)
+	noexcept
+	{
+		switch (e) {
+		case perf_event::cycles:
+			attr.type   = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case perf_event::instructions:
+			attr.type   = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case perf_event::l1d_misses:
+			attr.type   = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_L1D |
+				(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+				(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		case perf_event::llc_misses:
+			attr.type   = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CACHE_MISSES;
+			break;
+		case perf_event::branch_misses:
+			attr.type   = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+			break;
+		}
+	}
+};
+
+struct perf_registry
+{
+	std::mutex mutex;
+	std::map<std::string, perf_totals> totals;
+
+	static perf_registry& get()
+	{
+		static perf_registry r;
+		return r;
+	}
+};
+
+}
+
+class perf_scope final
+{
+	using clock  = std::chrono::steady_clock;
+	using sample = detail::perf_group::sample;
+
+	const char* m_label;
+	sample m_start;
+	bool m_counted;
+	clock::time_point m_t1;
+public:
+	explicit perf_scope(const char* label) :
+	m_label{label},
+	m_counted{detail::perf_group::local().read(m_start)},
+	m_t1{clock::now()} {}
+
+	perf_scope(const perf_scope&) = delete;
+	perf_scope& operator=(const perf_scope&) = delete;
+
+	~perf_scope()
+	{
+		using namespace std::chrono;
+
+		const auto t2 = clock::now();
+		auto end = sample{};
+		const auto counted = m_counted &&
+			detail::perf_group::local().read(end);
+
+		auto& r = detail::perf_registry::get();
+		std::lock_guard<std::mutex> lock{r.mutex};
+		auto& t = r.totals[m_label];
+
+		++t.calls;
+		t.nanoseconds += duration<double, std::nano>(t2 - m_t1).count();
+		t.counted &= counted;
+		if (!counted) return;
+
+		const auto running = end.running - m_start.running;
+		const auto enabled = end.enabled - m_start.enabled;
+		const auto scale = running == 0 ? 0. : double(enabled) / running;
+
+		for (auto i = size_t{0}; i != perf_event_count; ++i) {
+			t.events[i] += std::uint64_t(scale *
+				(end.values[i] - m_start.values[i]));
+		}
+	}
+};
+
+inline auto perf_results()
+{
+	auto& r = detail::perf_registry::get();
+	std::lock_guard<std::mutex> lock{r.mutex};
+	return r.totals;
+}
+
+inline void reset_perf_counters()
+{
+	auto& r = detail::perf_registry::get();
+	std::lock_guard<std::mutex> lock{r.mutex};
+	r.totals.clear();
+}
+
+#else
+
+class perf_scope final
+{
+public:
+	CC_ALWAYS_INLINE constexpr
+	explicit perf_scope(const char*) noexcept {}
+
+	perf_scope(const perf_scope&) = delete;
+	perf_scope& operator=(const perf_scope&) = delete;
+};
+
+inline auto perf_results()
+{ return std::map<std::string, perf_totals>{}; }
+
+inline void reset_perf_counters() noexcept {}
+
+#endif
+
+template <class Func>
+CC_ALWAYS_INLINE
+decltype(auto) instrument(const char* label, Func&& f)
+{
+	const perf_scope s{label};
+	return std::forward<Func>(f)();
+}
+
+/*
+** Prints the totals for each label, divided by the number of calls.
+*/
+template <class Char, class Traits>
+void print_perf_report(std::basic_ostream<Char, Traits>& os)
+{
+	for (const auto& p : perf_results()) {
+		const auto& t = p.second;
+		const auto n = double(t.calls);
+
+		cc::write(os, "$: calls: $ • ns: $", p.first, t.calls,
+			t.nanoseconds / n);
+
+		if (!t.counted) {
+			cc::write(os, " • counters unavailable\n");
+			continue;
+		}
+
+		const auto ipc = t[perf_event::cycles] == 0 ? 0. :
+			double(t[perf_event::instructions]) /
+			t[perf_event::cycles];
+
+		cc::write(os, " • cycles: $ • instructions: $ • IPC: $ • "
+			"L1D misses: $ • LLC misses: $ • branch misses: $\n",
+			t[perf_event::cycles] / n,
+			t[perf_event::instructions] / n, ipc,
+			t[perf_event::l1d_misses] / n,
+			t[perf_event::llc_misses] / n,
+			t[perf_event::branch_misses] / n);
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,278 @@
+/*
+** File Name: thread_pool.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** A small work-stealing thread pool used to evaluate parallel loops. Each call
+** to `run` splits the iteration space into chunks, which are initially
+** distributed evenly over per-thread deques. Each thread processes its own
+** chunks in ascending order from the front of its deque, so that consecutive
+** chunks are traversed in memory order; when it runs out of work, it steals
+** chunks from the back of the deques belonging to the other threads. The
+** calling thread participates in the loop, so a pool with `n` threads of
+** concurrency only spawns `n - 1` workers.
+**
+** The number of threads defaults to `std::thread::hardware_concurrency()`. It
+** can be fixed at compile time by defining `nd_num_threads`.
+*/
+
+#ifndef Z012B4657_8ABE_4F06_A079_459573CD0559
+#define Z012B4657_8ABE_4F06_A079_459573CD0559
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <ndmath/common.hpp>
+
+namespace nd {
+namespace detail {
+
+/*
+** Set for the worker threads, and for the calling thread while it participates
+** in a parallel loop. Parallel loops started from such a thread are evaluated
+** serially, so that nested parallel loops cannot deadlock the pool.
+*/
+inline bool& in_parallel_region() noexcept
+{
+	static thread_local auto flag = false;
+	return flag;
+}
+
+}
+
+class thread_pool final
+{
+	struct queue
+	{
+		std::mutex mutex;
+		std::deque<size_t> chunks;
+	};
+
+	using task_type = void (*)(const void*, size_t);
+
+	std::vector<std::thread> m_threads;
+	std::unique_ptr<queue[]> m_queues;
+
+	/*
+	** Serializes concurrent calls to `run` made by threads that do not
+	** belong to the pool.
+	*/
+	std::mutex m_run_mutex;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	task_type m_task{nullptr};
+	const void* m_context{nullptr};
+	size_t m_generation{0};
+	size_t m_acked{0};
+	size_t m_busy{0};
+	bool m_stop{false};
+	std::exception_ptr m_error;
+public:
+	explicit thread_pool(const size_t threads = default_concurrency()) :
+	m_queues{new queue[std::max(threads, size_t{1})]}
+	{
+		for (auto i = size_t{1}; i < threads; ++i) {
+			m_threads.emplace_back([this, i] { worker_loop(i); });
+		}
+	}
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stop = true;
+		}
+		m_wake.notify_all();
+
+		for (auto& t : m_threads) {
+			t.join();
+		}
+	}
+
+	static auto& instance()
+	{
+		static thread_pool pool{};
+		return pool;
+	}
+
+	static size_t default_concurrency() noexcept
+	{
+		#ifdef nd_num_threads
+			return nd_num_threads;
+		#else
+			return std::max(std::thread::hardware_concurrency(), 1u);
+		#endif
+	}
+
+	auto concurrency() const noexcept
+	{ return m_threads.size() + 1; }
+
+	/*
+	** Invokes `f(i)` for each `i` in `[0, chunks)`, and blocks until all of
+	** the invocations have completed. If any invocation throws, the
+	** remaining chunks are still processed, and the first exception is
+	** rethrown to the caller.
+	*/
+	template <class Func>
+	void run(const size_t chunks, const Func& f)
+	{
+		auto& flag = detail::in_parallel_region();
+
+		if (flag || concurrency() == 1 || chunks <= 1) {
+			for (auto i = size_t{0}; i != chunks; ++i) {
+				f(i);
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> run_lock{m_run_mutex};
+		const auto n = concurrency();
+
+		for (auto q = size_t{0}; q != n; ++q) {
+			std::lock_guard<std::mutex> lock{m_queues[q].mutex};
+			for (auto i = q * chunks / n; i != (q + 1) * chunks / n; ++i) {
+				m_queues[q].chunks.push_back(i);
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_task    = invoke<Func>;
+			m_context = &f;
+			m_acked   = 0;
+			m_error   = nullptr;
+			++m_generation;
+		}
+		m_wake.notify_all();
+
+		flag = true;
+		work(0, m_task, m_context);
+		flag = false;
+
+		/*
+		** We wait for every worker to acknowledge the current
+		** generation, so that no worker can pick up chunks belonging to
+		** the next call to `run` using a stale task.
+		*/
+		std::unique_lock<std::mutex> lock{m_mutex};
+		m_done.wait(lock, [&] {
+			return m_acked == m_threads.size() && m_busy == 0;
+		});
+
+		if (m_error) {
+			auto e = m_error;
+			m_error = nullptr;
+			std::rethrow_exception(e);
+		}
+	}
+private:
+	template <class Func>
+	static void invoke(const void* context, const size_t i)
+	{ (*static_cast<const Func*>(context))(i); }
+
+	void worker_loop(const size_t id)
+	{
+		detail::in_parallel_region() = true;
+		auto seen = size_t{0};
+
+		for (;;) {
+			auto task = task_type{nullptr};
+			auto context = static_cast<const void*>(nullptr);
+
+			{
+				std::unique_lock<std::mutex> lock{m_mutex};
+				m_wake.wait(lock, [&] {
+					return m_stop || m_generation != seen;
+				});
+
+				if (m_stop) {
+					return;
+				}
+
+				seen    = m_generation;
+				task    = m_task;
+				context = m_context;
+				++m_acked;
+				++m_busy;
+			}
+
+			work(id, task, context);
+
+			{
+				std::lock_guard<std::mutex> lock{m_mutex};
+				--m_busy;
+			}
+			m_done.notify_one();
+		}
+	}
+
+	void work(const size_t id, const task_type task, const void* context)
+	noexcept
+	{
+		const auto n = concurrency();
+		auto chunk = size_t{0};
+
+		for (;;) {
+			if (!pop(id, chunk)) {
+				auto found = false;
+				for (auto k = size_t{1}; k != n && !found; ++k) {
+					found = steal((id + k) % n, chunk);
+				}
+				if (!found) {
+					return;
+				}
+			}
+
+			try {
+				task(context, chunk);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock{m_mutex};
+				if (!m_error) {
+					m_error = std::current_exception();
+				}
+			}
+		}
+	}
+
+	bool pop(const size_t id, size_t& chunk) noexcept
+	{
+		auto& q = m_queues[id];
+		std::lock_guard<std::mutex> lock{q.mutex};
+
+		if (q.chunks.empty()) {
+			return false;
+		}
+		chunk = q.chunks.front();
+		q.chunks.pop_front();
+		return true;
+	}
+
+	bool steal(const size_t victim, size_t& chunk) noexcept
+	{
+		auto& q = m_queues[victim];
+		std::lock_guard<std::mutex> lock{q.mutex};
+
+		if (q.chunks.empty()) {
+			return false;
+		}
+		chunk = q.chunks.back();
+		q.chunks.pop_back();
+		return true;
+	}
+};
+
+}
+
+#endif
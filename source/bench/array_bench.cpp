@@ -0,0 +1,143 @@
+/*
+** File Name: array_bench.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Benchmarks for the core operations on dense arrays: construction, copy and
+** move assignment (with the same and with different storage orders),
+** elementwise arithmetic, operations on boolean arrays, and traversal using
+** the flat view, the range of the extents, and the iterators and segments of
+** the range. Each benchmark is run for square matrices of several sizes, so
+** that the working sets range from the L1 cache to main memory. See
+** `bench_harness.hpp` for the options.
+*/
+
+#include <ndmath/array/dense_storage.hpp>
+#include "bench_harness.hpp"
+
+template <class Array>
+void fill(Array& arr)
+{
+	auto k = 0u;
+	for (auto& x : arr.flat_view()) { x = float(k++ % 17); }
+}
+
+void run_all(nd::bench::runner& run, const unsigned n)
+{
+	using nd::bench::do_not_optimize;
+
+	const auto elems = double(n) * n;
+	const auto fbytes = elems * sizeof(float);
+	const auto bbytes = elems / 8;
+
+	const auto alloc = nd::aligned_allocator<float>{};
+	const auto col_major = nd::sc_index<1, 0>;
+
+	auto a = nd::make_darray<float>(nd::extents(n, n), alloc);
+	auto b = nd::make_darray<float>(nd::extents(n, n), alloc);
+	auto c = nd::make_darray<float>(nd::extents(n, n), alloc);
+	auto d = nd::make_darray<float>(nd::extents(n, n), alloc, col_major);
+	fill(a);
+	fill(b);
+	fill(c);
+
+	run("construct/uninitialized", n, 0, 0, [&] {
+		auto x = nd::make_darray<float>(nd::extents(n, n), alloc);
+		do_not_optimize(x(0, 0));
+	});
+
+	// The temporary is freed by rewinding the arena of the thread.
+	run("construct/arena", n, 0, 0, [&] {
+		nd::arena_scope s;
+		using arena_alloc = nd::arena_allocator<float>;
+		auto x = nd::make_darray<float>(nd::extents(n, n), arena_alloc{});
+		do_not_optimize(x(0, 0));
+	});
+
+	run("construct/fill", n, fbytes, 0, [&] {
+		auto x = nd::make_darray<float>(1, nd::extents(n, n), alloc);
+		do_not_optimize(x(0, 0));
+	});
+
+	run("assign/copy", n, 2 * fbytes, 0, [&] { c = a; });
+	run("assign/copy_transposed", n, 2 * fbytes, 0, [&] { d = a; });
+
+	// The buffer of `t` is freed by the first move; afterwards, each move is
+	// undone by the next, so that no buffer is freed. `t` is left without a
+	// buffer, so it is not used again.
+	auto t = nd::make_darray<float>(nd::extents(n, n), alloc);
+	run("assign/move", n, 0, 0, [&] {
+		t = std::move(b);
+		b = std::move(t);
+	});
+
+	run("elemwise/add", n, 3 * fbytes, elems, [&] { c = a + b; });
+	run("elemwise/mul_add", n, 3 * fbytes, 2 * elems, [&] {
+		c = a() * b() + a();
+	});
+	run("elemwise/fma_lambda", n, 4 * fbytes, 2 * elems, [&] {
+		c = nd::zip_with([] (auto x, auto y, auto z) noexcept {
+			return x * y + z;
+		}, a, b, c);
+	});
+
+	auto m1 = nd::make_darray<bool>(nd::extents(n, n));
+	auto m2 = nd::make_darray<bool>(nd::extents(n, n));
+	auto m3 = nd::make_darray<bool>(nd::extents(n, n));
+	m1 = a() < b();
+	m2 = b() < c();
+
+	run("bool/compare", n, 2 * fbytes + bbytes, elems, [&] {
+		m3 = a() < b();
+	});
+	run("bool/fast_and", n, 3 * bbytes, 0, [&] {
+		m3 = m1() <nd::fast_and> m2();
+	});
+	run("bool/logical_and", n, 3 * bbytes, 0, [&] {
+		m3 = m1 && m2;
+	});
+	run("bool/count", n, bbytes, 0, [&] {
+		do_not_optimize(nd::count(m1));
+	});
+
+	run("traverse/flat_view", n, fbytes, elems, [&] {
+		auto s = float{0};
+		for (const auto& x : a.flat_view()) { s += x; }
+		do_not_optimize(s);
+	});
+	run("traverse/extents", n, fbytes, elems, [&] {
+		auto s = float{0};
+		a.extents()([&] (const auto& i) CC_ALWAYS_INLINE {
+			s += a(i);
+		});
+		do_not_optimize(s);
+	});
+	run("traverse/range_iterator", n, fbytes, elems, [&] {
+		auto s = float{0};
+		for (const auto& i : a.extents()) { s += a(i); }
+		do_not_optimize(s);
+	});
+	run("traverse/segments", n, fbytes, elems, [&] {
+		auto s = float{0};
+		for (const auto& r : nd::segments(a.extents())) {
+			for (const auto& i : r) { s += a(i); }
+		}
+		do_not_optimize(s);
+	});
+	run("traverse/extents_transposed", n, fbytes, elems, [&] {
+		auto s = float{0};
+		d.extents()([&] (const auto& i) CC_ALWAYS_INLINE {
+			s += d(i);
+		});
+		do_not_optimize(s);
+	});
+}
+
+int main(int argc, char** argv)
+{
+	auto run = nd::bench::runner{argc, argv};
+	for (const auto n : {64u, 512u, 2048u}) {
+		run_all(run, n);
+	}
+}
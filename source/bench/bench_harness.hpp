@@ -0,0 +1,204 @@
+/*
+** File Name: bench_harness.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** A minimal harness for the benchmarks in `source/bench`. Each benchmark is
+** given a name, a problem size, and the number of bytes moved and floating-point
+** operations performed by one call. The harness first runs the benchmark enough
+** times to estimate how many calls are needed for a batch to last at least
+** `--min-batch` microseconds (so that short benchmarks are not dominated by the
+** resolution of the clock), and then times `--reps` batches. The minimum, the
+** 10th and 90th percentiles, and the median of the time per call are reported,
+** along with the throughput computed from the median.
+**
+** Options:
+**
+** - `--reps N`: number of timed batches (default: 15).
+** - `--warmup N`: number of untimed batches run first (default: 2).
+** - `--min-batch N`: minimum duration of a batch in microseconds (default:
+**   200).
+** - `--filter S`: only run the benchmarks whose names contain `S`.
+** - `--format text|json`: the `json` format prints one object per line, which
+**   is read by `compare.rb` to compare two runs.
+*/
+
+#ifndef Z5E0B8C44_91A3_4D6B_B2F7_3C8E1A06D95F
+#define Z5E0B8C44_91A3_4D6B_B2F7_3C8E1A06D95F
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <ccbase/platform.hpp>
+
+namespace nd {
+namespace bench {
+
+/*
+** Prevents the compiler from eliminating the computation of `x`, or from
+** assuming that memory is unchanged across the call.
+*/
+template <class T>
+CC_ALWAYS_INLINE
+void do_not_optimize(const T& x) noexcept
+{ asm volatile("" : : "g"(&x) : "memory"); }
+
+CC_ALWAYS_INLINE
+void clobber_memory() noexcept
+{ asm volatile("" : : : "memory"); }
+
+class runner
+{
+	using clock = std::chrono::steady_clock;
+
+	unsigned m_reps{15};
+	unsigned m_warmup{2};
+	double m_min_batch{200e3};
+	std::string m_filter{};
+	bool m_json{false};
+	bool m_printed_header{false};
+public:
+	explicit runner(const int argc, char** argv)
+	{
+		for (auto i = 1; i < argc; ++i) {
+			const auto has_value = i + 1 < argc;
+
+			if (!std::strcmp(argv[i], "--reps") && has_value) {
+				m_reps = unsigned(std::max(1, std::atoi(argv[++i])));
+			}
+			else if (!std::strcmp(argv[i], "--warmup") && has_value) {
+				m_warmup = unsigned(std::max(0, std::atoi(argv[++i])));
+			}
+			else if (!std::strcmp(argv[i], "--min-batch") && has_value) {
+				m_min_batch = 1e3 * std::max(0, std::atoi(argv[++i]));
+			}
+			else if (!std::strcmp(argv[i], "--filter") && has_value) {
+				m_filter = argv[++i];
+			}
+			else if (!std::strcmp(argv[i], "--format") && has_value) {
+				m_json = !std::strcmp(argv[++i], "json");
+			}
+			else {
+				std::fprintf(stderr, "Unrecognized option \"%s\".\n",
+					argv[i]);
+				std::exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	/*
+	** `bytes` and `flops` are the number of bytes read and written, and the
+	** number of floating-point operations performed, by a single call to
+	** `f`. Either may be zero, in which case the corresponding throughput
+	** is not reported.
+	*/
+	template <class Func>
+	void operator()(
+		const char* name,
+		const size_t n,
+		const double bytes,
+		const double flops,
+		const Func& f
+	)
+	{
+		if (!m_filter.empty() && !std::strstr(name, m_filter.c_str())) {
+			return;
+		}
+
+		const auto batch = calibrate(f);
+		for (auto i = 0u; i != m_warmup; ++i) {
+			run_batch(f, batch);
+		}
+
+		auto ts = std::vector<double>(m_reps);
+		for (auto& t : ts) {
+			t = run_batch(f, batch) / batch;
+		}
+		std::sort(ts.begin(), ts.end());
+
+		const auto med = percentile(ts, 50);
+		report(name, n, ts.front(), percentile(ts, 10), med,
+			percentile(ts, 90), bytes / med, flops / med);
+	}
+private:
+	template <class Func>
+	static double run_batch(const Func& f, const size_t batch)
+	{
+		using namespace std::chrono;
+
+		const auto t1 = clock::now();
+		for (auto i = size_t{0}; i != batch; ++i) {
+			f();
+			clobber_memory();
+		}
+		const auto t2 = clock::now();
+		return duration<double, std::nano>(t2 - t1).count();
+	}
+
+	template <class Func>
+	size_t calibrate(const Func& f) const
+	{
+		auto batch = size_t{1};
+		for (;;) {
+			const auto t = run_batch(f, batch);
+			if (t >= m_min_batch) return batch;
+			batch = t <= 0 ? 2 * batch : std::max(batch + 1,
+				size_t(1.1 * batch * m_min_batch / t));
+		}
+	}
+
+	// Nearest-rank percentile of a sorted sequence.
+	static double percentile(const std::vector<double>& ts, const unsigned p)
+	noexcept
+	{
+		const auto r = (p * ts.size() + 99) / 100;
+		return ts[std::max(r, size_t{1}) - 1];
+	}
+
+	void report(
+		const char* name, const size_t n,
+		const double min, const double p10, const double med,
+		const double p90, const double bytes_per_ns,
+		const double flops_per_ns
+	)
+	{
+		// Bytes per nanosecond is the same as GB/s, and likewise for
+		// GFLOP/s.
+		if (m_json) {
+			std::printf("{\"name\": \"%s\", \"n\": %zu, "
+				"\"min_ns\": %.1f, \"p10_ns\": %.1f, "
+				"\"median_ns\": %.1f, \"p90_ns\": %.1f, "
+				"\"gb_per_s\": %.3f, \"gflop_per_s\": %.3f}\n",
+				name, n, min, p10, med, p90, bytes_per_ns,
+				flops_per_ns);
+			return;
+		}
+
+		if (!m_printed_header) {
+			std::printf("%-32s %8s %12s %12s %12s %10s %10s\n",
+				"benchmark", "n", "median (ns)", "p10 (ns)",
+				"p90 (ns)", "GB/s", "GFLOP/s");
+			m_printed_header = true;
+		}
+		std::printf("%-32s %8zu %12.1f %12.1f %12.1f", name, n, med,
+			p10, p90);
+		print_rate(bytes_per_ns);
+		print_rate(flops_per_ns);
+		std::printf("\n");
+	}
+
+	static void print_rate(const double x)
+	{
+		if (x > 0) std::printf(" %10.2f", x);
+		else std::printf(" %10s", "-");
+	}
+};
+
+}}
+
+#endif
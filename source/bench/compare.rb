@@ -0,0 +1,60 @@
+#! /usr/bin/env ruby
+#
+# File Name: compare.rb
+# Author:    Aditya Ramesh
+# Date:      10/17/2026
+# Contact:   _@adityaramesh.com
+#
+# Compares two runs of a benchmark made with `--format json`. For each
+# benchmark present in both runs, the ratio of the median times is printed.
+# Benchmarks whose median time increased by more than the threshold are marked
+# as regressions, and cause the script to exit with a nonzero status, unless
+# the increase is within the spread between the 10th and 90th percentiles of
+# the baseline.
+#
+# Usage: ruby source/bench/compare.rb [--threshold PCT] <baseline> <current>
+
+require 'json'
+require 'optparse'
+
+threshold = 5.0
+
+OptionParser.new do |o|
+	o.banner = 'Usage: compare.rb [options] <baseline> <current>'
+	o.on('--threshold PCT', Float, 'Largest tolerated slowdown (default: 5).') { |v| threshold = v }
+end.parse!
+
+abort 'Expected two result files.' unless ARGV.size == 2
+
+def load_results(path)
+	File.foreach(path).select { |l| l.start_with?('{') }.map do |l|
+		r = JSON.parse(l)
+		[[r['name'], r['n']], r]
+	end.to_h
+end
+
+old = load_results(ARGV[0])
+new = load_results(ARGV[1])
+regressions = 0
+
+printf("%-32s %8s %12s %12s %8s\n", 'benchmark', 'n', 'before (ns)',
+	'after (ns)', 'ratio')
+
+(old.keys & new.keys).each do |key|
+	a, b = old[key], new[key]
+	ratio = b['median_ns'] / a['median_ns']
+	noise = (a['p90_ns'] - a['p10_ns']) / a['median_ns']
+	slow = ratio > 1 + [threshold / 100, noise].max
+	regressions += 1 if slow
+
+	printf("%-32s %8d %12.1f %12.1f %8.3f%s\n", key[0], key[1],
+		a['median_ns'], b['median_ns'], ratio, slow ? '  regression' : '')
+end
+
+(old.keys - new.keys).each { |k| puts "Missing from current run: #{k.join(' ')}." }
+(new.keys - old.keys).each { |k| puts "New in current run: #{k.join(' ')}." }
+
+if regressions > 0
+	puts "#{regressions} regression(s) above #{threshold}%."
+	exit 1
+end
@@ -0,0 +1,89 @@
+/*
+** File Name: array_file_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <cstdio>
+#include <stdexcept>
+#include <ccbase/unit_test.hpp>
+#include <ndmath/io/array_file.hpp>
+#include <ndmath/array/array_literal.hpp>
+
+static const auto path = std::string{"/tmp/ndmath_array_file_test.dat"};
+
+module("test save and load")
+{
+	auto a = nd_darray(float, [1 2 3; 4 5 6]);
+	nd::save_array(path, a);
+
+	auto b = nd::load_array<float, 2>(path);
+	require(b.extents() == nd::extents(2, 3));
+	require(b == a);
+
+	// Lazy expressions are evaluated before they are written.
+	nd::save_array(path, a + a);
+	b = nd::load_array<float, 2>(path);
+	require(b == nd_array(float, [2 4 6; 8 10 12]));
+
+	// Files can also be mapped.
+	auto m = nd::open_mapped<float, 2>(path);
+	require(m == b);
+
+	auto throws = [] (auto f) {
+		try { f(); }
+		catch (const std::runtime_error&) { return true; }
+		return false;
+	};
+	require(throws([] { nd::load_array<int, 2>(path); }));
+	require(throws([] {
+		nd::load_array<float, 2>(path, nd::io_options{},
+			nd::sc_index<1, 0>);
+	}));
+}
+
+module("test booleans")
+{
+	auto a = nd::make_darray<bool>(nd::extents(5, 13));
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 13; ++j) {
+			a(i, j) = (i + j) % 3 == 0;
+		}
+	}
+
+	nd::save_array(path, a);
+	auto b = nd::load_array<bool, 2>(path);
+	require(b == a);
+}
+
+module("test streaming")
+{
+	auto opts = nd::io_options{};
+	opts.chunk_size = 4096;
+	opts.direct = true;
+
+	auto slice = nd::make_darray<double>(nd::extents(40, 50));
+	{
+		auto w = nd::make_array_writer<double>(path,
+			nd::extents(10, 40, 50), opts);
+		for (auto k = 0; k != 10; ++k) {
+			slice = nd::make_darray<double>(k, nd::extents(40, 50));
+			w.write(slice);
+		}
+		require(w.remaining() == 0);
+		w.close();
+	}
+
+	auto r = nd::make_array_reader<double, 3>(path, opts);
+	require(r.extents() == nd::extents(10, 40, 50));
+	for (auto k = 0; k != 10; ++k) {
+		r.read(slice);
+		require(slice(0, 0) == k && slice(39, 49) == k);
+	}
+	require(r.remaining() == 0);
+
+	std::remove(path.c_str());
+}
+
+suite("array file test")
@@ -5,6 +5,9 @@
 ** Contact:   _@adityaramesh.com
 */
 
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <ccbase/unit_test.hpp>
 #include <ndmath/array/dense_storage.hpp>
 #include <ndmath/array/array_literal.hpp>
@@ -71,6 +74,247 @@ module("test accessors")
 	require(arr.size() == 400);
 }
 
+module("test size type")
+{
+	using namespace nd::tokens;
+	using alloc = nd::sized_allocator<std::allocator<float>, unsigned>;
+
+	auto a1 = nd::make_darray<float>(20, 20);
+	auto a2 = nd::make_darray<float>(nd::extents(20, 20), alloc{});
+	auto a3 = nd::make_sarray<float>(20_c, 20_c);
+
+	static_assert(std::is_same<decltype(a1)::size_type, std::size_t>::value, "");
+	static_assert(std::is_same<decltype(a2)::size_type, unsigned>::value, "");
+	static_assert(std::is_same<decltype(a3)::size_type, unsigned>::value, "");
+
+	require(a1.size() == 400);
+	require(a2.size() == 400);
+
+	// The number of elements must not wrap around for large extents.
+	auto e = nd::extents(1u << 17, 1u << 17);
+	require(nd::detail::extents_size<std::size_t>(e) == std::size_t{1} << 34);
+}
+
+module("test alignment")
+{
+	using namespace nd::tokens;
+
+	auto a = nd::make_darray<float>(7, 9);
+	auto p = reinterpret_cast<std::uintptr_t>(a.underlying_view().begin());
+
+	static_assert(decltype(a)::alignment == nd::cache_line_size, "");
+	require(p % nd::cache_line_size == 0);
+
+	auto b = nd::make_sarray<float>(2_c, 2_c);
+	static_assert(decltype(b)::alignment == 4 * sizeof(float), "");
+
+	// Each row of a padded array starts on a cache line.
+	using alloc = nd::aligned_allocator<float, 64, true>;
+	auto c = nd::make_darray<float>(nd::extents(3, 5), alloc{});
+	using array_type = decltype(c);
+
+	static_assert(!array_type::provides_underlying_view, "");
+	static_assert(!array_type::provides_packet_view, "");
+	require(c.memory_size() == 3 * 16 * sizeof(float));
+
+	for (auto i = 0; i != 3; ++i) {
+		for (auto j = 0; j != 5; ++j) {
+			c(i, j) = float(5 * i + j);
+		}
+	}
+
+	require(reinterpret_cast<std::uintptr_t>(&c(1, 0)) % 64 == 0);
+	require(&c(2, 0) - &c(1, 0) == 16);
+
+	auto n = 0.f;
+	for (const auto& x : c.flat_view()) {
+		require(x == n);
+		++n;
+	}
+	require(n == 15);
+}
+
+module("test padded assignment")
+{
+	using alloc1 = nd::aligned_allocator<float, 64, true>;
+	using alloc2 = nd::aligned_allocator<double, 64, true>;
+
+	auto a = nd::make_darray<float>(nd::extents(3, 5));
+	auto b = nd::make_darray<float>(nd::extents(3, 5), alloc1{});
+	auto c = nd::make_darray<double>(nd::extents(3, 5), alloc2{});
+
+	for (auto i = 0; i != 3; ++i) {
+		for (auto j = 0; j != 5; ++j) {
+			a(i, j) = float(5 * i + j);
+		}
+	}
+
+	// Padded arrays have no view in common with other arrays, so the
+	// elements are copied by stepping the offsets of both arrays, whose
+	// rows have different lengths in memory.
+	using traits = nd::detail::offset_walk_traits<
+		decltype(c)::wrapped_type, decltype(b)::wrapped_type>;
+	static_assert(traits::is_feasible, "");
+
+	b = a;
+	c = b;
+	for (auto i = 0; i != 3; ++i) {
+		for (auto j = 0; j != 5; ++j) {
+			require(b(i, j) == a(i, j));
+			require(c(i, j) == a(i, j));
+		}
+	}
+}
+
+module("test arena allocator")
+{
+	using alloc = nd::arena_allocator<float>;
+	auto& a = nd::arena::local();
+	const auto in_use = a.stats().in_use;
+	const auto bytes = 32 * 32 * sizeof(float);
+
+	{
+		nd::arena_scope s;
+		auto x = nd::make_darray<float>(nd::extents(32, 32), alloc{});
+		auto y = nd::make_darray<float>(1, nd::extents(32, 32), alloc{});
+		auto p = reinterpret_cast<std::uintptr_t>(x.underlying_view().begin());
+
+		require(p % nd::cache_line_size == 0);
+		require(a.stats().in_use >= in_use + 2 * bytes);
+
+		x = y;
+		require(x(31, 31) == 1);
+
+		// `y` is the most recent allocation, so it grows in place.
+		auto q = y.underlying_view().begin();
+		y.destructive_resize(nd::extents(64, 64));
+		require(y.underlying_view().begin() == q);
+	}
+
+	require(a.stats().in_use == in_use);
+	require(a.stats().high_water_mark >= in_use + 5 * bytes);
+	require(a.stats().reserved >= a.stats().high_water_mark);
+}
+
+module("test arena alignment")
+{
+	auto aligned = [] (const void* p, const size_t n) {
+		return reinterpret_cast<std::uintptr_t>(p) % n == 0;
+	};
+
+	// The size of the chunks is not a multiple of the alignment, so
+	// aligning the cursor can move it past the end of a chunk.
+	nd::arena a{1000};
+	a.allocate(870, 64);
+	a.allocate(1, 64);
+	require(aligned(a.allocate(1, 64), 64));
+	require(a.stats().chunks == 2);
+
+	// The chunks are only aligned to cache lines unless they are reserved
+	// for a larger alignment. Neither of the existing chunks can hold the
+	// page-aligned array, so a third one is reserved.
+	a.reset();
+	a.allocate(870, 64);
+	using alloc = nd::arena_allocator<float, 4096>;
+	auto x = nd::make_darray<float>(nd::extents(256), alloc{a});
+	require(aligned(x.underlying_view().begin(), 4096));
+	require(a.stats().chunks == 3);
+}
+
+module("test offsets")
+{
+	using namespace nd::tokens;
+
+	auto arr = nd::make_darray<float>({{1, 2, 3}, {4, 5, 6}},
+		nd::extents(2_c, 3_c));
+
+	require(arr(0, 2) == 3);
+	require(arr(1, 0) == 4);
+	require(arr(1, 2) == 6);
+
+	auto n = 1.f;
+	for (const auto& x : arr.flat_view()) {
+		require(x == n);
+		++n;
+	}
+}
+
+module("test offset strides")
+{
+	// Coordinate 1 varies fastest, and each of its rows is padded to a
+	// cache line.
+	using alloc = nd::aligned_allocator<float, 64, true>;
+	auto a = nd::make_darray<float>(nd::extents(3, 4, 5), alloc{},
+		nd::sc_index<2, 0, 1>);
+
+	const auto& s1 = a.wrapped().offset_strides();
+	require(s1[0] == 16 && s1[1] == 1 && s1[2] == 48);
+	require(&a(1, 0, 0) - &a(0, 0, 0) == 16);
+	require(&a(0, 0, 1) - &a(0, 0, 0) == 48);
+	require(&a(2, 3, 4) - &a(0, 0, 0) == 2 * 16 + 3 + 4 * 48);
+
+	auto n = 0;
+	auto prev = std::ptrdiff_t{-1};
+	nd::for_each_offset(a.wrapped(), [&] (const auto& i, const auto off) {
+		require(&a(i) - &a(0, 0, 0) == std::ptrdiff_t(off));
+		require(std::ptrdiff_t(off) > prev);
+		prev = std::ptrdiff_t(off);
+		++n;
+	});
+	require(n == 60);
+
+	// The strides must be updated when the extents change.
+	a.destructive_resize(nd::extents(2, 8, 3));
+	const auto& s2 = a.wrapped().offset_strides();
+	require(s2[0] == 16 && s2[1] == 1 && s2[2] == 32);
+	require(&a(1, 7, 2) - &a(0, 0, 0) == 16 + 7 + 2 * 32);
+}
+
+module("test conservative resize")
+{
+	using namespace nd::tokens;
+
+	auto a = nd::make_darray<int>(nd::extents(2, 3));
+	nd::for_each(a.extents(), [&] (const auto& i) {
+		a(i) = 10 * i(nd::sc_coord<0>) + i(nd::sc_coord<1>);
+	});
+
+	// Appending rows does not move the elements, and the capacity grows
+	// geometrically: 6, 12, 24, 48.
+	auto grows = 0;
+	for (auto n = 3; n != 10; ++n) {
+		const auto cap = a.wrapped().capacity();
+		a.conservative_resize(nd::extents(n, 3));
+		require(a.wrapped().capacity() >= size_t(3 * n));
+		grows += a.wrapped().capacity() != cap;
+
+		for (auto j = 0; j != 3; ++j) {
+			a(n - 1, j) = 10 * (n - 1) + j;
+		}
+	}
+	require(grows == 3);
+	require(a(1, 2) == 12);
+	require(a(8, 1) == 81);
+
+	// Changing the length of the rows relocates the elements.
+	a.conservative_resize(nd::extents(4, 5));
+	require(a.extents() == nd::extents(4, 5));
+	require(a(0, 2) == 2 && a(1, 1) == 11 && a(3, 2) == 32);
+
+	auto b = nd_darray([t f; f t]);
+	b.conservative_resize(nd::extents(3, 3));
+	require(b == nd_array([t f f; f t f; f f f]));
+
+	// The bits past the end of the array stay clear.
+	b.conservative_resize(nd::extents(2, 1));
+	require(b(0, 0) && !b(1, 0));
+	require(b.underlying_view().begin()[0].value() == 1);
+
+	auto c = nd::make_darray<float>(1, nd::extents(4, 4));
+	c.unsafe_resize(nd::extents(8, 4));
+	require(c(3, 3) == 1);
+}
+
 module("test regular indexing")
 {
 	using namespace nd::tokens;
@@ -88,10 +332,40 @@ module("test bool indexing")
 	auto arr = nd_darray([t f; f t]);
 	require(arr == nd_array([t f; f t]));
 
-	require(arr.memory_size() == sizeof(unsigned));
+	require(arr.memory_size() == sizeof(nd::underlying_type<bool>));
 	require(arr == nd_array([t f; f t]));
 }
 
+module("test bool tail bits")
+{
+	using word = nd::underlying_type<bool>::storage_type;
+	constexpr auto bits  = sizeof(word) * CHAR_BIT;
+	constexpr auto words = (77 + bits - 1) / bits;
+	constexpr auto tail  = 77 - (words - 1) * bits;
+	const auto full  = word(~word{0});
+	const auto last  = tail == bits ? full : word((word{1} << tail) - 1);
+
+	// The bits of the last word past the end of the array stay clear.
+	auto a = nd::make_darray<bool>(true, nd::extents(7, 11));
+	auto v = a.underlying_view();
+	require(size_t(v.end() - v.begin()) == words);
+	for (auto i = size_t{0}; i != words - 1; ++i) {
+		require(v.begin()[i].value() == full);
+	}
+	require(v.begin()[words - 1].value() == last);
+
+	auto b = nd::make_darray<bool>(nd::extents(7, 11));
+	b = nd::fast_not(b);
+	require(b == a);
+	require(b.underlying_view().begin()[words - 1].value() == last);
+
+	// The lazy expression sets the tail bits, which must be ignored.
+	auto c = nd::make_darray<bool>(false, nd::extents(7, 11));
+	require(nd::fast_not(a) <nd::fast_eq> c);
+	c(6, 10) = true;
+	require(!(nd::fast_not(a) <nd::fast_eq> c));
+}
+
 module("test copy assignment dynamic dynamic")
 {
 	using namespace nd::tokens;
@@ -151,6 +425,34 @@ module("test move assignment dynamic dynamic")
 	require(d == nd_array([t f; f t]));
 }
 
+module("test move assignment mixed allocators")
+{
+	using alloc = nd::arena_allocator<float>;
+	nd::arena a1, a2;
+
+	// The buffer is taken along with the arena from which it was
+	// allocated.
+	auto x = nd::make_darray<float>(1, nd::extents(4, 4), alloc{a1});
+	auto y = nd::make_darray<float>(2, nd::extents(4, 4), alloc{a2});
+	const auto p = x.underlying_view().begin();
+
+	y = std::move(x);
+	require(y.underlying_view().begin() == p);
+	require(&y.allocator().source() == &a1);
+	require(y(3, 3) == 1);
+
+	// The default allocator cannot free memory obtained from an arena, so
+	// the elements are moved instead.
+	auto z = nd::make_darray<float>(nd::extents(4, 4));
+	z = std::move(y);
+	require(z.underlying_view().begin() != p);
+	require(z(3, 3) == 1);
+
+	auto w = nd::make_darray<float>(3, nd::extents(4, 4), alloc{a2});
+	decltype(z) v = std::move(w);
+	require(v(3, 3) == 3);
+}
+
 module("test copy construction dynamic dynamic")
 {
 	using namespace nd::tokens;
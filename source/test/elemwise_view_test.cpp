@@ -169,6 +169,10 @@ module("test binary ops")
 
 	require((x2() <nd::fast_and> x2()) == nd_array([t f; f t]));
 	require((x2() <nd::fast_and> y2()) == nd_array([f f; f f]));
+	require((x2() <nd::fast_xor> y2()) == nd_array([t t; t t]));
+	require((x2() <nd::fast_andnot> y2()) == nd_array([t f; f t]));
+	require(nd::where(x2(), x2(), y2()) == nd_array([t f; f t]));
+	require(nd::where(x2(), y1(), y1() + y1()) == nd_array(float, [2 0; 0 4]));
 
 	using v1 = nd::detail::move_assignment_traits<
 		decltype(x2() <nd::fast_eq> x2()), decltype(x2)>;
@@ -177,6 +181,170 @@ module("test binary ops")
 
 	static_assert(v1::can_use_underlying_view, "");
 	static_assert(v2::can_use_underlying_view, "");
+
+	using w1 = nd::detail::move_assignment_traits<
+		decltype(x2() <nd::fast_xor> y2()), decltype(x2)>;
+	using w2 = nd::detail::move_assignment_traits<
+		decltype(nd::where(x2(), x2(), y2())), decltype(x2)>;
+	using w3 = nd::detail::move_assignment_traits<
+		decltype(nd::where(x2(), y1(), y1())), decltype(y1)>;
+
+	static_assert(w1::can_use_underlying_view, "");
+	static_assert(w2::can_use_underlying_view, "");
+	static_assert(!w3::can_use_underlying_view, "");
+	static_assert(w3::can_use_flat_view, "");
+}
+
+module("test fused assignment")
+{
+	auto a = nd::make_darray<float>(nd::extents(5, 7));
+	auto b = nd::make_darray<float>(nd::extents(5, 7));
+	auto c = nd::make_darray<float>(nd::extents(5, 7));
+	auto d = nd::make_darray<float>(nd::extents(5, 7));
+
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 7; ++j) {
+			a(i, j) = float(7 * i + j);
+			b(i, j) = float(i - j);
+			c(i, j) = 2;
+		}
+	}
+
+	// User-supplied functions are not evaluated using packets, so this
+	// expression is evaluated using the fused views of the leaves.
+	auto fma = [] (auto x, auto y, auto z) noexcept { return x * y + z; };
+	auto e = nd::zip_with(fma, a, b, c);
+
+	using t1 = nd::detail::copy_assignment_traits<decltype(e), decltype(d)>;
+	static_assert(!t1::can_use_packet_view, "");
+	static_assert(t1::can_use_fused_view, "");
+
+	d = e;
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 7; ++j) {
+			require(d(i, j) == a(i, j) * b(i, j) + 2);
+		}
+	}
+
+	// Nested expressions are flattened into a single loop.
+	auto f = nd::make_darray<int>(nd::extents(5, 7));
+	f = nd::cast<int>(a - b * c) - nd::cast<int>(c);
+
+	using t2 = nd::detail::copy_assignment_traits<
+		decltype(nd::cast<int>(a - b * c) - nd::cast<int>(c)), decltype(f)>;
+	static_assert(t2::can_use_fused_view, "");
+
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 7; ++j) {
+			require(f(i, j) == int(a(i, j) - 2 * b(i, j)) - 2);
+		}
+	}
+
+	// Boolean arrays are bit-packed, so they do not have fused views.
+	auto g = nd::make_darray<bool>(nd::extents(5, 7));
+	using t3 = nd::detail::copy_assignment_traits<decltype(a() < b()), decltype(g)>;
+	static_assert(!t3::can_use_fused_view, "");
+}
+
+module("test broadcasting")
+{
+	auto a = nd::make_darray<int>(nd::extents(3, 4));
+	auto b = nd::make_darray<int>(nd::extents(4));
+	auto c = nd::make_darray<int>(nd::extents(3, 4));
+
+	for (auto i = 0; i != 3; ++i) {
+		for (auto j = 0; j != 4; ++j) { a(i, j) = 10 * i + j; }
+	}
+	for (auto j = 0; j != 4; ++j) { b(j) = 100 * j; }
+
+	// The missing leading dimension of `b` is stretched.
+	c = a + b;
+	require(c.extents() == a.extents());
+	for (auto i = 0; i != 3; ++i) {
+		for (auto j = 0; j != 4; ++j) {
+			require(c(i, j) == 10 * i + 101 * j);
+		}
+	}
+
+	// Dimensions of length one that are known at compile time are
+	// stretched, so a column and a row produce their outer sum.
+	auto x = nd_array(int, [[1] [2] [3]]);
+	auto y = nd_array(int, [[10 20 30 40]]);
+	auto z = nd::make_darray<int>(nd::extents(3, 4));
+	z = x + y;
+	for (auto i = 0; i != 3; ++i) {
+		for (auto j = 0; j != 4; ++j) {
+			require(z(i, j) == (i + 1) + 10 * (j + 1));
+		}
+	}
+
+	// Broadcast expressions are evaluated one index at a time, whereas
+	// operands with matching extents keep their fast views.
+	using t1 = nd::detail::copy_assignment_traits<decltype(a + b), decltype(c)>;
+	using t2 = nd::detail::copy_assignment_traits<decltype(a + a), decltype(c)>;
+	static_assert(!t1::can_use_fused_view, "");
+	static_assert(t2::can_use_fused_view, "");
+}
+
+module("test scalar operands")
+{
+	auto a = nd::make_darray<float>(nd::extents(5, 7));
+	auto b = nd::make_darray<float>(nd::extents(5, 7));
+	auto c = nd::make_darray<int>(nd::extents(5, 7));
+
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 7; ++j) {
+			a(i, j) = float(7 * i + j);
+			c(i, j) = 7 * i + j;
+		}
+	}
+
+	b = 2.0f * a + 1.0f;
+	c *= nd::sc_coord<3>;
+	c = c - 1;
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 7; ++j) {
+			require(b(i, j) == float(14 * i + 2 * j + 1));
+			require(c(i, j) == 3 * (7 * i + j) - 1);
+		}
+	}
+
+	a /= 2;
+	require(a(4, 6) == 17.0f);
+
+	// Coordinates are converted to the element type of the array, so
+	// negative elements are not promoted to unsigned.
+	auto x = nd::make_darray<int>(nd::extents(2, 3));
+	auto y = nd::make_darray<double>(nd::extents(2, 3));
+	auto z = nd::make_darray<int>(nd::extents(2, 3));
+	for (auto i = 0; i != 2; ++i) {
+		for (auto j = 0; j != 3; ++j) { x(i, j) = 3 * i + j - 4; }
+	}
+
+	y = x - nd::sc_coord<5>;
+	z = x / nd::sc_coord<2> + x % nd::sc_coord<3>;
+	for (auto i = 0; i != 2; ++i) {
+		for (auto j = 0; j != 3; ++j) {
+			const auto v = 3 * i + j - 4;
+			require(y(i, j) == double(v - 5));
+			require(z(i, j) == v / 2 + v % 3);
+		}
+	}
+	using t0 = nd::detail::copy_assignment_traits<
+		std::decay_t<decltype(x * nd::sc_coord<2>)>, decltype(z)>;
+	static_assert(t0::can_use_packet_view, "");
+
+	// The scalar is broadcast to a packet, since it does not change the
+	// type of the result.
+	using t1 = nd::detail::copy_assignment_traits<
+		std::decay_t<decltype(2.0f * a + 1.0f)>, decltype(b)>;
+	static_assert(t1::can_use_packet_view, "");
+
+	// The product is promoted to `double`, so packets are not used.
+	using t2 = nd::detail::copy_assignment_traits<
+		std::decay_t<decltype(a * 2.0)>, decltype(b)>;
+	static_assert(!t2::can_use_packet_view, "");
+	static_assert(t2::can_use_fused_view, "");
 }
 
 suite("elemwise view test")
@@ -0,0 +1,60 @@
+/*
+** File Name: fused_assignment_perf_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Compares the assignment of a nested expression to a dense array, evaluated
+** using the fused views of the leaves, against a hand-written loop over raw
+** pointers. The function is a lambda, so that the packet views cannot be used
+** instead. Both loops should compile to the same code.
+*/
+
+#include <chrono>
+#include <ccbase/format.hpp>
+#include <ndmath/array/dense_storage.hpp>
+
+int main()
+{
+	using namespace std::chrono;
+	static constexpr auto n = 256u;
+	static constexpr auto trials = 20u;
+
+	auto a = nd::make_darray<float>(1, nd::extents(n, n, n));
+	auto b = nd::make_darray<float>(2, nd::extents(n, n, n));
+	auto c = nd::make_darray<float>(3, nd::extents(n, n, n));
+	auto d = nd::make_darray<float>(nd::extents(n, n, n));
+
+	auto t1 = high_resolution_clock::time_point{};
+	auto t2 = high_resolution_clock::time_point{};
+	auto f = [] (auto x, auto y) noexcept { return x * y; };
+	auto g = [] (auto x, auto y) noexcept { return x + y; };
+
+	t1 = high_resolution_clock::now();
+	asm("# BEFORE FUSED LOOP");
+	for (auto k = 0u; k != trials; ++k) {
+		auto e = nd::zip_with(f, a, b);
+		d = nd::zip_with(g, e, c);
+	}
+	asm("# AFTER FUSED LOOP");
+	t2 = high_resolution_clock::now();
+	cc::println("fused: $ ms ($)",
+		duration_cast<milliseconds>(t2 - t1).count(), d(0, 0, 0));
+
+	const auto pa = &a(0, 0, 0);
+	const auto pb = &b(0, 0, 0);
+	const auto pc = &c(0, 0, 0);
+	const auto pd = &d(0, 0, 0);
+
+	t1 = high_resolution_clock::now();
+	asm("# BEFORE MANUAL LOOP");
+	for (auto k = 0u; k != trials; ++k) {
+		for (auto i = size_t{0}; i != size_t{n} * n * n; ++i) {
+			pd[i] = pa[i] * pb[i] + pc[i];
+		}
+	}
+	asm("# AFTER MANUAL LOOP");
+	t2 = high_resolution_clock::now();
+	cc::println("manual: $ ms ($)",
+		duration_cast<milliseconds>(t2 - t1).count(), d(0, 0, 0));
+}
@@ -0,0 +1,75 @@
+/*
+** File Name: mapped_storage_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <cstdio>
+#include <stdexcept>
+#include <ccbase/unit_test.hpp>
+#include <ndmath/array/mapped_storage.hpp>
+#include <ndmath/array/array_literal.hpp>
+
+static const auto path = std::string{"/tmp/ndmath_mapped_storage_test.dat"};
+
+module("test create and open")
+{
+	{
+		auto m = nd::create_mapped<float>(path, nd::extents(2, 3));
+		require(m.extents() == nd::extents(2, 3));
+		require(m == nd_array(float, [0 0 0; 0 0 0]));
+
+		m = nd_array(float, [1 2 3; 4 5 6]);
+		m.wrapped().flush();
+	}
+
+	auto m = nd::open_mapped<float, 2>(path);
+	m.wrapped().advise(nd::access_hint::sequential);
+	require(m.extents() == nd::extents(2, 3));
+	require(m == nd_array(float, [1 2 3; 4 5 6]));
+
+	auto d = nd::make_darray<float>(nd::extents(2, 3));
+	d = m + m;
+	require(d == nd_array(float, [2 4 6; 8 10 12]));
+}
+
+module("test modes")
+{
+	{
+		auto m = nd::open_mapped<float, 2>(path, nd::map_mode::copy_on_write);
+		m(0, 0) = 10;
+		require(m(0, 0) == 10);
+	}
+	{
+		auto m = nd::open_mapped<float, 2>(path, nd::map_mode::read_write);
+		require(m(0, 0) == 1);
+		m(1, 2) = 20;
+	}
+
+	auto m = nd::open_mapped<float, 2>(path);
+	require(m == nd_array(float, [1 2 3; 4 5 20]));
+}
+
+module("test header validation")
+{
+	auto throws = [] (auto f) {
+		try { f(); }
+		catch (const std::runtime_error&) { return true; }
+		return false;
+	};
+
+	require(throws([] { nd::open_mapped<double, 2>(path); }));
+	require(throws([] { nd::open_mapped<float, 3>(path); }));
+	require(throws([] {
+		nd::open_mapped<float, 2>(path, nd::map_mode::read_only,
+			nd::sc_index<1, 0>);
+	}));
+	require(throws([] {
+		nd::open_mapped<float, 2>("/tmp/ndmath_nonexistent.dat");
+	}));
+
+	std::remove(path.c_str());
+}
+
+suite("mapped storage test")
@@ -0,0 +1,53 @@
+/*
+** File Name: mask_operations_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <vector>
+#include <ccbase/unit_test.hpp>
+#include <ndmath/array/mask_operations.hpp>
+#include <ndmath/array/array_literal.hpp>
+
+module("test find")
+{
+	// Spans several words of packed booleans, with a partial last word.
+	auto b = nd::make_darray<bool>(false, nd::extents(7, 11));
+	require(nd::find_first(b) == 77);
+
+	b(0, 0) = true;
+	b(3, 4) = true;
+	b(6, 10) = true;
+	require(nd::find_first(b) == 0);
+	require(nd::find_next(b, 0) == 37);
+	require(nd::find_next(b, 37) == 76);
+	require(nd::find_next(b, 76) == 77);
+
+	auto offs = std::vector<size_t>{};
+	nd::for_each_set(b, [&] (auto off) { offs.push_back(off); });
+	require((offs == std::vector<size_t>{0, 37, 76}));
+
+	auto f = nd_darray(float, [0 1 0 2]);
+	require(nd::find_first(f) == 1);
+	require(nd::find_next(f, 1) == 3);
+	require(nd::find_next(f, 3) == 4);
+}
+
+module("test compress and expand")
+{
+	using namespace nd::tokens;
+
+	auto x = nd_darray(float, [1 2 3; 4 5 6]);
+	auto m = nd_array([t f t; f f t]);
+	auto v = std::vector<float>(nd::count(m));
+
+	require(nd::compress(x, m, v.begin()) == v.end());
+	require((v == std::vector<float>{1, 3, 6}));
+
+	for (auto& y : v) { y = -y; }
+	require(nd::expand(v.begin(), m, x) == v.end());
+	require(x == nd_array(float, [-1 2 -3; 4 5 -6]));
+}
+
+suite("mask operations test")
@@ -0,0 +1,79 @@
+/*
+** File Name: npy_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <ccbase/unit_test.hpp>
+#include <ndmath/io/npy.hpp>
+#include <ndmath/array/array_literal.hpp>
+
+static const auto path = std::string{"/tmp/ndmath_npy_test.npy"};
+
+static auto read_file()
+{
+	auto is = std::ifstream{path, std::ios::binary};
+	return std::string{std::istreambuf_iterator<char>{is}, {}};
+}
+
+module("test header")
+{
+	nd::save_npy(path, nd_darray(float, [1 2 3; 4 5 6]));
+
+	// This is the header written by `numpy.save`.
+	const auto s = read_file();
+	const auto dict = std::string{"{'descr': '<f4', 'fortran_order': "
+		"False, 'shape': (2, 3), }"};
+
+	require(s.size() == 128 + 6 * sizeof(float));
+	require(s.compare(0, 6, "\x93NUMPY") == 0);
+	require(s[6] == 1 && s[7] == 0 && s[8] == 118 && s[9] == 0);
+	require(s.compare(10, dict.size(), dict) == 0);
+	require(s[127] == '\n');
+}
+
+module("test round trip")
+{
+	auto a = nd_darray(int, [1 2 3; 4 5 6]);
+	nd::save_npy(path, a);
+	require(nd::load_npy<int, 2>(path) == a);
+
+	// Column-major arrays are written with `fortran_order` set, and can be
+	// read in either storage order.
+	auto alloc = nd::aligned_allocator<int>{};
+	auto col_major = nd::sc_index<1, 0>;
+	auto b = nd::make_darray<int>(nd::extents(2, 3), alloc, col_major);
+	b = a;
+	nd::save_npy(path, b);
+	require(read_file().find("'fortran_order': True") != std::string::npos);
+	require(nd::load_npy<int, 2>(path) == a);
+	require(nd::load_npy<int, 2>(path, nd::io_options{}, col_major) == a);
+
+	// Lazy expressions and views are evaluated first.
+	nd::save_npy(path, nd::transpose(a));
+	require(nd::load_npy<int, 2>(path) == nd_array(int, [1 4; 2 5; 3 6]));
+
+	auto c = nd::make_darray<bool>(false, nd::extents(3, 11));
+	c(0, 0) = true;
+	c(2, 10) = true;
+	nd::save_npy(path, c);
+	require(read_file().size() == 128 + 33);
+	require(nd::load_npy<bool, 2>(path) == c);
+
+	auto throws = [] (auto f) {
+		try { f(); }
+		catch (const std::runtime_error&) { return true; }
+		return false;
+	};
+	require(throws([] { nd::load_npy<float, 2>(path); }));
+	require(throws([] { nd::load_npy<bool, 3>(path); }));
+
+	std::remove(path.c_str());
+}
+
+suite("npy test")
@@ -0,0 +1,120 @@
+/*
+** File Name: packet_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <ccbase/unit_test.hpp>
+#include <ndmath/array/dense_storage.hpp>
+#include <ndmath/array/elemwise_view.hpp>
+
+module("test packet arithmetic")
+{
+	using packet = nd::packet<int>;
+	constexpr auto n = packet::lanes;
+
+	int a[n];
+	int b[n];
+	int c[n];
+
+	for (auto i = 0u; i != n; ++i) {
+		a[i] = int(i);
+		b[i] = int(2 * i + 1);
+		c[i] = -1;
+	}
+
+	auto x = packet::load(a);
+	auto y = packet::load(b);
+	(x * y + packet::broadcast(3)).store(c);
+
+	for (auto i = 0u; i != n; ++i) {
+		require(c[i] == a[i] * b[i] + 3);
+	}
+
+	auto z = nd::detail::bit_xor{}(x, y);
+	for (auto i = 0u; i != n; ++i) {
+		require(z[i] == (a[i] ^ b[i]));
+	}
+}
+
+module("test partial loads and stores")
+{
+	using packet = nd::packet<float>;
+	constexpr auto n = packet::lanes;
+
+	float a[n];
+	float b[n + 1];
+
+	for (auto i = 0u; i != n; ++i) {
+		a[i] = float(i + 1);
+	}
+	for (auto i = 0u; i != n + 1; ++i) {
+		b[i] = -1;
+	}
+
+	for (auto m = size_t{1}; m != n; ++m) {
+		auto x = packet::load_partial(a, m);
+
+		for (auto i = 0u; i != m; ++i) {
+			require(x[i] == a[i]);
+		}
+		for (auto i = m; i != n; ++i) {
+			require(x[i] == a[0]);
+		}
+
+		x.store_partial(b, m);
+		for (auto i = 0u; i != m; ++i) {
+			require(b[i] == a[i]);
+		}
+		require(b[m] == -1);
+	}
+}
+
+module("test packet assignment")
+{
+	using src_type = decltype(nd::make_darray<float>(nd::extents(37)));
+	using dst_type = decltype(nd::make_darray<float>(nd::extents(37)));
+
+	static_assert(src_type::provides_packet_view, "");
+	static_assert(!decltype(nd::make_darray<bool>(nd::extents(37)))
+		::provides_packet_view, "");
+
+	auto a = nd::make_darray<float>(nd::extents(37));
+	auto b = nd::make_darray<float>(nd::extents(37));
+	auto c = nd::make_darray<float>(nd::extents(37));
+	auto d = nd::make_darray<float>(nd::extents(37));
+
+	for (auto i = 0; i != 37; ++i) {
+		a(i) = float(i);
+		b(i) = float(2 * i);
+		c(i) = 1;
+	}
+
+	using traits = nd::detail::copy_assignment_traits<
+		std::decay_t<decltype(a * b + c)>, dst_type>;
+	static_assert(traits::can_use_packet_view, "");
+
+	d = a * b + c;
+	for (auto i = 0; i != 37; ++i) {
+		require(d(i) == a(i) * b(i) + c(i));
+	}
+
+	auto e = nd::make_darray<int>(nd::extents(5, 7));
+	auto f = nd::make_darray<int>(nd::extents(5, 7));
+
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 7; ++j) {
+			e(i, j) = 7 * i + j;
+		}
+	}
+
+	f = e * e - e + (e & e);
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 7; ++j) {
+			require(f(i, j) == e(i, j) * e(i, j));
+		}
+	}
+}
+
+suite("packet test")
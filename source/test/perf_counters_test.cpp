@@ -0,0 +1,55 @@
+/*
+** File Name: perf_counters_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Built both with and without `nd_enable_perf_counters` (see the
+** `perf_counters_check` task in the Rakefile).
+*/
+
+#include <ccbase/unit_test.hpp>
+#include <ndmath/array/dense_storage.hpp>
+#include <ndmath/utility/perf_counters.hpp>
+
+module("test instrument")
+{
+	nd::reset_perf_counters();
+
+	auto a = nd::make_darray<float>(nd::extents(64, 64));
+	auto b = nd::make_darray<float>(nd::extents(64, 64));
+	auto n = 0;
+
+	for (auto k = 0; k != 3; ++k) {
+		nd::instrument("for_each", [&] {
+			nd::for_each(a.extents(), [&] (const auto& i) {
+				a(i) = float(++n);
+			});
+		});
+	}
+
+	// The result of the function is returned by `instrument`.
+	const auto r = nd::instrument("assignment", [&] { b = a; return 1; });
+	{ nd::perf_scope s{"scope"}; (void)s; }
+
+	require(r == 1);
+	require(n == 3 * 64 * 64);
+	require(b(63, 63) == a(63, 63));
+
+	const auto res = nd::perf_results();
+	#ifdef nd_enable_perf_counters
+		require(res.size() == 3);
+		require(res.at("for_each").calls == 3);
+		require(res.at("assignment").calls == 1);
+		require(res.at("scope").calls == 1);
+		require(res.at("for_each").nanoseconds > 0);
+		require(res.at("assignment").nanoseconds > 0);
+
+		nd::reset_perf_counters();
+		require(nd::perf_results().empty());
+	#else
+		require(res.empty());
+	#endif
+}
+
+suite("perf counters test")
@@ -0,0 +1,70 @@
+/*
+** File Name: permuted_view_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <ccbase/unit_test.hpp>
+#include <ndmath/array/dense_storage.hpp>
+#include <ndmath/array/array_literal.hpp>
+
+module("test transpose")
+{
+	auto m = nd_darray(float, [1 2 3; 4 5 6]);
+	auto t = nd::transpose(m);
+
+	require(t.extents() == nd::extents(3, 2));
+	require(t(0, 1) == 4 && t(2, 0) == 3);
+	require(&t(1, 1) == &m(1, 1));
+
+	// Writes go through to the parent.
+	t(2, 1) = 10;
+	require(m(1, 2) == 10);
+
+	auto d = nd::make_darray<float>(nd::extents(3, 2));
+	d = nd::transpose(m);
+	require(d == nd_array(float, [1 4; 2 5; 3 10]));
+}
+
+module("test blocked permutation")
+{
+	auto alloc = nd::aligned_allocator<float>{};
+	auto col_major = nd::sc_index<1, 0>;
+
+	// Sizes that are not multiples of the tile or packet sizes.
+	auto a = nd::make_darray<float>(nd::extents(67, 45));
+	auto b = nd::make_darray<float>(nd::extents(67, 45), alloc, col_major);
+	for (auto i = 0; i != 67; ++i) {
+		for (auto j = 0; j != 45; ++j) {
+			a(i, j) = 100 * i + j;
+		}
+	}
+
+	b = a;
+	require(b == a);
+	require(&b(1, 0) == &b(0, 0) + 1);
+
+	auto c = nd::make_darray<float>(nd::extents(45, 67));
+	c = nd::transpose(b);
+	require(c(44, 66) == 6644 && c(3, 2) == 203);
+
+	auto x = nd::make_darray<int>(nd::extents(5, 6, 7));
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 6; ++j) {
+			for (auto k = 0; k != 7; ++k) {
+				x(i, j, k) = 100 * i + 10 * j + k;
+			}
+		}
+	}
+
+	auto y = nd::make_darray<int>(nd::extents(7, 5, 6));
+	y = nd::permute_axes<2, 0, 1>(x);
+	require(y(6, 4, 5) == 456 && y(1, 2, 3) == 231);
+
+	auto z = nd::make_darray<int>(nd::extents(6, 5, 7));
+	z = nd::permute_axes<1, 0, 2>(x);
+	require(z(5, 4, 6) == 456 && z(1, 2, 3) == 213);
+}
+
+suite("permuted view test")
@@ -0,0 +1,54 @@
+/*
+** File Name: range_iterator_asm.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Compiled to assembly by `rake asm_check`, which compares the code generated
+** for each function against `nested_loops`. The extents are dynamic, and the
+** `asm` statements consume the coordinates, so that the loops are neither
+** vectorized nor removed.
+*/
+
+#include <ndmath/range/range.hpp>
+
+#define nd_asm_use(i, j) asm volatile("" : : "r"(i), "r"(j))
+
+extern "C" {
+
+__attribute__((noinline))
+void nested_loops(const unsigned m, const unsigned n)
+{
+	for (auto i = 0u; i != m; ++i) {
+		for (auto j = 0u; j != n; ++j) {
+			nd_asm_use(i, j);
+		}
+	}
+}
+
+__attribute__((noinline))
+void segment_loops(const unsigned m, const unsigned n)
+{
+	for (const auto& s : nd::segments(nd::extents(m, n))) {
+		for (const auto& i : s) {
+			nd_asm_use(i(nd::sc_coord<0>), i(nd::sc_coord<1>));
+		}
+	}
+}
+
+__attribute__((noinline))
+void range_iterator_loop(const unsigned m, const unsigned n)
+{
+	for (const auto& i : nd::extents(m, n)) {
+		nd_asm_use(i(nd::sc_coord<0>), i(nd::sc_coord<1>));
+	}
+}
+
+}
+
+int main()
+{
+	nested_loops(3, 4);
+	segment_loops(3, 4);
+	range_iterator_loop(3, 4);
+}
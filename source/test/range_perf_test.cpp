@@ -3,45 +3,79 @@
 ** Author:    Aditya Ramesh
 ** Date:      01/10/2015
 ** Contact:   _@adityaramesh.com
+**
+** Compares the ways of iterating over a range against nested for loops: the
+** loop nest evaluated by `range.operator()`, range-for over the range (using
+** `range_iterator`), and range-for over the segments of the range. The bodies
+** contain empty `asm` statements so that the loops are not optimized away.
 */
 
 #include <chrono>
 #include <ccbase/format.hpp>
 #include <ndmath/range/range.hpp>
+#include <ndmath/range/for_each.hpp>
 
-int main()
+template <class Func>
+void time(const char* name, const Func& f)
 {
 	using namespace std::chrono;
 
-	static constexpr auto a = size_t{10000};
-	static constexpr auto b = size_t{1000};
-	static constexpr auto c = size_t{1000};
+	const auto t1 = high_resolution_clock::now();
+	f();
+	const auto t2 = high_resolution_clock::now();
+	cc::println("$: $ ms", name, duration_cast<milliseconds>(t2 - t1).count());
+}
+
+int main()
+{
+	static constexpr auto a = 10000u;
+	static constexpr auto b = 1000u;
+	static constexpr auto c = 1000u;
+	static constexpr auto r = nd::sc_range<a - 1, b - 1, c - 1>;
 
 	auto n = char{};
-	auto t1 = high_resolution_clock::time_point{};
-	auto t2 = high_resolution_clock::time_point{};
-
-	t1 = high_resolution_clock::now();
-	asm("# BEFORE FIRST LOOP");
-	nd::crange<a - 1, b - 1, c - 1>([&] (const auto&) {
-		n = 0;
-		asm("");
+
+	time("range", [&] {
+		asm("# BEFORE RANGE LOOP");
+		r([&] (const auto&) {
+			n = 0;
+			asm("");
+		});
+		asm("# AFTER RANGE LOOP");
 	});
-	asm("# AFTER FIRST LOOP");
-	t2 = high_resolution_clock::now();
-	cc::println(duration_cast<milliseconds>(t2 - t1).count());
-
-	t1 = high_resolution_clock::now();
-	asm("# BEFORE SECOND LOOP");
-	for (auto i = 0u; i != a; ++i) {
-		for (auto j = 0u; j != b; ++j) {
-			for (auto k = 0u; k != c; ++k) {
+
+	time("range_iterator", [&] {
+		asm("# BEFORE ITERATOR LOOP");
+		for (const auto& i : r) {
+			(void)i;
+			n = 0;
+			asm("");
+		}
+		asm("# AFTER ITERATOR LOOP");
+	});
+
+	time("segments", [&] {
+		asm("# BEFORE SEGMENT LOOP");
+		for (const auto& s : nd::segments(r)) {
+			for (const auto& i : s) {
+				(void)i;
 				n = 0;
 				asm("");
 			}
 		}
-	}
-	asm("# AFTER SECOND LOOP");
-	t2 = high_resolution_clock::now();
-	cc::println(duration_cast<milliseconds>(t2 - t1).count());
+		asm("# AFTER SEGMENT LOOP");
+	});
+
+	time("nested", [&] {
+		asm("# BEFORE NESTED LOOP");
+		for (auto i = 0u; i != a; ++i) {
+			for (auto j = 0u; j != b; ++j) {
+				for (auto k = 0u; k != c; ++k) {
+					n = 0;
+					asm("");
+				}
+			}
+		}
+		asm("# AFTER NESTED LOOP");
+	});
 }
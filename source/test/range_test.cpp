@@ -5,8 +5,14 @@
 ** Contact:   _@adityaramesh.com
 */
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <utility>
+#include <vector>
 #include <ccbase/unit_test.hpp>
 #include <ndmath/range/range.hpp>
+#include <ndmath/range/do_while.hpp>
 #include <ndmath/range/loop_optimization.hpp>
 #include <ndmath/range/range_builder.hpp>
 #include <ndmath/common.hpp>
@@ -63,20 +69,204 @@ module("test range for_each")
 	require(j == 50 * 50 * 50);
 }
 
-/*
+module("test parallel for_each")
+{
+	using nd::sc_index;
+	using nd::make_range;
+
+	constexpr auto r1 = make_range(sc_index<63, 63, 63>);
+	auto v = std::vector<std::atomic<int>>(64 * 64 * 64);
+
+	auto visit = [&] (const auto& i) {
+		++v[4096 * i(nd::sc_coord<0>) + 64 * i(nd::sc_coord<1>) + i(nd::sc_coord<2>)];
+	};
+	auto check = [&] (const int n) {
+		for (const auto& x : v) {
+			if (x != n) { return false; }
+		}
+		return true;
+	};
+
+	r1.parallelize<0>()(visit);
+	require(check(1));
+
+	r1.parallelize<0, 3>().tile<0, 2>().unroll<0, nd::contiguous<2>>()(visit);
+	require(check(2));
+
+	r1.reverse<0>().parallelize<0>().parallelize<1>()(visit);
+	require(check(3));
+
+	auto r2 = make_range(nd::c_index(99, 9));
+	auto w = std::vector<std::atomic<int>>(100 * 10);
+	r2.parallelize<0, 1>()([&] (const auto& i) {
+		++w[10 * i(nd::sc_coord<0>) + i(nd::sc_coord<1>)];
+	});
+	for (const auto& x : w) { require(x == 1); }
+}
+
+module("test permuted for_each")
+{
+	using nd::make_range;
+
+	// The index passed to the function is in coordinate order, regardless
+	// of the order in which the loops are evaluated.
+	auto r = make_range(nd::c_index(2, 3));
+	auto v = std::vector<std::pair<int, int>>{};
+	r.permute<1, 0>()([&] (const auto& i) {
+		v.emplace_back(i(nd::sc_coord<0>), i(nd::sc_coord<1>));
+	});
+
+	require(v.size() == 12);
+	require((v[0] == std::make_pair(0, 0)));
+	require((v[1] == std::make_pair(1, 0)));
+	require((v[3] == std::make_pair(0, 1)));
+	require((v[11] == std::make_pair(2, 3)));
+}
+
+module("test blocked for_each")
+{
+	using nd::make_range;
+
+	// The loop nest is evaluated one 4 x 3 block at a time, and the last
+	// block along each coordinate is partial.
+	auto r = make_range(nd::c_index(9, 6));
+	auto v = std::vector<std::pair<int, int>>{};
+	auto visit = [&] (const auto& i) {
+		v.emplace_back(i(nd::sc_coord<0>), i(nd::sc_coord<1>));
+	};
+
+	r.block<0, 4>().block<1, 3>()(visit);
+	require(v.size() == 70);
+	require((v[2] == std::make_pair(0, 2)));
+	require((v[3] == std::make_pair(1, 0)));
+	require((v[12] == std::make_pair(0, 3)));
+	require((v[24] == std::make_pair(0, 6)));
+	require((v[28] == std::make_pair(4, 0)));
+	require((v[69] == std::make_pair(9, 6)));
+
+	// The blocks are traversed in the direction of the loop.
+	v.clear();
+	r.reverse<1>().block<1, 4>()(visit);
+	require(v.size() == 70);
+	require((v[0] == std::make_pair(0, 6)));
+	require((v[3] == std::make_pair(1, 6)));
+	require((v[30] == std::make_pair(0, 3)));
+	require((v[69] == std::make_pair(9, 0)));
+
+	// The other policies are applied within each block.
+	v.clear();
+	r.block<1, 4>().tile<1, 2>()(visit);
+	require(v.size() == 70);
+	require((v[3] == std::make_pair(0, 3)));
+	require((v[4] == std::make_pair(1, 0)));
+	require((v[40] == std::make_pair(0, 4)));
+
+	auto n = 0;
+	nd::do_while(r.block<0, 4>().block<1, 3>(), [&] (const auto&) {
+		return ++n != 20;
+	});
+	require(n == 20);
+
+	constexpr auto s = make_range(nd::sc_index<63, 63>);
+	auto w = std::vector<std::atomic<int>>(64 * 64);
+	s.parallelize<0>().block<0, 16>().block<1, 16>()([&] (const auto& i) {
+		++w[64 * i(nd::sc_coord<0>) + i(nd::sc_coord<1>)];
+	});
+	for (const auto& x : w) { require(x == 1); }
+}
+
+module("test wavefront for_each")
+{
+	using nd::make_range;
+
+	// The points are visited in order of the hyperplanes `2 * i + j`, and
+	// each point is visited exactly once.
+	auto r1 = make_range(nd::c_index(3, 4));
+	auto h = 0;
+	auto visits = std::vector<int>(20, 0);
+	r1.wavefront<0, 2>().wavefront<1>()([&] (const auto& i) {
+		const auto x = int(i(nd::sc_coord<0>));
+		const auto y = int(i(nd::sc_coord<1>));
+		require(x >= 0 && x <= 3 && y >= 0 && y <= 4);
+		require(2 * x + y >= h);
+		h = 2 * x + y;
+		++visits[5 * x + y];
+	});
+	require(std::all_of(visits.begin(), visits.end(),
+		[] (const int c) { return c == 1; }));
+
+	// An in-place update that reads the points before it along each
+	// coordinate. The hyperplanes of blocks are large enough to be
+	// evaluated in parallel.
+	const auto m = 1024;
+	auto v = std::vector<unsigned>(m * m, 1);
+	auto w = v;
+	auto update = [&] (auto& a, const int i, const int j) {
+		if (i == 0 || j == 0) return;
+		a[m * i + j] = (a[m * (i - 1) + j] + 3 * a[m * i + j - 1] + 1) % 1000003;
+	};
+
+	for (auto i = 0; i != m; ++i) {
+		for (auto j = 0; j != m; ++j) { update(v, i, j); }
+	}
+
+	auto r2 = make_range(nd::c_index(m - 1, m - 1));
+	r2.block<0, 64>().block<1, 64>().wavefront<0>().wavefront<1>()(
+		[&] (const auto& i) {
+			update(w, int(i(nd::sc_coord<0>)), int(i(nd::sc_coord<1>)));
+		});
+	require(v == w);
+}
+
 module("test range iterator")
 {
-	using nd::cindex;
+	using nd::sc_index;
 	using nd::make_range;
 
+	constexpr auto r1 = make_range(sc_index<49, 49, 49>);
 	auto j = 0;
-	constexpr auto r1 = make_range(cindex<50, 50, 50>);
 	for (const auto& i : r1) {
-		(void)i;
+		require(int(i(nd::sc_coord<0>)) == j / 2500);
+		require(int(i(nd::sc_coord<2>)) == j % 50);
 		++j;
 	}
 	require(j == 50 * 50 * 50);
+	require(std::distance(r1.begin(), r1.end()) == 50 * 50 * 50);
+
+	// Strides, reversed loops, and permuted loops.
+	auto r2 = make_range(nd::c_index(1, 0), nd::c_index(7, 4), nd::c_index(2, 2));
+	auto v1 = std::vector<std::pair<int, int>>{};
+	auto v2 = std::vector<std::pair<int, int>>{};
+	auto r3 = r2.reverse<0>().permute<1, 0>();
+
+	r3([&] (const auto& i) {
+		v1.emplace_back(i(nd::sc_coord<0>), i(nd::sc_coord<1>));
+	});
+	for (const auto& i : r3) {
+		v2.emplace_back(i(nd::sc_coord<0>), i(nd::sc_coord<1>));
+	}
+	require(v1.size() == 12);
+	require(v1 == v2);
+
+	// Bidirectional traversal.
+	auto it = r3.end();
+	for (auto k = v2.size(); k-- != 0;) {
+		--it;
+		require((std::make_pair(int((*it)(nd::sc_coord<0>)),
+			int((*it)(nd::sc_coord<1>))) == v2[k]));
+	}
+	require(it == r3.begin());
+
+	// Segments.
+	auto v3 = std::vector<std::pair<int, int>>{};
+	require(nd::segments(r3).size() == 3);
+	for (const auto& s : nd::segments(r3)) {
+		require(s.size() == 4);
+		for (const auto& i : s) {
+			v3.emplace_back(i(nd::sc_coord<0>), i(nd::sc_coord<1>));
+		}
+	}
+	require(v2 == v3);
 }
-*/
 
 suite("range test")
@@ -0,0 +1,85 @@
+/*
+** File Name: reduction_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <ccbase/unit_test.hpp>
+#include <ndmath/array/reduction.hpp>
+#include <ndmath/array/array_literal.hpp>
+
+module("test full reductions")
+{
+	auto m = nd_darray(float, [1 2 3; 4 5 6; 7 8 9]);
+
+	require(nd::sum(m) == 45);
+	require(nd::prod(m) == 362880);
+	require(nd::min(m) == 1);
+	require(nd::max(m) == 9);
+	require(nd::reduce(m, 0, [] (auto a, auto b) { return a + b; }) == 45);
+
+	require(nd::sum(m, nd::pairwise_summation) == 45);
+	require(nd::sum(m, nd::kahan_summation) == 45);
+	require(nd::sum(m, nd::parallel<>{}) == 45);
+
+	// Large enough to exercise the packet tail and the parallel path.
+	auto a = nd::make_darray<int>(nd::extents(1001, 37));
+	auto n = 0;
+	for (auto& x : a.flat_view()) { x = n++ % 11 - 5; }
+
+	auto s = 0;
+	for (const auto& x : a.flat_view()) { s += x; }
+	require(nd::sum(a) == s);
+	require(nd::sum(a, nd::parallel<256>{}) == s);
+	require(nd::min(a, nd::parallel<>{}) == -5);
+	require(nd::max(a) == 5);
+}
+
+module("test argmin and argmax")
+{
+	auto m = nd_darray(float, [3 1 4; 1 5 9; 2 6 5]);
+	require(nd::argmin(m) == nd::index(0, 1));
+	require(nd::argmax(m) == nd::index(1, 2));
+}
+
+module("test logical reductions")
+{
+	// Spans several words of packed booleans, with a partial last word.
+	auto b = nd::make_darray<bool>(false, nd::extents(7, 11));
+	require(!nd::any(b) && !nd::all(b) && nd::count(b) == 0);
+
+	b(3, 4) = true;
+	b(6, 10) = true;
+	require(nd::any(b) && !nd::all(b) && nd::count(b) == 2);
+
+	for (auto&& x : b.flat_view()) { x = true; }
+	require(nd::all(b) && nd::count(b) == 77);
+
+	auto f = nd_darray(float, [0 1 0 2]);
+	require(nd::any(f) && !nd::all(f) && nd::count(f) == 2);
+}
+
+module("test axis reductions")
+{
+	auto m = nd_darray(float, [1 2 3; 4 5 6; 7 8 9]);
+
+	require(nd::sum(m, 0) == nd_array(float, [12 15 18]));
+	require(nd::sum(m, 1) == nd_array(float, [6 15 24]));
+	require(nd::max(m, 1) == nd_array(float, [3 6 9]));
+	require(nd::min(m, 0) == nd_array(float, [1 2 3]));
+	require(nd::prod(m, 1) == nd_array(float, [6 120 504]));
+	require(nd::reduce(m, 0, [] (auto a, auto b) { return a + b; }, 0) ==
+		nd_array(float, [12 15 18]));
+
+	auto p = nd_darray(float, [3 1 4; 1 5 9; 2 6 5]);
+	require(nd::argmax(p, 0) == nd_array(int, [0 2 1]));
+	require(nd::argmin(p, 1) == nd_array(int, [1 0 0]));
+
+	auto b = nd::make_darray<bool>(false, nd::extents(2, 40));
+	b(1, 39) = true;
+	require(nd::any(b, 1) == nd_array([f t]));
+	require(!nd::all(b, 0)(39) && nd::any(b, 0)(39));
+}
+
+suite("reduction test")
@@ -0,0 +1,58 @@
+/*
+** File Name: size_type_perf_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Compares the cost of using 64-bit and 32-bit size types for dynamic arrays.
+** The first loop computes an offset from the coordinates for each element; the
+** second iterates over the flat view.
+*/
+
+#include <chrono>
+#include <ccbase/format.hpp>
+#include <ndmath/array/dense_storage.hpp>
+
+template <class Array>
+void run(const char* name, Array& arr)
+{
+	using namespace std::chrono;
+
+	auto sum = float{0};
+	auto t1 = high_resolution_clock::time_point{};
+	auto t2 = high_resolution_clock::time_point{};
+
+	t1 = high_resolution_clock::now();
+	asm("# BEFORE INDEXED LOOP");
+	arr.extents()([&] (const auto& i) CC_ALWAYS_INLINE {
+		sum += nd::expand_index([&] (auto... ts) CC_ALWAYS_INLINE {
+			return arr(ts...);
+		}, i);
+	});
+	asm("# AFTER INDEXED LOOP");
+	t2 = high_resolution_clock::now();
+	cc::println("$, indexed: $ ms ($)", name,
+		duration_cast<milliseconds>(t2 - t1).count(), sum);
+
+	t1 = high_resolution_clock::now();
+	asm("# BEFORE FLAT LOOP");
+	for (const auto& x : arr.flat_view()) {
+		sum += x;
+	}
+	asm("# AFTER FLAT LOOP");
+	t2 = high_resolution_clock::now();
+	cc::println("$, flat: $ ms ($)", name,
+		duration_cast<milliseconds>(t2 - t1).count(), sum);
+}
+
+int main()
+{
+	static constexpr auto n = 400u;
+
+	using alloc = nd::sized_allocator<std::allocator<float>, unsigned>;
+	auto a = nd::make_darray<float>(1, nd::extents(n, n, n));
+	auto b = nd::make_darray<float>(1, nd::extents(n, n, n), alloc{});
+
+	run("64-bit", a);
+	run("32-bit", b);
+}
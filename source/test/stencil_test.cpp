@@ -0,0 +1,100 @@
+/*
+** File Name: stencil_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <ccbase/unit_test.hpp>
+#include <ndmath/array/stencil.hpp>
+
+module("test stencil boundaries")
+{
+	const auto m = 6, n = 7;
+	auto src = nd::make_darray<int>(nd::extents(m, n));
+	auto dst = nd::make_darray<int>(nd::extents(m, n));
+	for (auto i = 0; i != m; ++i) {
+		for (auto j = 0; j != n; ++j) { src(i, j) = 10 * i + j; }
+	}
+
+	// A five-point stencil, with an extra neighbour two columns away.
+	constexpr auto s = nd::make_stencil(
+		nd::sc_offset<-1, 0>, nd::sc_offset<0, -1>, nd::sc_offset<0, 0>,
+		nd::sc_offset<0, 1>, nd::sc_offset<1, 0>, nd::sc_offset<0, 2>);
+	auto f = [] (int a, int b, int c, int d, int e, int g) {
+		return a + 2 * b + 3 * c + 5 * d + 7 * e + 11 * g;
+	};
+
+	auto check = [&] (const auto& resolve) {
+		auto at = [&] (const int i, const int j) {
+			const auto x = resolve(i, m), y = resolve(j, n);
+			return x < 0 || y < 0 ? -1 : src(x, y);
+		};
+		for (auto i = 0; i != m; ++i) {
+			for (auto j = 0; j != n; ++j) {
+				if (dst(i, j) != f(at(i - 1, j), at(i, j - 1), at(i, j),
+					at(i, j + 1), at(i + 1, j), at(i, j + 2))) {
+					return false;
+				}
+			}
+		}
+		return true;
+	};
+
+	// The interior is evaluated one row at a time using the linear
+	// distances to the neighbours.
+	using src_type = decltype(src)::wrapped_type;
+	using dst_type = decltype(dst)::wrapped_type;
+	static_assert(nd::detail::provides_direct_access<src_type>::value, "");
+	static_assert(nd::detail::provides_direct_access<dst_type>::value, "");
+	static_assert(nd::detail::provides_direct_access<decltype(
+		nd::make_darray<float>(nd::extents(2, 2)))::wrapped_type>::value, "");
+
+	nd::apply_stencil(dst, src, s, nd::clamp_boundary, f);
+	require(check([] (int c, int k) { return c < 0 ? 0 : c >= k ? k - 1 : c; }));
+
+	nd::apply_stencil(dst, src, s, nd::wrap_boundary, f);
+	require(check([] (int c, int k) { return (c + k) % k; }));
+
+	nd::apply_stencil(dst, src, s, nd::reflect_boundary, f);
+	require(check([] (int c, int k) { return c < 0 ? -c : c >= k ? 2 * k - 2 - c : c; }));
+
+	nd::apply_stencil(dst, src, s, nd::constant_boundary(-1), f);
+	require(check([] (int c, int k) { return c < 0 || c >= k ? -1 : c; }));
+
+	// The interior is empty when the stencil is wider than the array.
+	auto a = nd::make_darray<int>(nd::extents(3));
+	auto b = nd::make_darray<int>(nd::extents(3));
+	a(0) = 1; a(1) = 2; a(2) = 3;
+	nd::apply_stencil(b, a, nd::make_stencil(nd::sc_offset<-2>,
+		nd::sc_offset<2>), nd::constant_boundary(0),
+		[] (int x, int y) { return x + y; });
+	require(b(0) == 3 && b(1) == 0 && b(2) == 1);
+}
+
+module("test stencil without direct access")
+{
+	// Counts the neighbours of each cell in a grid of packed booleans.
+	auto src = nd::make_darray<bool>(false, nd::extents(5, 5));
+	auto dst = nd::make_darray<int>(nd::extents(5, 5));
+	static_assert(!nd::detail::provides_direct_access<
+		decltype(src)::wrapped_type>::value, "");
+	src(1, 2) = src(2, 2) = src(3, 2) = true;
+
+	constexpr auto s = nd::make_stencil(
+		nd::sc_offset<-1, -1>, nd::sc_offset<-1, 0>, nd::sc_offset<-1, 1>,
+		nd::sc_offset<0, -1>, nd::sc_offset<0, 1>,
+		nd::sc_offset<1, -1>, nd::sc_offset<1, 0>, nd::sc_offset<1, 1>);
+
+	nd::apply_stencil(dst, src, s, nd::constant_boundary(false),
+		[] (auto... xs) {
+			auto r = 0;
+			for (auto x : {bool(xs)...}) { r += x; }
+			return r;
+		});
+
+	require(dst(2, 1) == 3 && dst(2, 3) == 3);
+	require(dst(2, 2) == 2 && dst(0, 2) == 1 && dst(4, 4) == 0);
+}
+
+suite("stencil test")
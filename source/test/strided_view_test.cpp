@@ -0,0 +1,136 @@
+/*
+** File Name: strided_view_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+*/
+
+#include <ccbase/unit_test.hpp>
+#include <ndmath/array/dense_storage.hpp>
+#include <ndmath/array/array_literal.hpp>
+
+module("test column selection")
+{
+	using namespace nd::tokens;
+
+	auto m = nd_darray(float, [1 2 3; 4 5 6; 7 8 9]);
+	auto c = m(_, 0);
+
+	static_assert(decltype(c)::dims() == 1, "");
+	require(c.extents() == nd::extents(3));
+	require(c(0) == 1 && c(1) == 4 && c(2) == 7);
+
+	auto r = m(end, _);
+	require(r(0) == 7 && r(1) == 8 && r(2) == 9);
+
+	// Writes go through to the parent.
+	m(_, 1) = nd_darray(float, [10 11 12]);
+	require(m == nd_array(float, [1 10 3; 4 11 6; 7 12 9]));
+	require(&c(1) == &m(1, 0));
+}
+
+module("test strided selection")
+{
+	using namespace nd::tokens;
+
+	auto m = nd::make_darray<int>(nd::extents(5, 6));
+	for (auto i = 0; i != 5; ++i) {
+		for (auto j = 0; j != 6; ++j) {
+			m(i, j) = 10 * i + j;
+		}
+	}
+
+	// Even rows, and every other column starting from the second one. The
+	// last column selected is 3, since 5 is not in the window.
+	auto v = m(cr<0, 4, 2>, nd::slice(1, end - 1, 2));
+	require(v.extents() == nd::extents(3, 2));
+	require(v.window() == nd::make_range(nd::index(0, 1), nd::index(4, 3),
+		nd::index(2, 2)));
+
+	require(v(0, 0) == 1 && v(0, 1) == 3);
+	require(v(2, 0) == 41 && v(2, 1) == 43);
+
+	auto n = 0;
+	for (const auto& x : v.flat_view()) {
+		require(x == 20 * (n / 2) + 1 + 2 * (n % 2));
+		++n;
+	}
+	require(n == 6);
+
+	// Copying a view to a dense array produces a compact copy.
+	auto d = nd::make_darray<int>(nd::extents(3, 2));
+	d = v;
+	require(d(1, 0) == 21 && d(1, 1) == 23);
+
+	// Views of views.
+	auto w = v(_, 1);
+	require(w(0) == 3 && w(1) == 23 && w(2) == 43);
+}
+
+module("test window selection")
+{
+	using namespace nd::tokens;
+
+	auto a = nd_darray(float, [1 2 3 4 5 6]);
+	const auto& ca = a;
+
+	auto v = ca(nd::slice(1, end - 1));
+	require(v.extents() == nd::extents(4));
+	require(v(0) == 2 && v(3) == 5);
+
+	auto b = nd::make_darray<float>(nd::extents(4));
+	b = v;
+	require(b == nd_array(float, [2 3 4 5]));
+}
+
+module("test segmented flat view")
+{
+	using namespace nd::tokens;
+
+	auto m = nd::make_darray<int>(nd::extents(4, 5, 6));
+	for (auto i = 0; i != 4; ++i) {
+		for (auto j = 0; j != 5; ++j) {
+			for (auto k = 0; k != 6; ++k) {
+				m(i, j, k) = 100 * i + 10 * j + k;
+			}
+		}
+	}
+
+	// The view does not provide a fast flat view, so its flat iterator
+	// updates the coordinates incrementally.
+	auto v = m(nd::slice(1, end), nd::slice(0, end, 2), nd::slice(1, 4));
+	using traits = nd::array_traits<std::decay_t<decltype(v)>>;
+	static_assert(!traits::provides_fast_flat_view, "");
+	require(v.extents() == nd::extents(3, 3, 4));
+
+	auto expect = [] (int n) {
+		return 100 * (n / 12 + 1) + 20 * (n / 4 % 3) + n % 4 + 1;
+	};
+
+	auto n = 0;
+	for (const auto& x : v.flat_view()) {
+		require(x == expect(n));
+		++n;
+	}
+	require(n == 36);
+
+	// Decrementing from the end visits the same elements in reverse.
+	auto it = v.flat_view().end();
+	while (n-- != 0) { require(*--it == expect(n)); }
+	require(it == v.flat_view().begin());
+
+	// Random access recomputes the coordinates.
+	it += 17;
+	require(*it == expect(17) && it[-5] == expect(12));
+	++it;
+	require(*it == expect(18));
+
+	// Copying to a dense array and comparing use the flat view.
+	auto d = nd::make_darray<int>(nd::extents(3, 3, 4));
+	d = v;
+	require(d == v && v == d);
+	d(2, 1, 3) = 0;
+	require(d != v);
+}
+
+suite("strided view test")
@@ -0,0 +1,47 @@
+/*
+** File Name: transpose_perf_test.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Compares the blocked transpose used to assign arrays with different storage
+** orders against the generic loop over the indices of the source, which
+** accesses the destination with a stride of one row per element.
+*/
+
+#include <chrono>
+#include <ccbase/format.hpp>
+#include <ndmath/array/dense_storage.hpp>
+
+int main()
+{
+	using namespace std::chrono;
+	static constexpr auto n = 4096u;
+	static constexpr auto trials = 10u;
+
+	auto a = nd::make_darray<float>(nd::extents(n, n));
+	auto b = nd::make_darray<float>(nd::extents(n, n));
+	auto k = 0u;
+	for (auto& x : a.flat_view()) { x = k++; }
+
+	auto t1 = high_resolution_clock::time_point{};
+	auto t2 = high_resolution_clock::time_point{};
+
+	t1 = high_resolution_clock::now();
+	for (auto i = 0u; i != trials; ++i) {
+		b = nd::transpose(a);
+	}
+	t2 = high_resolution_clock::now();
+	cc::println("blocked: $ ms ($)",
+		duration_cast<milliseconds>(t2 - t1).count(), b(1, 0));
+
+	t1 = high_resolution_clock::now();
+	for (auto i = 0u; i != trials; ++i) {
+		nd::for_each(a.extents(), [&] (const auto& j) CC_ALWAYS_INLINE {
+			b(j(nd::sc_coord<1>), j(nd::sc_coord<0>)) = a(j);
+		});
+	}
+	t2 = high_resolution_clock::now();
+	cc::println("index loop: $ ms ($)",
+		duration_cast<milliseconds>(t2 - t1).count(), b(1, 0));
+}
@@ -0,0 +1,205 @@
+#! /usr/bin/env ruby
+#
+# File Name: autotune.rb
+# Author:    Aditya Ramesh
+# Date:      10/17/2026
+# Contact:   _@adityaramesh.com
+#
+# Chooses loop optimization parameters for the kernels in this directory. For
+# each kernel `<name>.cpp`, the grid of parameters in `<name>.json` is expanded
+# into a set of variants, each of which is compiled with `nd_tune_variant`
+# defined to the corresponding chain of range transformations (see
+# `include/ndmath/range/tuning.hpp`). The variants are timed one at a time, and
+# the fastest is recorded in a database keyed by CPU model and kernel name.
+# Finally, a header containing the chosen parameters for every CPU model in the
+# database is written, to be included by defining `nd_tuned_header`.
+#
+# The grid file may contain the following keys:
+#
+# - `loops`: the loops to unroll, tile, and block, identified by coordinate
+#   (default: `[0]`).
+# - `unroll_policies`: any of `contiguous` and `split` (default: both).
+# - `unroll_factors`: a factor of one disables unrolling (default: `[1, 2, 4,
+#   8]`).
+# - `tile_sizes`: a size of zero disables tiling (default: `[0]`).
+# - `block_sizes`: a size of zero disables blocking (default: `[0]`).
+# - `permutations`: orders in which to evaluate the loops (default: the
+#   identity).
+#
+# Usage: ruby source/tune/autotune.rb [options] <kernel>...
+
+require 'etc'
+require 'fileutils'
+require 'json'
+require 'optparse'
+require 'securerandom'
+require 'shellwords'
+
+opts = {
+	cxx:     ENV['CXX'] || 'c++',
+	flags:   '-std=c++1y -O3 -march=native -I include -pthread',
+	trials:  11,
+	jobs:    Etc.nprocessors,
+	db:      'source/tune/tuning.json',
+	output:  'out/tuned_kernels.hpp',
+	out_dir: 'out/tune'
+}
+
+OptionParser.new do |o|
+	o.banner = 'Usage: autotune.rb [options] <kernel>...'
+	o.on('--cxx CXX', 'Compiler used to build the variants.') { |v| opts[:cxx] = v }
+	o.on('--flags FLAGS', 'Flags used to build the variants.') { |v| opts[:flags] = v }
+	o.on('--trials N', Integer, 'Number of timed runs per variant.') { |v| opts[:trials] = v }
+	o.on('--jobs N', Integer, 'Number of variants compiled at once.') { |v| opts[:jobs] = v }
+	o.on('--db PATH', 'Database of chosen parameters.') { |v| opts[:db] = v }
+	o.on('--output PATH', 'Path of the generated header.') { |v| opts[:output] = v }
+	o.on('--out-dir PATH', 'Directory for the compiled variants.') { |v| opts[:out_dir] = v }
+end.parse!
+
+abort 'No kernels given.' if ARGV.empty?
+
+def cpu_model
+	if File.exist?('/proc/cpuinfo')
+		line = File.foreach('/proc/cpuinfo').find { |l| l.start_with?('model name') }
+		return line.split(':', 2)[1].strip if line
+	end
+	model = `sysctl -n machdep.cpu.brand_string 2>/dev/null`.strip
+	model.empty? ? 'unknown' : model
+end
+
+# Converts the CPU model into a string that can be used in an identifier.
+def cpu_key(model)
+	model.downcase.gsub(/[^a-z0-9]+/, '_').gsub(/^_|_$/, '')
+end
+
+def load_grid(kernel)
+	path = "source/tune/#{kernel}.json"
+	grid = File.exist?(path) ? JSON.parse(File.read(path)) : {}
+	{
+		'loops'           => [0],
+		'unroll_policies' => ['contiguous', 'split'],
+		'unroll_factors'  => [1, 2, 4, 8],
+		'tile_sizes'      => [0],
+		'block_sizes'     => [0],
+		'permutations'    => nil
+	}.merge(grid)
+end
+
+# Unrolling, tiling, and blocking are applied before the permutation, so that
+# the attributes of each loop move with its coordinate.
+def variants(grid)
+	per_loop = grid['unroll_policies'].product(grid['unroll_factors'],
+		grid['tile_sizes'], grid['block_sizes'])
+	choices = grid['loops'].map { |l| per_loop.map { |c| [l] + c } }
+	combos = choices.empty? ? [[]] : choices[0].product(*choices[1..-1])
+	perms = grid['permutations'] || [nil]
+
+	perms.product(combos).map do |perm, combo|
+		s = String.new
+		combo.each do |loop, policy, factor, tile, block|
+			s << ".template unroll<#{loop}, nd::#{policy}<#{factor}>>()" if factor > 1
+			s << ".template tile<#{loop}, #{tile}>()" if tile > 0
+			s << ".template block<#{loop}, #{block}>()" if block > 0
+		end
+		if perm && perm != perm.sort
+			s << ".template permute<#{perm.join(', ')}>()"
+		end
+		s
+	end.uniq
+end
+
+def compile(cxx, flags, src, exe, variant)
+	args = [cxx, *Shellwords.split(flags), "-Dnd_tune_variant=#{variant}",
+		'-o', exe, src]
+	system(*args, out: File::NULL) or abort "Failed to compile #{src} with " \
+		"variant \"#{variant}\"."
+end
+
+def measure(exe, trials)
+	out = `#{Shellwords.escape(exe)} #{trials}`
+	abort "Failed to run #{exe}." unless $?.success?
+	Integer(out.strip)
+end
+
+def write_header(db, current, path)
+	guard = 'Z' + SecureRandom.uuid.upcase.tr('-', '_')
+	cpus = db.keys.sort
+
+	FileUtils.mkdir_p(File.dirname(path))
+	File.open(path, 'w') do |f|
+		f.puts '/*'
+		f.puts "** File Name: #{File.basename(path)}"
+		f.puts '**'
+		f.puts '** Generated by `source/tune/autotune.rb`; do not edit.'
+		f.puts '*/'
+		f.puts
+		f.puts "#ifndef #{guard}"
+		f.puts "#define #{guard}"
+		f.puts
+
+		cpus.each_with_index do |cpu, i|
+			f.puts "// #{db[cpu]['model']}"
+			f.puts "#define nd_cpu_#{cpu} #{i + 1}"
+		end
+
+		f.puts
+		f.puts '#ifndef nd_tuning_target'
+		f.puts "\t#define nd_tuning_target nd_cpu_#{current}"
+		f.puts '#endif'
+
+		cpus.each do |cpu|
+			f.puts
+			f.puts "#if nd_tuning_target == nd_cpu_#{cpu}"
+			db[cpu]['kernels'].sort.each do |name, k|
+				f.puts "\t// #{k['time_ns']} ns (untuned: #{k['baseline_ns']} ns)"
+				f.puts "\tnd_define_tuning(#{name}, #{k['variant']})"
+			end
+			f.puts '#endif'
+		end
+
+		f.puts
+		f.puts '#endif'
+	end
+end
+
+model = cpu_model
+current = cpu_key(model)
+db = File.exist?(opts[:db]) ? JSON.parse(File.read(opts[:db])) : {}
+db[current] ||= { 'model' => model, 'kernels' => {} }
+FileUtils.mkdir_p(opts[:out_dir])
+
+ARGV.each do |kernel|
+	src = "source/tune/#{kernel}.cpp"
+	abort "Kernel \"#{src}\" not found." unless File.exist?(src)
+
+	vs = variants(load_grid(kernel))
+	vs = [''] + (vs - [''])
+	exes = vs.each_index.map { |i| "#{opts[:out_dir]}/#{kernel}_#{i}.run" }
+
+	puts "#{kernel}: compiling #{vs.size} variants."
+	queue = Queue.new
+	vs.each_index { |i| queue << i }
+	workers = Array.new([opts[:jobs], 1].max) do
+		Thread.new do
+			while (i = (queue.pop(true) rescue nil))
+				compile(opts[:cxx], opts[:flags], src, exes[i], vs[i])
+			end
+		end
+	end
+	workers.each(&:join)
+
+	times = exes.map { |e| measure(e, opts[:trials]) }
+	best = times.each_index.min_by { |i| times[i] }
+	puts "#{kernel}: #{times[best]} ns with \"#{vs[best]}\" " \
+		"(untuned: #{times[0]} ns)."
+
+	db[current]['kernels'][kernel] = {
+		'variant'     => vs[best],
+		'time_ns'     => times[best],
+		'baseline_ns' => times[0]
+	}
+end
+
+File.write(opts[:db], JSON.pretty_generate(db) + "\n")
+write_header(db, current, opts[:output])
+puts "Wrote #{opts[:output]}."
@@ -0,0 +1,32 @@
+/*
+** File Name: axpy_2d.cpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Computes `y = a x + y` for two-dimensional arrays, visiting the elements
+** using the loop nest of the extents rather than the flat view.
+*/
+
+#include <ndmath/array/dense_storage.hpp>
+#include "tune_harness.hpp"
+
+nd_declare_kernel(axpy_2d)
+
+int main(int argc, char** argv)
+{
+	static constexpr auto n = 1024u;
+
+	auto x = nd::make_darray<float>(nd::extents(n, n));
+	auto y = nd::make_darray<float>(nd::extents(n, n));
+	auto k = 0u;
+	for (auto& v : x.flat_view()) { v = float(k++ % 7); }
+	for (auto& v : y.flat_view()) { v = 1; }
+
+	const auto r = nd::tune<nd::kernels::axpy_2d>(x.extents());
+	return nd::run_tuned_kernel(argc, argv, [&] {
+		r([&] (const auto& i) CC_ALWAYS_INLINE {
+			y(i) += 2 * x(i);
+		});
+	});
+}
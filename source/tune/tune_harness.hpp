@@ -0,0 +1,55 @@
+/*
+** File Name: tune_harness.hpp
+** Author:    Aditya Ramesh
+** Date:      10/17/2026
+** Contact:   _@adityaramesh.com
+**
+** Used by the kernels in `source/tune` to report their running time to
+** `autotune.rb`. The kernel is run once to warm the caches, and then the given
+** number of trials (by default 11) are timed individually. The median time in
+** nanoseconds is printed as the only line of output.
+*/
+
+#ifndef ZF14CF7EA_22C1_49F9_8F59_22D471C73E77
+#define ZF14CF7EA_22C1_49F9_8F59_22D471C73E77
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <ccbase/format.hpp>
+#include <ndmath/range/tuning.hpp>
+
+namespace nd {
+
+template <class Func>
+int run_tuned_kernel(const int argc, char** argv, const Func& f)
+{
+	using namespace std::chrono;
+
+	const auto trials = argc > 1 ? std::atoi(argv[1]) : 11;
+	if (trials <= 0) {
+		std::fputs("Number of trials must be positive.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	auto ts = std::vector<long long>(size_t(trials));
+	f();
+
+	for (auto& t : ts) {
+		const auto t1 = steady_clock::now();
+		f();
+		const auto t2 = steady_clock::now();
+		t = duration_cast<nanoseconds>(t2 - t1).count();
+	}
+
+	const auto mid = ts.begin() + ts.size() / 2;
+	std::nth_element(ts.begin(), mid, ts.end());
+	cc::println("$", *mid);
+	return EXIT_SUCCESS;
+}
+
+}
+
+#endif